@@ -0,0 +1,222 @@
+/*************************************************************************/
+/*  math_batch.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "math_batch.h"
+
+#ifndef REAL_T_IS_DOUBLE
+#include "core/math/simd.h"
+
+#include <float.h>
+
+// The kernels read and write the math types as packed floats.
+static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 is expected to be 3 packed floats.");
+static_assert(sizeof(AABB) == sizeof(float) * 6, "AABB is expected to be 6 packed floats.");
+static_assert(sizeof(Transform3D) == sizeof(float) * 12, "Transform3D is expected to be 12 packed floats.");
+
+static _FORCE_INLINE_ SIMDFloat4 _basis_column(const Basis &p_basis, int p_column) {
+	float column[4] = { p_basis.rows[0][p_column], p_basis.rows[1][p_column], p_basis.rows[2][p_column], 0.0f };
+	return simd_load4(column);
+}
+#endif
+
+static _FORCE_INLINE_ void _transform_to_3x4(const Transform3D &p_transform, float *r_dst) {
+	for (int i = 0; i < 3; i++) {
+		r_dst[i * 4 + 0] = p_transform.basis.rows[i][0];
+		r_dst[i * 4 + 1] = p_transform.basis.rows[i][1];
+		r_dst[i * 4 + 2] = p_transform.basis.rows[i][2];
+		r_dst[i * 4 + 3] = p_transform.origin[i];
+	}
+}
+
+void MathBatch::xform_points(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *r_dst, uint32_t p_count) {
+	uint32_t i = 0;
+
+#ifndef REAL_T_IS_DOUBLE
+	// Four points at a time, one vector per component.
+	const Basis &basis = p_transform.basis;
+	const SIMDFloat4 m00 = simd_set1(basis.rows[0][0]), m01 = simd_set1(basis.rows[0][1]), m02 = simd_set1(basis.rows[0][2]);
+	const SIMDFloat4 m10 = simd_set1(basis.rows[1][0]), m11 = simd_set1(basis.rows[1][1]), m12 = simd_set1(basis.rows[1][2]);
+	const SIMDFloat4 m20 = simd_set1(basis.rows[2][0]), m21 = simd_set1(basis.rows[2][1]), m22 = simd_set1(basis.rows[2][2]);
+	const SIMDFloat4 ox = simd_set1(p_transform.origin.x), oy = simd_set1(p_transform.origin.y), oz = simd_set1(p_transform.origin.z);
+
+	for (; i + 4 <= p_count; i += 4) {
+		SIMDFloat4 x, y, z;
+		simd_load_xyz4((const float *)(p_src + i), x, y, z);
+		SIMDFloat4 rx = simd_add(simd_madd(m02, z, simd_madd(m01, y, simd_mul(m00, x))), ox);
+		SIMDFloat4 ry = simd_add(simd_madd(m12, z, simd_madd(m11, y, simd_mul(m10, x))), oy);
+		SIMDFloat4 rz = simd_add(simd_madd(m22, z, simd_madd(m21, y, simd_mul(m20, x))), oz);
+		simd_store_xyz4((float *)(r_dst + i), rx, ry, rz);
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		r_dst[i] = p_transform.xform(p_src[i]);
+	}
+}
+
+void MathBatch::xform_aabbs(const Transform3D &p_transform, const AABB *p_src, AABB *r_dst, uint32_t p_count) {
+#ifndef REAL_T_IS_DOUBLE
+	// Transforms the center and the half extents, using the absolute basis for the latter.
+	const SIMDFloat4 c0 = _basis_column(p_transform.basis, 0);
+	const SIMDFloat4 c1 = _basis_column(p_transform.basis, 1);
+	const SIMDFloat4 c2 = _basis_column(p_transform.basis, 2);
+	const SIMDFloat4 a0 = simd_abs(c0), a1 = simd_abs(c1), a2 = simd_abs(c2);
+	const SIMDFloat4 origin = simd_load3((const float *)&p_transform.origin);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		const float *src = (const float *)(p_src + i);
+		float hx = src[3] * 0.5f, hy = src[4] * 0.5f, hz = src[5] * 0.5f;
+		SIMDFloat4 center = simd_add(simd_madd(c2, simd_set1(src[2] + hz), simd_madd(c1, simd_set1(src[1] + hy), simd_mul(c0, simd_set1(src[0] + hx)))), origin);
+		SIMDFloat4 extents = simd_madd(a2, simd_set1(hz), simd_madd(a1, simd_set1(hy), simd_mul(a0, simd_set1(hx))));
+
+		float *dst = (float *)(r_dst + i);
+		simd_store3(dst, simd_sub(center, extents));
+		simd_store3(dst + 3, simd_add(extents, extents));
+	}
+#else
+	for (uint32_t i = 0; i < p_count; i++) {
+		r_dst[i] = p_transform.xform(p_src[i]);
+	}
+#endif
+}
+
+void MathBatch::multiply_transforms(const Transform3D &p_parent, const Transform3D *p_src, Transform3D *r_dst, uint32_t p_count) {
+#ifndef REAL_T_IS_DOUBLE
+	// Each row of the result is a combination of the rows of the child basis.
+	const Basis &basis = p_parent.basis;
+	const SIMDFloat4 p00 = simd_set1(basis.rows[0][0]), p01 = simd_set1(basis.rows[0][1]), p02 = simd_set1(basis.rows[0][2]);
+	const SIMDFloat4 p10 = simd_set1(basis.rows[1][0]), p11 = simd_set1(basis.rows[1][1]), p12 = simd_set1(basis.rows[1][2]);
+	const SIMDFloat4 p20 = simd_set1(basis.rows[2][0]), p21 = simd_set1(basis.rows[2][1]), p22 = simd_set1(basis.rows[2][2]);
+	const SIMDFloat4 c0 = _basis_column(basis, 0), c1 = _basis_column(basis, 1), c2 = _basis_column(basis, 2);
+	const SIMDFloat4 origin = simd_load3((const float *)&p_parent.origin);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		const float *src = (const float *)(p_src + i);
+		// The fourth lane of each row is the next float in the transform, and is ignored.
+		SIMDFloat4 r0 = simd_load4(src);
+		SIMDFloat4 r1 = simd_load4(src + 3);
+		SIMDFloat4 r2 = simd_load4(src + 6);
+		SIMDFloat4 o = simd_add(simd_madd(c2, simd_set1(src[11]), simd_madd(c1, simd_set1(src[10]), simd_mul(c0, simd_set1(src[9])))), origin);
+
+		SIMDFloat4 d0 = simd_madd(p02, r2, simd_madd(p01, r1, simd_mul(p00, r0)));
+		SIMDFloat4 d1 = simd_madd(p12, r2, simd_madd(p11, r1, simd_mul(p10, r0)));
+		SIMDFloat4 d2 = simd_madd(p22, r2, simd_madd(p21, r1, simd_mul(p20, r0)));
+
+		// Each store overwrites the first float of the next row, which is stored right after.
+		float *dst = (float *)(r_dst + i);
+		simd_store4(dst, d0);
+		simd_store4(dst + 3, d1);
+		simd_store4(dst + 6, d2);
+		simd_store3(dst + 9, o);
+	}
+#else
+	for (uint32_t i = 0; i < p_count; i++) {
+		r_dst[i] = p_parent * p_src[i];
+	}
+#endif
+}
+
+void MathBatch::multiply_transforms_to_3x4(const Transform3D &p_parent, const Transform3D *p_src, uint32_t p_src_stride, float *r_dst, uint32_t p_dst_stride, uint32_t p_count) {
+	const uint8_t *src_bytes = (const uint8_t *)p_src;
+
+#ifndef REAL_T_IS_DOUBLE
+	// The columns of the result are computed, then transposed along with the origin into 3x4 rows.
+	const SIMDFloat4 c0 = _basis_column(p_parent.basis, 0), c1 = _basis_column(p_parent.basis, 1), c2 = _basis_column(p_parent.basis, 2);
+	const SIMDFloat4 origin = simd_load3((const float *)&p_parent.origin);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		const float *src = (const float *)(src_bytes + uint64_t(i) * p_src_stride);
+		SIMDFloat4 d0 = simd_madd(c2, simd_set1(src[6]), simd_madd(c1, simd_set1(src[3]), simd_mul(c0, simd_set1(src[0]))));
+		SIMDFloat4 d1 = simd_madd(c2, simd_set1(src[7]), simd_madd(c1, simd_set1(src[4]), simd_mul(c0, simd_set1(src[1]))));
+		SIMDFloat4 d2 = simd_madd(c2, simd_set1(src[8]), simd_madd(c1, simd_set1(src[5]), simd_mul(c0, simd_set1(src[2]))));
+		SIMDFloat4 o = simd_add(simd_madd(c2, simd_set1(src[11]), simd_madd(c1, simd_set1(src[10]), simd_mul(c0, simd_set1(src[9])))), origin);
+		simd_transpose(d0, d1, d2, o);
+
+		float *dst = r_dst + uint64_t(i) * p_dst_stride;
+		simd_store4(dst, d0);
+		simd_store4(dst + 4, d1);
+		simd_store4(dst + 8, d2);
+	}
+#else
+	for (uint32_t i = 0; i < p_count; i++) {
+		const Transform3D &src = *(const Transform3D *)(src_bytes + uint64_t(i) * p_src_stride);
+		_transform_to_3x4(p_parent * src, r_dst + uint64_t(i) * p_dst_stride);
+	}
+#endif
+}
+
+AABB MathBatch::xform_aabb_merged_3x4(const AABB &p_aabb, const float *p_transforms, uint32_t p_stride, uint32_t p_count) {
+	if (p_count == 0) {
+		return AABB();
+	}
+
+#ifndef REAL_T_IS_DOUBLE
+	Vector3 half = p_aabb.size * 0.5f;
+	Vector3 center = p_aabb.position + half;
+	const SIMDFloat4 cx = simd_set1(center.x), cy = simd_set1(center.y), cz = simd_set1(center.z);
+	const SIMDFloat4 hx = simd_set1(half.x), hy = simd_set1(half.y), hz = simd_set1(half.z);
+	const SIMDFloat4 zero = simd_set1(0.0f);
+	SIMDFloat4 min = simd_set1(FLT_MAX);
+	SIMDFloat4 max = simd_set1(-FLT_MAX);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		// Transposing the 3x4 rows gives the basis columns, then the origin.
+		const float *m = p_transforms + uint64_t(i) * p_stride;
+		SIMDFloat4 m0 = simd_load4(m);
+		SIMDFloat4 m1 = simd_load4(m + 4);
+		SIMDFloat4 m2 = simd_load4(m + 8);
+		SIMDFloat4 o = zero;
+		simd_transpose(m0, m1, m2, o);
+
+		SIMDFloat4 c = simd_add(simd_madd(m2, cz, simd_madd(m1, cy, simd_mul(m0, cx))), o);
+		SIMDFloat4 e = simd_madd(simd_abs(m2), hz, simd_madd(simd_abs(m1), hy, simd_mul(simd_abs(m0), hx)));
+		min = simd_min(min, simd_sub(c, e));
+		max = simd_max(max, simd_add(c, e));
+	}
+
+	float mn[4];
+	float mx[4];
+	simd_store4(mn, min);
+	simd_store4(mx, max);
+	return AABB(Vector3(mn[0], mn[1], mn[2]), Vector3(mx[0] - mn[0], mx[1] - mn[1], mx[2] - mn[2]));
+#else
+	AABB aabb;
+	for (uint32_t i = 0; i < p_count; i++) {
+		const float *m = p_transforms + uint64_t(i) * p_stride;
+		Transform3D t(m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10], m[3], m[7], m[11]);
+		if (i == 0) {
+			aabb = t.xform(p_aabb);
+		} else {
+			aabb.merge_with(t.xform(p_aabb));
+		}
+	}
+	return aabb;
+#endif
+}
@@ -0,0 +1,60 @@
+/*************************************************************************/
+/*  math_batch.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef MATH_BATCH_H
+#define MATH_BATCH_H
+
+#include "core/math/aabb.h"
+#include "core/math/transform_3d.h"
+#include "core/math/vector3.h"
+
+// Math operations on arrays, for loops that transform many values with
+// the same transform. They use SIMD where available (see simd.h), and give
+// the same results as the scalar operations up to float rounding.
+// Source and destination arrays may be the same.
+class MathBatch {
+public:
+	// r_dst[i] = p_transform.xform(p_src[i]).
+	static void xform_points(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *r_dst, uint32_t p_count);
+	// r_dst[i] = p_transform.xform(p_src[i]), for AABBs with a positive size.
+	static void xform_aabbs(const Transform3D &p_transform, const AABB *p_src, AABB *r_dst, uint32_t p_count);
+	// r_dst[i] = p_parent * p_src[i].
+	static void multiply_transforms(const Transform3D &p_parent, const Transform3D *p_src, Transform3D *r_dst, uint32_t p_count);
+
+	// The following work with the 3x4 row-major float matrices used in
+	// MultiMesh buffers: basis row followed by the origin component, per row.
+
+	// Like multiply_transforms(), sources being p_src_stride bytes apart and results written as 3x4 matrices p_dst_stride floats apart.
+	static void multiply_transforms_to_3x4(const Transform3D &p_parent, const Transform3D *p_src, uint32_t p_src_stride, float *r_dst, uint32_t p_dst_stride, uint32_t p_count);
+	// Bounds of p_aabb transformed by each of the 3x4 matrices, p_stride floats apart.
+	static AABB xform_aabb_merged_3x4(const AABB &p_aabb, const float *p_transforms, uint32_t p_stride, uint32_t p_count);
+};
+
+#endif // MATH_BATCH_H
@@ -0,0 +1,219 @@
+/*************************************************************************/
+/*  simd.h                                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "core/math/math_funcs.h"
+#include "core/typedefs.h"
+
+// Minimal 4-wide 32-bit float vector used by the bulk math kernels.
+// SSE2 is part of every x86-64 build and NEON of every ARM64 one, so both
+// are used whenever the compiler targets them, with a scalar fallback
+// everywhere else. Define SIMD_FORCE_SCALAR to test the fallback.
+
+#if !defined(SIMD_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SIMD_SSE2
+#include <emmintrin.h>
+#elif !defined(SIMD_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+struct SIMDFloat4 {
+#if defined(SIMD_SSE2)
+	__m128 v;
+#elif defined(SIMD_NEON)
+	float32x4_t v;
+#else
+	float v[4];
+#endif
+};
+
+#if defined(SIMD_SSE2)
+
+static _ALWAYS_INLINE_ SIMDFloat4 simd_make(__m128 p_v) {
+	SIMDFloat4 r;
+	r.v = p_v;
+	return r;
+}
+
+static _ALWAYS_INLINE_ SIMDFloat4 simd_set1(float p_value) { return simd_make(_mm_set1_ps(p_value)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_load4(const float *p_ptr) { return simd_make(_mm_loadu_ps(p_ptr)); }
+// The fourth lane is zero, nothing past the third float is read.
+static _ALWAYS_INLINE_ SIMDFloat4 simd_load3(const float *p_ptr) { return simd_make(_mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double *)p_ptr)), _mm_load_ss(p_ptr + 2))); }
+static _ALWAYS_INLINE_ void simd_store4(float *p_ptr, const SIMDFloat4 &p_a) { _mm_storeu_ps(p_ptr, p_a.v); }
+static _ALWAYS_INLINE_ void simd_store3(float *p_ptr, const SIMDFloat4 &p_a) {
+	_mm_storel_pi((__m64 *)p_ptr, p_a.v);
+	_mm_store_ss(p_ptr + 2, _mm_movehl_ps(p_a.v, p_a.v));
+}
+static _ALWAYS_INLINE_ SIMDFloat4 simd_add(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(_mm_add_ps(p_a.v, p_b.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_sub(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(_mm_sub_ps(p_a.v, p_b.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_mul(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(_mm_mul_ps(p_a.v, p_b.v)); }
+// p_a * p_b + p_c.
+static _ALWAYS_INLINE_ SIMDFloat4 simd_madd(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b, const SIMDFloat4 &p_c) { return simd_make(_mm_add_ps(_mm_mul_ps(p_a.v, p_b.v), p_c.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_abs(const SIMDFloat4 &p_a) { return simd_make(_mm_andnot_ps(_mm_set1_ps(-0.0f), p_a.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_min(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(_mm_min_ps(p_a.v, p_b.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_max(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(_mm_max_ps(p_a.v, p_b.v)); }
+
+static _ALWAYS_INLINE_ void simd_transpose(SIMDFloat4 &r_a, SIMDFloat4 &r_b, SIMDFloat4 &r_c, SIMDFloat4 &r_d) {
+	_MM_TRANSPOSE4_PS(r_a.v, r_b.v, r_c.v, r_d.v);
+}
+
+// Loads 4 consecutive xyz triplets (12 floats) as one vector per component.
+static _ALWAYS_INLINE_ void simd_load_xyz4(const float *p_ptr, SIMDFloat4 &r_x, SIMDFloat4 &r_y, SIMDFloat4 &r_z) {
+	__m128 a = _mm_loadu_ps(p_ptr); // x0 y0 z0 x1
+	__m128 b = _mm_loadu_ps(p_ptr + 4); // y1 z1 x2 y2
+	__m128 c = _mm_loadu_ps(p_ptr + 8); // z2 x3 y3 z3
+	__m128 t = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+	__m128 u = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+	r_x.v = _mm_shuffle_ps(a, t, _MM_SHUFFLE(2, 0, 3, 0));
+	r_y.v = _mm_shuffle_ps(u, t, _MM_SHUFFLE(3, 1, 2, 0));
+	r_z.v = _mm_shuffle_ps(u, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+// Stores one vector per component as 4 consecutive xyz triplets (12 floats).
+static _ALWAYS_INLINE_ void simd_store_xyz4(float *p_ptr, const SIMDFloat4 &p_x, const SIMDFloat4 &p_y, const SIMDFloat4 &p_z) {
+	__m128 t = _mm_shuffle_ps(p_x.v, p_y.v, _MM_SHUFFLE(2, 0, 2, 0)); // x0 x2 y0 y2
+	__m128 u = _mm_shuffle_ps(p_x.v, p_y.v, _MM_SHUFFLE(3, 1, 3, 1)); // x1 x3 y1 y3
+	__m128 a = _mm_shuffle_ps(t, _mm_shuffle_ps(p_z.v, u, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	__m128 b = _mm_shuffle_ps(_mm_shuffle_ps(u, p_z.v, _MM_SHUFFLE(1, 1, 2, 2)), t, _MM_SHUFFLE(3, 1, 2, 0));
+	__m128 v = _mm_shuffle_ps(u, p_z.v, _MM_SHUFFLE(3, 2, 3, 1)); // x3 y3 z2 z3
+	__m128 c = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 2));
+	_mm_storeu_ps(p_ptr, a);
+	_mm_storeu_ps(p_ptr + 4, b);
+	_mm_storeu_ps(p_ptr + 8, c);
+}
+
+#elif defined(SIMD_NEON)
+
+static _ALWAYS_INLINE_ SIMDFloat4 simd_make(float32x4_t p_v) {
+	SIMDFloat4 r;
+	r.v = p_v;
+	return r;
+}
+
+static _ALWAYS_INLINE_ SIMDFloat4 simd_set1(float p_value) { return simd_make(vdupq_n_f32(p_value)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_load4(const float *p_ptr) { return simd_make(vld1q_f32(p_ptr)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_load3(const float *p_ptr) { return simd_make(vcombine_f32(vld1_f32(p_ptr), vld1_lane_f32(p_ptr + 2, vdup_n_f32(0.0f), 0))); }
+static _ALWAYS_INLINE_ void simd_store4(float *p_ptr, const SIMDFloat4 &p_a) { vst1q_f32(p_ptr, p_a.v); }
+static _ALWAYS_INLINE_ void simd_store3(float *p_ptr, const SIMDFloat4 &p_a) {
+	vst1_f32(p_ptr, vget_low_f32(p_a.v));
+	vst1q_lane_f32(p_ptr + 2, p_a.v, 2);
+}
+static _ALWAYS_INLINE_ SIMDFloat4 simd_add(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(vaddq_f32(p_a.v, p_b.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_sub(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(vsubq_f32(p_a.v, p_b.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_mul(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(vmulq_f32(p_a.v, p_b.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_madd(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b, const SIMDFloat4 &p_c) { return simd_make(vmlaq_f32(p_c.v, p_a.v, p_b.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_abs(const SIMDFloat4 &p_a) { return simd_make(vabsq_f32(p_a.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_min(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(vminq_f32(p_a.v, p_b.v)); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_max(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(vmaxq_f32(p_a.v, p_b.v)); }
+
+static _ALWAYS_INLINE_ void simd_transpose(SIMDFloat4 &r_a, SIMDFloat4 &r_b, SIMDFloat4 &r_c, SIMDFloat4 &r_d) {
+	float32x4x2_t ab = vtrnq_f32(r_a.v, r_b.v); // a0 b0 a2 b2, a1 b1 a3 b3
+	float32x4x2_t cd = vtrnq_f32(r_c.v, r_d.v);
+	r_a.v = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+	r_b.v = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+	r_c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+	r_d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+
+static _ALWAYS_INLINE_ void simd_load_xyz4(const float *p_ptr, SIMDFloat4 &r_x, SIMDFloat4 &r_y, SIMDFloat4 &r_z) {
+	float32x4x3_t xyz = vld3q_f32(p_ptr);
+	r_x.v = xyz.val[0];
+	r_y.v = xyz.val[1];
+	r_z.v = xyz.val[2];
+}
+
+static _ALWAYS_INLINE_ void simd_store_xyz4(float *p_ptr, const SIMDFloat4 &p_x, const SIMDFloat4 &p_y, const SIMDFloat4 &p_z) {
+	float32x4x3_t xyz;
+	xyz.val[0] = p_x.v;
+	xyz.val[1] = p_y.v;
+	xyz.val[2] = p_z.v;
+	vst3q_f32(p_ptr, xyz);
+}
+
+#else
+
+static _ALWAYS_INLINE_ SIMDFloat4 simd_make(float p_x, float p_y, float p_z, float p_w) {
+	SIMDFloat4 r;
+	r.v[0] = p_x;
+	r.v[1] = p_y;
+	r.v[2] = p_z;
+	r.v[3] = p_w;
+	return r;
+}
+
+static _ALWAYS_INLINE_ SIMDFloat4 simd_set1(float p_value) { return simd_make(p_value, p_value, p_value, p_value); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_load4(const float *p_ptr) { return simd_make(p_ptr[0], p_ptr[1], p_ptr[2], p_ptr[3]); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_load3(const float *p_ptr) { return simd_make(p_ptr[0], p_ptr[1], p_ptr[2], 0.0f); }
+static _ALWAYS_INLINE_ void simd_store4(float *p_ptr, const SIMDFloat4 &p_a) {
+	for (int i = 0; i < 4; i++) {
+		p_ptr[i] = p_a.v[i];
+	}
+}
+static _ALWAYS_INLINE_ void simd_store3(float *p_ptr, const SIMDFloat4 &p_a) {
+	for (int i = 0; i < 3; i++) {
+		p_ptr[i] = p_a.v[i];
+	}
+}
+static _ALWAYS_INLINE_ SIMDFloat4 simd_add(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(p_a.v[0] + p_b.v[0], p_a.v[1] + p_b.v[1], p_a.v[2] + p_b.v[2], p_a.v[3] + p_b.v[3]); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_sub(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(p_a.v[0] - p_b.v[0], p_a.v[1] - p_b.v[1], p_a.v[2] - p_b.v[2], p_a.v[3] - p_b.v[3]); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_mul(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(p_a.v[0] * p_b.v[0], p_a.v[1] * p_b.v[1], p_a.v[2] * p_b.v[2], p_a.v[3] * p_b.v[3]); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_madd(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b, const SIMDFloat4 &p_c) { return simd_add(simd_mul(p_a, p_b), p_c); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_abs(const SIMDFloat4 &p_a) { return simd_make(Math::abs(p_a.v[0]), Math::abs(p_a.v[1]), Math::abs(p_a.v[2]), Math::abs(p_a.v[3])); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_min(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(MIN(p_a.v[0], p_b.v[0]), MIN(p_a.v[1], p_b.v[1]), MIN(p_a.v[2], p_b.v[2]), MIN(p_a.v[3], p_b.v[3])); }
+static _ALWAYS_INLINE_ SIMDFloat4 simd_max(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return simd_make(MAX(p_a.v[0], p_b.v[0]), MAX(p_a.v[1], p_b.v[1]), MAX(p_a.v[2], p_b.v[2]), MAX(p_a.v[3], p_b.v[3])); }
+
+static _ALWAYS_INLINE_ void simd_transpose(SIMDFloat4 &r_a, SIMDFloat4 &r_b, SIMDFloat4 &r_c, SIMDFloat4 &r_d) {
+	SIMDFloat4 a = r_a, b = r_b, c = r_c, d = r_d;
+	r_a = simd_make(a.v[0], b.v[0], c.v[0], d.v[0]);
+	r_b = simd_make(a.v[1], b.v[1], c.v[1], d.v[1]);
+	r_c = simd_make(a.v[2], b.v[2], c.v[2], d.v[2]);
+	r_d = simd_make(a.v[3], b.v[3], c.v[3], d.v[3]);
+}
+
+static _ALWAYS_INLINE_ void simd_load_xyz4(const float *p_ptr, SIMDFloat4 &r_x, SIMDFloat4 &r_y, SIMDFloat4 &r_z) {
+	r_x = simd_make(p_ptr[0], p_ptr[3], p_ptr[6], p_ptr[9]);
+	r_y = simd_make(p_ptr[1], p_ptr[4], p_ptr[7], p_ptr[10]);
+	r_z = simd_make(p_ptr[2], p_ptr[5], p_ptr[8], p_ptr[11]);
+}
+
+static _ALWAYS_INLINE_ void simd_store_xyz4(float *p_ptr, const SIMDFloat4 &p_x, const SIMDFloat4 &p_y, const SIMDFloat4 &p_z) {
+	for (int i = 0; i < 4; i++) {
+		p_ptr[i * 3 + 0] = p_x.v[i];
+		p_ptr[i * 3 + 1] = p_y.v[i];
+		p_ptr[i * 3 + 2] = p_z.v[i];
+	}
+}
+
+#endif
+
+#endif // SIMD_H
@@ -393,6 +393,7 @@ void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherit
 	ERR_FAIL_COND_MSG(classes.has(name), "Class '" + String(p_class) + "' already exists.");
 
 	classes[name] = ClassInfo();
+	lookup_version.increment();
 	ClassInfo &ti = classes[name];
 	ti.name = name;
 	ti.inherits = p_inherits;
@@ -543,6 +544,63 @@ MethodBind *ClassDB::get_method(const StringName &p_class, const StringName &p_n
 	return nullptr;
 }
 
+SafeNumeric<uint32_t> ClassDB::lookup_version;
+
+bool ClassDB::_lookup_cache_get(const ObjectLookupCache &p_cache, const StringName &p_class, const StringName &p_name, MethodBind *&r_method, const PropertySetGet *&r_property) {
+	uint32_t sequence = p_cache.sequence.get();
+	if (sequence & 1) {
+		return false; // Being updated by another thread.
+	}
+
+	bool valid = p_cache.class_key == p_class.data_unique_pointer() && p_cache.name_key == p_name.data_unique_pointer() && p_cache.version == lookup_version.get();
+	r_method = p_cache.method;
+	r_property = (const PropertySetGet *)p_cache.property;
+
+#if !defined(NO_THREADS)
+	std::atomic_thread_fence(std::memory_order_acquire); // Don't let the reads above move past the check below.
+#endif
+	return valid && p_cache.sequence.get() == sequence;
+}
+
+void ClassDB::_lookup_cache_set(ObjectLookupCache &r_cache, uint32_t p_version, const StringName &p_class, const StringName &p_name, MethodBind *p_method, const PropertySetGet *p_property) {
+	uint32_t sequence = r_cache.sequence.get();
+	if ((sequence & 1) || !r_cache.sequence.compare_exchange(sequence, sequence + 1)) {
+		return; // Another thread is updating it, just skip caching this time.
+	}
+
+	if (r_cache.class_key != p_class.data_unique_pointer() || r_cache.name_key != p_name.data_unique_pointer() || r_cache.version != p_version) {
+		r_cache.class_key = p_class.data_unique_pointer();
+		r_cache.name_key = p_name.data_unique_pointer();
+		r_cache.version = p_version;
+		r_cache.method = nullptr;
+		r_cache.property = nullptr;
+	}
+	if (p_method) {
+		r_cache.method = p_method;
+	}
+	if (p_property) {
+		r_cache.property = p_property;
+	}
+
+	r_cache.sequence.set(sequence + 2);
+}
+
+MethodBind *ClassDB::get_method_cached(ObjectLookupCache &r_cache, const StringName &p_class, const StringName &p_name) {
+	MethodBind *method = nullptr;
+	const PropertySetGet *psg = nullptr;
+	if (_lookup_cache_get(r_cache, p_class, p_name, method, psg) && method) {
+		return method;
+	}
+
+	// Read the version before looking up, so a concurrent change leaves the entry stale.
+	uint32_t version = lookup_version.get();
+	method = get_method(p_class, p_name);
+	if (method) {
+		_lookup_cache_set(r_cache, version, p_class, p_name, method, nullptr);
+	}
+	return method;
+}
+
 void ClassDB::bind_integer_constant(const StringName &p_class, const StringName &p_enum, const StringName &p_name, int64_t p_constant, bool p_is_bitfield) {
 	OBJTYPE_WLOCK;
 
@@ -945,6 +1003,7 @@ void ClassDB::add_property(const StringName &p_class, const PropertyInfo &p_pinf
 	psg.type = p_pinfo.type;
 
 	type->property_setget[p_pinfo.name] = psg;
+	lookup_version.increment();
 }
 
 void ClassDB::set_property_default_value(const StringName &p_class, const StringName &p_name, const Variant &p_default) {
@@ -1038,82 +1097,107 @@ bool ClassDB::get_property_info(const StringName &p_class, const StringName &p_p
 	return false;
 }
 
-bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid) {
+bool ClassDB::_get_property_from_setget(Object *p_object, const PropertySetGet *p_psg, Variant &r_value) {
+	if (!p_psg->getter) {
+		return true; //return true but do nothing
+	}
+
+	Callable::CallError ce;
+	if (p_psg->index >= 0) {
+		Variant index = p_psg->index;
+		const Variant *arg[1] = { &index };
+		r_value = p_object->callp(p_psg->getter, arg, 1, ce);
+	} else if (p_psg->_getptr) {
+		r_value = p_psg->_getptr->call(p_object, nullptr, 0, ce);
+	} else {
+		r_value = p_object->callp(p_psg->getter, nullptr, 0, ce);
+	}
+	return true;
+}
+
+bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid, ObjectLookupCache *r_cache) {
 	ERR_FAIL_NULL_V(p_object, false);
 
-	ClassInfo *type = classes.getptr(p_object->get_class_name());
-	ClassInfo *check = type;
-	while (check) {
-		const PropertySetGet *psg = check->property_setget.getptr(p_property);
-		if (psg) {
-			if (!psg->setter) {
-				if (r_valid) {
-					*r_valid = false;
-				}
-				return true; //return true but do nothing
+	const StringName &class_name = p_object->get_class_name();
+	const PropertySetGet *psg = nullptr;
+	MethodBind *cached_method = nullptr;
+	if (!r_cache || !_lookup_cache_get(*r_cache, class_name, p_property, cached_method, psg)) {
+		psg = nullptr;
+	}
+
+	if (!psg) {
+		uint32_t version = lookup_version.get();
+		ClassInfo *check = classes.getptr(class_name);
+		while (check) {
+			psg = check->property_setget.getptr(p_property);
+			if (psg) {
+				break;
 			}
+			check = check->inherits_ptr;
+		}
 
-			Callable::CallError ce;
+		if (!psg) {
+			return false;
+		}
+		if (r_cache) {
+			_lookup_cache_set(*r_cache, version, class_name, p_property, nullptr, psg);
+		}
+	}
 
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[2] = { &index, &p_value };
-				//p_object->call(psg->setter,arg,2,ce);
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 2, ce);
-				} else {
-					p_object->callp(psg->setter, arg, 2, ce);
-				}
+	if (!psg->setter) {
+		if (r_valid) {
+			*r_valid = false;
+		}
+		return true; //return true but do nothing
+	}
 
-			} else {
-				const Variant *arg[1] = { &p_value };
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 1, ce);
-				} else {
-					p_object->callp(psg->setter, arg, 1, ce);
-				}
-			}
+	Callable::CallError ce;
 
-			if (r_valid) {
-				*r_valid = ce.error == Callable::CallError::CALL_OK;
-			}
+	if (psg->index >= 0) {
+		Variant index = psg->index;
+		const Variant *arg[2] = { &index, &p_value };
+		//p_object->call(psg->setter,arg,2,ce);
+		if (psg->_setptr) {
+			psg->_setptr->call(p_object, arg, 2, ce);
+		} else {
+			p_object->callp(psg->setter, arg, 2, ce);
+		}
 
-			return true;
+	} else {
+		const Variant *arg[1] = { &p_value };
+		if (psg->_setptr) {
+			psg->_setptr->call(p_object, arg, 1, ce);
+		} else {
+			p_object->callp(psg->setter, arg, 1, ce);
 		}
+	}
 
-		check = check->inherits_ptr;
+	if (r_valid) {
+		*r_valid = ce.error == Callable::CallError::CALL_OK;
 	}
 
-	return false;
+	return true;
 }
 
-bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
+bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value, ObjectLookupCache *r_cache) {
 	ERR_FAIL_NULL_V(p_object, false);
 
-	ClassInfo *type = classes.getptr(p_object->get_class_name());
-	ClassInfo *check = type;
+	const StringName &class_name = p_object->get_class_name();
+	const PropertySetGet *psg = nullptr;
+	MethodBind *cached_method = nullptr;
+	if (r_cache && _lookup_cache_get(*r_cache, class_name, p_property, cached_method, psg) && psg) {
+		return _get_property_from_setget(p_object, psg, r_value);
+	}
+
+	uint32_t version = lookup_version.get();
+	ClassInfo *check = classes.getptr(class_name);
 	while (check) {
-		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		psg = check->property_setget.getptr(p_property);
 		if (psg) {
-			if (!psg->getter) {
-				return true; //return true but do nothing
-			}
-
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[1] = { &index };
-				Callable::CallError ce;
-				r_value = p_object->callp(psg->getter, arg, 1, ce);
-
-			} else {
-				Callable::CallError ce;
-				if (psg->_getptr) {
-					r_value = psg->_getptr->call(p_object, nullptr, 0, ce);
-				} else {
-					r_value = p_object->callp(psg->getter, nullptr, 0, ce);
-				}
+			if (r_cache) {
+				_lookup_cache_set(*r_cache, version, class_name, p_property, nullptr, psg);
 			}
-			return true;
+			return _get_property_from_setget(p_object, psg, r_value);
 		}
 
 		const int64_t *c = check->constant_map.getptr(p_property); //constants count
@@ -1270,6 +1354,7 @@ void ClassDB::bind_method_custom(const StringName &p_class, MethodBind *p_method
 #endif
 
 	type->method_map[p_method->get_name()] = p_method;
+	lookup_version.increment();
 }
 
 #ifdef DEBUG_METHODS_ENABLED
@@ -1316,6 +1401,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 #endif
 
 	type->method_map[mdname] = p_bind;
+	lookup_version.increment();
 
 	Vector<Variant> defvals;
 
@@ -1535,11 +1621,13 @@ void ClassDB::register_extension_class(ObjectNativeExtension *p_extension) {
 	c.exposed = true;
 
 	classes[p_extension->class_name] = c;
+	lookup_version.increment();
 }
 
 void ClassDB::unregister_extension_class(const StringName &p_class) {
 	ERR_FAIL_COND(!classes.has(p_class));
 	classes.erase(p_class);
+	lookup_version.increment();
 }
 
 HashMap<StringName, ClassDB::NativeStruct> ClassDB::native_structs;
@@ -1584,6 +1672,7 @@ void ClassDB::cleanup() {
 		}
 	}
 	classes.clear();
+	lookup_version.increment();
 	resource_base_extensions.clear();
 	compat_classes.clear();
 	native_structs.clear();
@@ -170,6 +170,12 @@ private:
 	static StringName _get_parent_class(const StringName &p_class);
 	static bool _is_parent_class(const StringName &p_class, const StringName &p_inherits);
 
+	// Incremented whenever classes, methods or properties change, invalidating lookup caches.
+	static SafeNumeric<uint32_t> lookup_version;
+	static bool _lookup_cache_get(const ObjectLookupCache &p_cache, const StringName &p_class, const StringName &p_name, MethodBind *&r_method, const PropertySetGet *&r_property);
+	static void _lookup_cache_set(ObjectLookupCache &r_cache, uint32_t p_version, const StringName &p_class, const StringName &p_name, MethodBind *p_method, const PropertySetGet *p_property);
+	static bool _get_property_from_setget(Object *p_object, const PropertySetGet *p_psg, Variant &r_value);
+
 public:
 	// DO NOT USE THIS!!!!!! NEEDS TO BE PUBLIC BUT DO NOT USE NO MATTER WHAT!!!
 	template <class T>
@@ -314,8 +320,8 @@ public:
 	static void get_property_list(const StringName &p_class, List<PropertyInfo> *p_list, bool p_no_inheritance = false, const Object *p_validator = nullptr);
 	static bool get_property_info(const StringName &p_class, const StringName &p_property, PropertyInfo *r_info, bool p_no_inheritance = false, const Object *p_validator = nullptr);
 	static void get_linked_properties_info(const StringName &p_class, const StringName &p_property, List<StringName> *r_properties, bool p_no_inheritance = false);
-	static bool set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid = nullptr);
-	static bool get_property(Object *p_object, const StringName &p_property, Variant &r_value);
+	static bool set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid = nullptr, ObjectLookupCache *r_cache = nullptr);
+	static bool get_property(Object *p_object, const StringName &p_property, Variant &r_value, ObjectLookupCache *r_cache = nullptr);
 	static bool has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance = false);
 	static int get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid = nullptr);
 	static Variant::Type get_property_type(const StringName &p_class, const StringName &p_property, bool *r_is_valid = nullptr);
@@ -328,6 +334,8 @@ public:
 	static void get_method_list(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static bool get_method_info(const StringName &p_class, const StringName &p_method, MethodInfo *r_info, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static MethodBind *get_method(const StringName &p_class, const StringName &p_name);
+	static MethodBind *get_method_cached(ObjectLookupCache &r_cache, const StringName &p_class, const StringName &p_name);
+	static uint32_t get_lookup_version() { return lookup_version.get(); }
 
 	static void add_virtual_method(const StringName &p_class, const MethodInfo &p_method, bool p_virtual = true, const Vector<String> &p_arg_names = Vector<String>(), bool p_object_core = false);
 	static void get_virtual_methods(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false);
@@ -37,64 +37,108 @@
 
 MessageQueue *MessageQueue::singleton = nullptr;
 
+thread_local MessageQueue::ThreadQueueRef MessageQueue::thread_queue;
+SafeNumeric<uint64_t> MessageQueue::last_owner_id;
+
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+MessageQueue::Page *MessageQueue::_alloc_page(uint32_t p_min_size) {
+	Page *page = memnew(Page);
+	page->capacity = MAX(page_size, p_min_size);
+	page->data = (uint8_t *)memalloc(page->capacity);
+	return page;
+}
+
+void MessageQueue::_free_page(Page *p_page) {
+	memfree(p_page->data);
+	memdelete(p_page);
+}
+
+MessageQueue::ThreadQueue *MessageQueue::_get_thread_queue() {
+	if (likely(thread_queue.owner_id == owner_id)) {
+		return thread_queue.queue;
+	}
+
+	// First message pushed by this thread, register a new producer.
+	ThreadQueue *queue = memnew(ThreadQueue);
+	queue->write_page = _alloc_page(page_size);
+	queue->read_page = queue->write_page;
+	{
+		_THREAD_SAFE_METHOD_
+		queue->next = thread_queues;
+		thread_queues = queue;
+	}
+
+	thread_queue.owner_id = owner_id;
+	thread_queue.queue = queue;
+	return queue;
+}
+
+uint8_t *MessageQueue::_reserve(ThreadQueue *p_queue, uint32_t p_size) {
+	Page *page = p_queue->write_page;
+	uint32_t pos = page->write_pos.get();
+	if (pos + p_size > page->capacity) {
+		// Grow by linking a new page. The consumer moves on once it has drained the old one.
+		Page *new_page = _alloc_page(p_size);
+		page->next.set(new_page);
+		p_queue->write_page = new_page;
+		return new_page->data;
+	}
+	return &page->data[pos];
+}
+
+void MessageQueue::_commit(ThreadQueue *p_queue, uint32_t p_size) {
+	// Publishes the message to the consumer.
+	p_queue->write_page->write_pos.add(p_size);
+}
+
+void MessageQueue::thread_exit() {
+	if (singleton && thread_queue.owner_id == singleton->owner_id) {
+		thread_queue.queue->abandoned.set();
+	}
+	thread_queue = ThreadQueueRef();
+}
+
 Error MessageQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
+	ThreadQueue *queue = _get_thread_queue();
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id)) {
-			type = ObjectDB::get_instance(p_id)->get_class();
-		}
-		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
+	uint8_t *buffer = _reserve(queue, room_needed);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(buffer, Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
+	memnew_placement(buffer + sizeof(Message), Variant(p_value));
 
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
-	*v = p_value;
+	_commit(queue, room_needed);
 
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	ThreadQueue *queue = _get_thread_queue();
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	uint32_t room_needed = sizeof(Message);
+	uint8_t *buffer = _reserve(queue, room_needed);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(buffer, Message);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
+	_commit(queue, room_needed);
 
 	return OK;
 }
@@ -112,17 +156,12 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
+	ThreadQueue *queue = _get_thread_queue();
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	uint8_t *buffer = _reserve(queue, room_needed);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(buffer, Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
@@ -130,72 +169,108 @@ Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(buffer + sizeof(Message));
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
-		*v = *p_args[i];
+		memnew_placement(&args[i], Variant(*p_args[i]));
 	}
 
+	_commit(queue, room_needed);
+
 	return OK;
 }
 
+uint32_t MessageQueue::_get_pending_bytes() const {
+	// Reads the consumer side of the queues, so it must only be called while flushing.
+	ThreadQueue *queue;
+	{
+		_THREAD_SAFE_METHOD_
+		queue = thread_queues;
+	}
+
+	uint32_t total = 0;
+	while (queue) {
+		Page *page = queue->read_page;
+		while (page) {
+			total += page->write_pos.get() - page->read_pos;
+			page = page->next.get();
+		}
+		queue = queue->next;
+	}
+	return total;
+}
+
 void MessageQueue::statistics() {
 	HashMap<StringName, int> set_count;
 	HashMap<int, int> notify_count;
 	HashMap<Callable, int> call_count;
 	int null_count = 0;
+	uint32_t total_bytes = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	// Holding the lock keeps a flush from starting, so the consumer side of the queues
+	// (read positions and pages) can't change while it is read here.
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND_MSG(flushing, "Can't get MessageQueue statistics while it is being flushed.");
 
-		Object *target = message->callable.get_object();
+	ThreadQueue *queue = thread_queues;
+	while (queue) {
+		Page *page = queue->read_page;
+		while (page) {
+			uint32_t read_pos = page->read_pos;
+			uint32_t end = page->write_pos.get();
+			total_bytes += end - read_pos;
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
+			while (read_pos < end) {
+				Message *message = (Message *)&page->data[read_pos];
 
-					call_count[message->callable]++;
+				Object *target = message->callable.get_object();
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+				if (target != nullptr) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
+							if (!call_count.has(message->callable)) {
+								call_count[message->callable] = 0;
+							}
 
-					notify_count[message->notification]++;
+							call_count[message->callable]++;
 
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+						} break;
+						case TYPE_NOTIFICATION: {
+							if (!notify_count.has(message->notification)) {
+								notify_count[message->notification] = 0;
+							}
 
-					set_count[t]++;
+							notify_count[message->notification]++;
 
-				} break;
-			}
+						} break;
+						case TYPE_SET: {
+							StringName t = message->callable.get_method();
+							if (!set_count.has(t)) {
+								set_count[t] = 0;
+							}
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+							set_count[t]++;
 
-			null_count++;
-		}
+						} break;
+					}
+
+				} else {
+					//object was deleted
+					print_line("Object was deleted while awaiting a callback");
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+					null_count++;
+				}
+
+				read_pos += sizeof(Message);
+				if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+					read_pos += sizeof(Variant) * message->args;
+				}
+			}
+			page = page->next.get();
 		}
+		queue = queue->next;
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
 
 	for (const KeyValue<StringName, int> &E : set_count) {
@@ -232,78 +307,120 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 	}
 }
 
-void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
 	}
 
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
+	p_message->~Message();
+}
 
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
+void MessageQueue::flush() {
+	{
+		_THREAD_SAFE_METHOD_
 		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+		flushing = true;
 	}
-	flushing = true;
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
+	uint32_t pending = _get_pending_bytes();
+	if (pending > buffer_max_used) {
+		buffer_max_used = pending;
+	}
 
-		Message *message = (Message *)&buffer[read_pos];
+	// Keep going until all producers are drained, so messages pushed while flushing are processed too.
+	bool processed = true;
+	while (processed) {
+		processed = false;
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+		ThreadQueue *queue;
+		{
+			_THREAD_SAFE_METHOD_
+			queue = thread_queues;
 		}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+		while (queue) {
+			Page *page = queue->read_page;
+			while (true) {
+				uint32_t end = page->write_pos.get();
+				if (page->read_pos < end) {
+					Message *message = (Message *)&page->data[page->read_pos];
 
-		_THREAD_SAFE_UNLOCK_
+					uint32_t advance = sizeof(Message);
+					if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+						advance += sizeof(Variant) * message->args;
+					}
+
+					//pre-advance so this function is reentrant
+					page->read_pos += advance;
+					processed = true;
 
-		Object *target = message->callable.get_object();
+					Object *target = message->callable.get_object();
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					Variant *args = (Variant *)(message + 1);
+					if (target != nullptr) {
+						switch (message->type & FLAG_MASK) {
+							case TYPE_CALL: {
+								Variant *args = (Variant *)(message + 1);
 
-					// messages don't expect a return value
+								// messages don't expect a return value
 
-					_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
+								_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					// messages don't expect a return value
-					target->notification(message->notification);
+							} break;
+							case TYPE_NOTIFICATION: {
+								// messages don't expect a return value
+								target->notification(message->notification);
 
-				} break;
-				case TYPE_SET: {
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->callable.get_method(), *arg);
+							} break;
+							case TYPE_SET: {
+								Variant *arg = (Variant *)(message + 1);
+								// messages don't expect a return value
+								target->set(message->callable.get_method(), *arg);
+
+							} break;
+						}
+					}
 
-				} break;
+					_destroy_message(message);
+					continue;
+				}
+
+				Page *next = page->next.get();
+				if (!next) {
+					break;
+				}
+				if (page->read_pos < page->write_pos.get()) {
+					continue; // Published right before the producer moved on.
+				}
+
+				queue->read_page = next;
+				_free_page(page);
+				page = next;
 			}
+
+			queue = queue->next;
 		}
+	}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
+	// Release the queues of threads that exited, now that they are drained.
+	{
+		_THREAD_SAFE_METHOD_
+		ThreadQueue **prev_next = &thread_queues;
+		while (*prev_next) {
+			ThreadQueue *queue = *prev_next;
+			if (queue->abandoned.is_set() && !queue->read_page->next.get() && queue->read_page->read_pos == queue->read_page->write_pos.get()) {
+				*prev_next = queue->next;
+				_free_page(queue->read_page);
+				memdelete(queue);
+			} else {
+				prev_next = &queue->next;
 			}
 		}
 
-		message->~Message();
-
-		_THREAD_SAFE_LOCK_
+		flushing = false;
 	}
-
-	buffer_end = 0; // reset buffer
-	flushing = false;
-	_THREAD_SAFE_UNLOCK_
 }
 
 bool MessageQueue::is_flushing() const {
@@ -314,32 +431,46 @@ MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
 
-	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
-	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	// Used to detect thread queues left over from a previous MessageQueue instance.
+	owner_id = last_owner_id.increment();
+
+	page_size = GLOBAL_DEF_RST("memory/limits/message_queue/page_size_kb", DEFAULT_PAGE_SIZE_KB);
+	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/page_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/page_size_kb", PROPERTY_HINT_RANGE, "4,1024,1,or_greater"));
+	// Projects made before the queue could grow set its whole size instead, use it for the pages.
+	if (page_size == DEFAULT_PAGE_SIZE_KB && ProjectSettings::get_singleton()->has_setting("memory/limits/message_queue/max_size_kb")) {
+		page_size = GLOBAL_GET("memory/limits/message_queue/max_size_kb");
+		WARN_PRINT("Project setting 'memory/limits/message_queue/max_size_kb' was renamed to 'memory/limits/message_queue/page_size_kb', its value is used as the page size.");
+	}
+	page_size *= 1024;
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
+	ThreadQueue *queue = thread_queues;
+	while (queue) {
+		Page *page = queue->read_page;
+		while (page) {
+			uint32_t read_pos = page->read_pos;
+			uint32_t end = page->write_pos.get();
+			while (read_pos < end) {
+				Message *message = (Message *)&page->data[read_pos];
+
+				read_pos += sizeof(Message);
+				if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+					read_pos += sizeof(Variant) * message->args;
+				}
+
+				_destroy_message(message);
 			}
-		}
-		message->~Message();
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+			Page *next = page->next.get();
+			_free_page(page);
+			page = next;
 		}
+
+		ThreadQueue *next = queue->next;
+		memdelete(queue);
+		queue = next;
 	}
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
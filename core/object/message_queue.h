@@ -33,6 +33,7 @@
 
 #include "core/object/object_id.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
 class Object;
@@ -41,7 +42,7 @@ class MessageQueue {
 	_THREAD_SAFE_CLASS_
 
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_PAGE_SIZE_KB = 32
 	};
 
 	enum {
@@ -62,10 +63,46 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer = nullptr;
-	uint32_t buffer_end = 0;
+	// Messages are written by a single producer thread into a chain of pages. The producer
+	// publishes each message by advancing `write_pos`, and links a new page once the current
+	// one is full. The flushing thread is the only consumer, so no locking is needed.
+	struct Page {
+		SafeNumeric<uint32_t> write_pos;
+		SafeNumeric<Page *> next;
+		uint32_t read_pos = 0;
+		uint32_t capacity = 0;
+		uint8_t *data = nullptr;
+	};
+
+	// Per-thread producer queue. Ordering of messages is preserved per producer thread.
+	struct ThreadQueue {
+		Page *write_page = nullptr; // Only accessed by the producer.
+		Page *read_page = nullptr; // Only accessed by the consumer.
+		SafeFlag abandoned; // Set when the owning thread exits.
+		ThreadQueue *next = nullptr;
+	};
+
+	struct ThreadQueueRef {
+		uint64_t owner_id = 0;
+		ThreadQueue *queue = nullptr;
+	};
+
+	static thread_local ThreadQueueRef thread_queue;
+	static SafeNumeric<uint64_t> last_owner_id;
+
+	uint64_t owner_id = 0;
+	uint32_t page_size = 0;
+	ThreadQueue *thread_queues = nullptr; // Registry of producers, guarded by the mutex.
+
 	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size = 0;
+
+	Page *_alloc_page(uint32_t p_min_size);
+	void _free_page(Page *p_page);
+	ThreadQueue *_get_thread_queue();
+	uint8_t *_reserve(ThreadQueue *p_queue, uint32_t p_size);
+	void _commit(ThreadQueue *p_queue, uint32_t p_size);
+	void _destroy_message(Message *p_message);
+	uint32_t _get_pending_bytes() const;
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
@@ -122,6 +159,9 @@ public:
 
 	int get_max_buffer_usage() const;
 
+	// Called by threads before exiting, so their queue can be released once drained.
+	static void thread_exit();
+
 	MessageQueue();
 	~MessageQueue();
 };
@@ -39,6 +39,7 @@
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
 #include "core/variant/typed_array.h"
+#include "core/variant/variant_internal.h"
 
 #ifdef DEBUG_ENABLED
 
@@ -212,7 +213,7 @@ void Object::get_valid_parents_static(List<String> *p_parents) {
 void Object::_get_valid_parents_static(List<String> *p_parents) {
 }
 
-void Object::set(const StringName &p_name, const Variant &p_value, bool *r_valid) {
+void Object::set(const StringName &p_name, const Variant &p_value, bool *r_valid, ObjectLookupCache *r_cache) {
 #ifdef TOOLS_ENABLED
 
 	_edited = true;
@@ -246,7 +247,7 @@ void Object::set(const StringName &p_name, const Variant &p_value, bool *r_valid
 
 	// Try built-in setter.
 	{
-		if (ClassDB::set_property(this, p_name, p_value, r_valid)) {
+		if (ClassDB::set_property(this, p_name, p_value, r_valid, r_cache)) {
 			return;
 		}
 	}
@@ -303,7 +304,7 @@ void Object::set(const StringName &p_name, const Variant &p_value, bool *r_valid
 	}
 }
 
-Variant Object::get(const StringName &p_name, bool *r_valid) const {
+Variant Object::get(const StringName &p_name, bool *r_valid, ObjectLookupCache *r_cache) const {
 	Variant ret;
 
 	if (script_instance) {
@@ -334,7 +335,7 @@ Variant Object::get(const StringName &p_name, bool *r_valid) const {
 
 	// Try built-in getter.
 	{
-		if (ClassDB::get_property(const_cast<Object *>(this), p_name, ret)) {
+		if (ClassDB::get_property(const_cast<Object *>(this), p_name, ret, r_cache)) {
 			if (r_valid) {
 				*r_valid = true;
 			}
@@ -738,6 +739,22 @@ Variant Object::callp(const StringName &p_method, const Variant **p_args, int p_
 	return ret;
 }
 
+Variant Object::callp_cached(ObjectLookupCache &r_cache, const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	if (script_instance || _custom_callp) {
+		return callp(p_method, p_args, p_argcount, r_error);
+	}
+
+	MethodBind *method = ClassDB::get_method_cached(r_cache, get_class_name(), p_method);
+	if (!method) {
+		// Not a bound method, let the regular path handle it (and report errors).
+		return callp(p_method, p_args, p_argcount, r_error);
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+	OBJ_DEBUG_LOCK
+	return method->call(this, p_args, p_argcount, r_error);
+}
+
 Variant Object::call_const(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	r_error.error = Callable::CallError::CALL_OK;
 
@@ -995,6 +1012,33 @@ Error Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::Cal
 	return emit_signalp(signal, args, argc);
 }
 
+// Calls a native method bound to a signal through ptrcall, skipping the method lookup and
+// argument conversion done by Object::callp(). Only done when every argument already has
+// the exact type expected by the method, otherwise returns false to use the regular path.
+static _FORCE_INLINE_ bool _signal_ptrcall(MethodBind *p_method, Object *p_target, const Variant **p_args, int p_argcount) {
+	if (p_method->get_argument_count() != p_argcount) {
+		return false;
+	}
+
+	const void **argptrs = (const void **)alloca(sizeof(void *) * MAX(p_argcount, 1));
+	for (int i = 0; i < p_argcount; i++) {
+		Variant::Type type = p_method->get_argument_type(i);
+		if (type == Variant::NIL) {
+			argptrs[i] = p_args[i]; // Variant argument.
+		} else if (type == p_args[i]->get_type() && type != Variant::OBJECT) {
+			argptrs[i] = VariantInternal::get_opaque_pointer(p_args[i]);
+		} else {
+			return false;
+		}
+	}
+
+#ifdef DEBUG_ENABLED
+	_ObjectDebugLock target_lock(p_target);
+#endif
+	p_method->ptrcall(p_target, argptrs, nullptr);
+	return true;
+}
+
 Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int p_argcount) {
 	if (_block_signals) {
 		return ERR_CANT_ACQUIRE_RESOURCE; //no emit, signals blocked
@@ -1025,7 +1069,8 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 	Error err = OK;
 
 	for (int i = 0; i < ssize; i++) {
-		const Connection &c = slot_map.getv(i).conn;
+		const SignalData::Slot &slot = slot_map.getv(i);
+		const Connection &c = slot.conn;
 
 		Object *target = c.callable.get_object();
 		if (!target) {
@@ -1041,8 +1086,11 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		} else {
 			Callable::CallError ce;
 			_emitting = true;
-			Variant ret;
-			c.callable.callp(args, argc, ret, ce);
+			// Native methods are called directly when the arguments allow it.
+			if (!slot.method_bind || target->script_instance || !_signal_ptrcall(slot.method_bind, target, args, argc)) {
+				Variant ret;
+				c.callable.callp(args, argc, ret, ce);
+			}
 			_emitting = false;
 
 			if (ce.error != Callable::CallError::CALL_OK) {
@@ -1281,6 +1329,13 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 	if (p_flags & CONNECT_REFERENCE_COUNTED) {
 		slot.reference_count = 1;
 	}
+	if (!target.is_custom()) {
+		// Plain method callable, see if it can be dispatched directly when emitting.
+		MethodBind *method = ClassDB::get_method(target_object->get_class_name(), target.get_method());
+		if (method && !method->is_vararg() && !method->is_static() && !method->has_return()) {
+			slot.method_bind = method;
+		}
+	}
 
 	//use callable version as key, so binds can be ignored
 	s->slot_map[*target.get_base_comparator()] = slot;
@@ -1846,10 +1901,13 @@ void postinitialize_handler(Object *p_object) {
 void ObjectDB::debug_objects(DebugFunc p_func) {
 	spin_lock.lock();
 
-	for (uint32_t i = 0, count = slot_count; i < slot_max && count != 0; i++) {
-		if (object_slots[i].validator) {
-			p_func(object_slots[i].object);
-			count--;
+	for (uint32_t i = 0; i < slot_max; i++) {
+		ObjectSlot &object_slot = _get_slot(i);
+		if (object_slot.state.load(std::memory_order_acquire) & OBJECTDB_SLOT_LIVE_BIT) {
+			Object *object = object_slot.object.load(std::memory_order_acquire);
+			if (object) {
+				p_func(object);
+			}
 		}
 	}
 	spin_lock.unlock();
@@ -1859,45 +1917,96 @@ void Object::get_argument_options(const StringName &p_function, int p_idx, List<
 }
 
 SpinLock ObjectDB::spin_lock;
-uint32_t ObjectDB::slot_count = 0;
+std::atomic<ObjectDB::ObjectSlot *> ObjectDB::object_chunks[OBJECTDB_SLOT_CHUNK_COUNT] = {};
 uint32_t ObjectDB::slot_max = 0;
-ObjectDB::ObjectSlot *ObjectDB::object_slots = nullptr;
-uint64_t ObjectDB::validator_counter = 0;
+uint32_t ObjectDB::free_slot_head = OBJECTDB_NO_SLOT;
+SafeNumeric<uint32_t> ObjectDB::slot_count;
+SafeNumeric<uint64_t> ObjectDB::slot_reuse_count;
+thread_local ObjectDB::ThreadSlotCache ObjectDB::thread_slot_cache;
 
 int ObjectDB::get_object_count() {
-	return slot_count;
+	return slot_count.get();
 }
 
-ObjectID ObjectDB::add_instance(Object *p_object) {
+uint32_t ObjectDB::get_slot_count() {
 	spin_lock.lock();
-	if (unlikely(slot_count == slot_max)) {
-		CRASH_COND(slot_count == (1 << OBJECTDB_SLOT_MAX_COUNT_BITS));
+	uint32_t count = slot_max;
+	spin_lock.unlock();
+	return count;
+}
+
+uint64_t ObjectDB::get_slot_reuse_count() {
+	return slot_reuse_count.get();
+}
+
+void ObjectDB::_refill_thread_cache() {
+	ThreadSlotCache &cache = thread_slot_cache;
 
-		uint32_t new_slot_max = slot_max > 0 ? slot_max * 2 : 1;
-		object_slots = (ObjectSlot *)memrealloc(object_slots, sizeof(ObjectSlot) * new_slot_max);
-		for (uint32_t i = slot_max; i < new_slot_max; i++) {
-			object_slots[i].object = nullptr;
-			object_slots[i].is_ref_counted = false;
-			object_slots[i].next_free = i;
-			object_slots[i].validator = 0;
+	spin_lock.lock();
+	while (cache.count < OBJECTDB_THREAD_CACHE_BATCH) {
+		uint32_t slot = free_slot_head;
+		if (slot != OBJECTDB_NO_SLOT) {
+			free_slot_head = _get_slot(slot).next_free;
+		} else {
+			if (unlikely(slot_max == (1 << OBJECTDB_SLOT_MAX_COUNT_BITS))) {
+				break;
+			}
+			slot = slot_max++;
+			if ((slot & OBJECTDB_SLOT_CHUNK_MASK) == 0) {
+				object_chunks[slot >> OBJECTDB_SLOT_CHUNK_BITS].store(memnew_arr(ObjectSlot, OBJECTDB_SLOT_CHUNK_SIZE), std::memory_order_release);
+			}
 		}
-		slot_max = new_slot_max;
+		cache.slots[cache.count++] = slot;
 	}
+	spin_lock.unlock();
 
-	uint32_t slot = object_slots[slot_count].next_free;
-	if (object_slots[slot].object != nullptr) {
-		spin_lock.unlock();
-		ERR_FAIL_COND_V(object_slots[slot].object != nullptr, ObjectID());
+	CRASH_COND_MSG(cache.count == 0, "No more object slots available.");
+}
+
+void ObjectDB::_drain_thread_cache(uint32_t p_count) {
+	ThreadSlotCache &cache = thread_slot_cache;
+
+	spin_lock.lock();
+	for (uint32_t i = 0; i < p_count; i++) {
+		uint32_t slot = cache.slots[--cache.count];
+		_get_slot(slot).next_free = free_slot_head;
+		free_slot_head = slot;
 	}
-	object_slots[slot].object = p_object;
-	object_slots[slot].is_ref_counted = p_object->is_ref_counted();
-	validator_counter = (validator_counter + 1) & OBJECTDB_VALIDATOR_MASK;
-	if (unlikely(validator_counter == 0)) {
-		validator_counter = 1;
+	spin_lock.unlock();
+}
+
+void ObjectDB::thread_exit() {
+	if (thread_slot_cache.count > 0) {
+		_drain_thread_cache(thread_slot_cache.count);
+	}
+}
+
+ObjectID ObjectDB::add_instance(Object *p_object) {
+	ThreadSlotCache &cache = thread_slot_cache;
+	if (unlikely(cache.count == 0)) {
+		_refill_thread_cache();
 	}
-	object_slots[slot].validator = validator_counter;
 
-	uint64_t id = validator_counter;
+	uint32_t slot = cache.slots[--cache.count];
+	ObjectSlot &object_slot = _get_slot(slot);
+
+	uint64_t state = object_slot.state.load(std::memory_order_relaxed);
+	ERR_FAIL_COND_V(state & OBJECTDB_SLOT_LIVE_BIT, ObjectID());
+
+	uint64_t validator = state & OBJECTDB_VALIDATOR_MASK;
+	if (validator != 0) {
+		slot_reuse_count.increment();
+	}
+	validator = (validator + 1) & OBJECTDB_VALIDATOR_MASK;
+	if (unlikely(validator == 0)) {
+		validator = 1;
+	}
+
+	object_slot.object.store(p_object, std::memory_order_relaxed);
+	// Publishing the state makes the object visible to lookups from other threads.
+	object_slot.state.store(validator | OBJECTDB_SLOT_LIVE_BIT | (p_object->is_ref_counted() ? OBJECTDB_SLOT_REF_COUNTED_BIT : 0), std::memory_order_release);
+
+	uint64_t id = validator;
 	id <<= OBJECTDB_SLOT_MAX_COUNT_BITS;
 	id |= uint64_t(slot);
 
@@ -1905,9 +2014,7 @@ ObjectID ObjectDB::add_instance(Object *p_object) {
 		id |= OBJECTDB_REFERENCE_BIT;
 	}
 
-	slot_count++;
-
-	spin_lock.unlock();
+	slot_count.increment();
 
 	return ObjectID(id);
 }
@@ -1915,34 +2022,30 @@ ObjectID ObjectDB::add_instance(Object *p_object) {
 void ObjectDB::remove_instance(Object *p_object) {
 	uint64_t t = p_object->get_instance_id();
 	uint32_t slot = t & OBJECTDB_SLOT_MAX_COUNT_MASK; //slot is always valid on valid object
+	ObjectSlot &object_slot = _get_slot(slot);
 
-	spin_lock.lock();
+	uint64_t state = object_slot.state.load(std::memory_order_relaxed);
 
 #ifdef DEBUG_ENABLED
 
-	if (object_slots[slot].object != p_object) {
-		spin_lock.unlock();
-		ERR_FAIL_COND(object_slots[slot].object != p_object);
-	}
+	ERR_FAIL_COND(object_slot.object.load(std::memory_order_relaxed) != p_object);
 	{
 		uint64_t validator = (t >> OBJECTDB_SLOT_MAX_COUNT_BITS) & OBJECTDB_VALIDATOR_MASK;
-		if (object_slots[slot].validator != validator) {
-			spin_lock.unlock();
-			ERR_FAIL_COND(object_slots[slot].validator != validator);
-		}
+		ERR_FAIL_COND((state & OBJECTDB_SLOT_CHECK_MASK) != (validator | OBJECTDB_SLOT_LIVE_BIT));
 	}
 
 #endif
-	//decrease slot count
-	slot_count--;
-	//set the free slot properly
-	object_slots[slot_count].next_free = slot;
-	//invalidate, so checks against it fail
-	object_slots[slot].validator = 0;
-	object_slots[slot].is_ref_counted = false;
-	object_slots[slot].object = nullptr;
+	//invalidate, so checks against it fail, but keep the validator so it's not reused by the next object in this slot
+	object_slot.state.store(state & OBJECTDB_VALIDATOR_MASK, std::memory_order_release);
+	object_slot.object.store(nullptr, std::memory_order_release);
 
-	spin_lock.unlock();
+	slot_count.decrement();
+
+	ThreadSlotCache &cache = thread_slot_cache;
+	if (unlikely(cache.count == OBJECTDB_THREAD_CACHE_SIZE)) {
+		_drain_thread_cache(OBJECTDB_THREAD_CACHE_BATCH);
+	}
+	cache.slots[cache.count++] = slot;
 }
 
 void ObjectDB::setup() {
@@ -1950,7 +2053,7 @@ void ObjectDB::setup() {
 }
 
 void ObjectDB::cleanup() {
-	if (slot_count > 0) {
+	if (slot_count.get() > 0) {
 		spin_lock.lock();
 
 		WARN_PRINT("ObjectDB instances leaked at exit (run with --verbose for details).");
@@ -1962,9 +2065,10 @@ void ObjectDB::cleanup() {
 			MethodBind *resource_get_path = ClassDB::get_method("Resource", "get_path");
 			Callable::CallError call_error;
 
-			for (uint32_t i = 0, count = slot_count; i < slot_max && count != 0; i++) {
-				if (object_slots[i].validator) {
-					Object *obj = object_slots[i].object;
+			for (uint32_t i = 0; i < slot_max; i++) {
+				uint64_t state = _get_slot(i).state.load(std::memory_order_acquire);
+				if (state & OBJECTDB_SLOT_LIVE_BIT) {
+					Object *obj = _get_slot(i).object.load(std::memory_order_acquire);
 
 					String extra_info;
 					if (obj->is_class("Node")) {
@@ -1974,10 +2078,8 @@ void ObjectDB::cleanup() {
 						extra_info = " - Resource path: " + String(resource_get_path->call(obj, nullptr, 0, call_error));
 					}
 
-					uint64_t id = uint64_t(i) | (uint64_t(object_slots[i].validator) << OBJECTDB_VALIDATOR_BITS) | (object_slots[i].is_ref_counted ? OBJECTDB_REFERENCE_BIT : 0);
+					uint64_t id = uint64_t(i) | ((state & OBJECTDB_VALIDATOR_MASK) << OBJECTDB_SLOT_MAX_COUNT_BITS) | ((state & OBJECTDB_SLOT_REF_COUNTED_BIT) ? OBJECTDB_REFERENCE_BIT : 0);
 					print_line("Leaked instance: " + String(obj->get_class()) + ":" + itos(id) + extra_info);
-
-					count--;
 				}
 			}
 			print_line("Hint: Leaked instances typically happen when nodes are removed from the scene tree (with `remove_child()`) but not freed (with `free()` or `queue_free()`).");
@@ -1985,7 +2087,14 @@ void ObjectDB::cleanup() {
 		spin_lock.unlock();
 	}
 
-	if (object_slots) {
-		memfree(object_slots);
+	for (uint32_t i = 0; i < OBJECTDB_SLOT_CHUNK_COUNT; i++) {
+		ObjectSlot *chunk = object_chunks[i].load(std::memory_order_relaxed);
+		if (chunk) {
+			memdelete_arr(chunk);
+			object_chunks[i].store(nullptr, std::memory_order_relaxed);
+		}
 	}
+	slot_max = 0;
+	free_slot_head = OBJECTDB_NO_SLOT;
+	thread_slot_cache.count = 0;
 }
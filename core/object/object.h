@@ -532,6 +532,27 @@ private:
 
 class ScriptInstance;
 
+// Remembers the result of a ClassDB method or property lookup for a given call site, so that
+// repeated dynamic calls and property accesses on objects of the same class skip the lookup.
+// Keep one per call site. Entries are validated against the class, the name and the ClassDB
+// version, and may be shared between threads. See ClassDB::get_method_cached().
+class ObjectLookupCache {
+	friend class ClassDB;
+
+	SafeNumeric<uint32_t> sequence; // Odd while an update is in progress.
+	uint32_t version = 0;
+	const void *class_key = nullptr;
+	const void *name_key = nullptr;
+	MethodBind *method = nullptr;
+	const void *property = nullptr; // ClassDB::PropertySetGet.
+
+public:
+	// Copies start empty, so containers of caches can be resized freely.
+	ObjectLookupCache &operator=(const ObjectLookupCache &p_other) { return *this; }
+	ObjectLookupCache(const ObjectLookupCache &p_other) {}
+	ObjectLookupCache() {}
+};
+
 class Object {
 public:
 	enum ConnectFlags {
@@ -569,6 +590,7 @@ private:
 			int reference_count = 0;
 			Connection conn;
 			List<Connection>::Element *cE = nullptr;
+			MethodBind *method_bind = nullptr; // Resolved at connect time when the target is a native method that can be ptrcalled.
 		};
 
 		MethodInfo user;
@@ -587,6 +609,7 @@ private:
 	void _postinitialize();
 	bool _can_translate = true;
 	bool _emitting = false;
+	bool _custom_callp = false;
 #ifdef TOOLS_ENABLED
 	bool _edited = false;
 	uint32_t _edited_version = 0;
@@ -628,6 +651,10 @@ private:
 	Object(bool p_reference);
 
 protected:
+	// Must be called by classes overriding callp() to resolve methods themselves, so cached
+	// call sites don't bypass the override.
+	void _set_custom_callp() { _custom_callp = true; }
+
 	_FORCE_INLINE_ bool _instance_binding_reference(bool p_reference) {
 		bool can_die = true;
 		if (_instance_bindings) {
@@ -803,8 +830,8 @@ public:
 
 	/* IAPI */
 
-	void set(const StringName &p_name, const Variant &p_value, bool *r_valid = nullptr);
-	Variant get(const StringName &p_name, bool *r_valid = nullptr) const;
+	void set(const StringName &p_name, const Variant &p_value, bool *r_valid = nullptr, ObjectLookupCache *r_cache = nullptr);
+	Variant get(const StringName &p_name, bool *r_valid = nullptr, ObjectLookupCache *r_cache = nullptr) const;
 	void set_indexed(const Vector<StringName> &p_names, const Variant &p_value, bool *r_valid = nullptr);
 	Variant get_indexed(const Vector<StringName> &p_names, bool *r_valid = nullptr) const;
 
@@ -817,6 +844,7 @@ public:
 	void get_method_list(List<MethodInfo> *p_list) const;
 	Variant callv(const StringName &p_method, const Array &p_args);
 	virtual Variant callp(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+	Variant callp_cached(ObjectLookupCache &r_cache, const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	virtual Variant call_const(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 
 	template <typename... VarArgs>
@@ -945,18 +973,47 @@ class ObjectDB {
 #define OBJECTDB_SLOT_MAX_COUNT_MASK ((uint64_t(1) << OBJECTDB_SLOT_MAX_COUNT_BITS) - 1)
 #define OBJECTDB_REFERENCE_BIT (uint64_t(1) << (OBJECTDB_SLOT_MAX_COUNT_BITS + OBJECTDB_VALIDATOR_BITS))
 
-	struct ObjectSlot { // 128 bits per slot.
-		uint64_t validator : OBJECTDB_VALIDATOR_BITS;
-		uint64_t next_free : OBJECTDB_SLOT_MAX_COUNT_BITS;
-		uint64_t is_ref_counted : 1;
-		Object *object = nullptr;
+// Slots are allocated in chunks that never move, so they can be read without locking.
+#define OBJECTDB_SLOT_CHUNK_BITS 12
+#define OBJECTDB_SLOT_CHUNK_SIZE (1 << OBJECTDB_SLOT_CHUNK_BITS)
+#define OBJECTDB_SLOT_CHUNK_MASK (OBJECTDB_SLOT_CHUNK_SIZE - 1)
+#define OBJECTDB_SLOT_CHUNK_COUNT (1 << (OBJECTDB_SLOT_MAX_COUNT_BITS - OBJECTDB_SLOT_CHUNK_BITS))
+
+// The slot state keeps the validator of the last object stored in it, so it's incremented on reuse.
+#define OBJECTDB_SLOT_LIVE_BIT (uint64_t(1) << OBJECTDB_VALIDATOR_BITS)
+#define OBJECTDB_SLOT_REF_COUNTED_BIT (uint64_t(1) << (OBJECTDB_VALIDATOR_BITS + 1))
+#define OBJECTDB_SLOT_CHECK_MASK (OBJECTDB_VALIDATOR_MASK | OBJECTDB_SLOT_LIVE_BIT)
+
+#define OBJECTDB_THREAD_CACHE_SIZE 64
+#define OBJECTDB_THREAD_CACHE_BATCH (OBJECTDB_THREAD_CACHE_SIZE / 2)
+#define OBJECTDB_NO_SLOT UINT32_MAX
+
+	struct ObjectSlot {
+		std::atomic<uint64_t> state = { 0 }; // Validator, plus the live and ref counted bits.
+		std::atomic<Object *> object = { nullptr };
+		uint32_t next_free = OBJECTDB_NO_SLOT; // Only used while the slot is in the free list.
+	};
+
+	// Each thread allocates from and frees to its own slots, and only locks to exchange a batch of them with the shared free list.
+	struct ThreadSlotCache {
+		uint32_t slots[OBJECTDB_THREAD_CACHE_SIZE];
+		uint32_t count = 0;
 	};
 
 	static SpinLock spin_lock;
-	static uint32_t slot_count;
-	static uint32_t slot_max;
-	static ObjectSlot *object_slots;
-	static uint64_t validator_counter;
+	static std::atomic<ObjectSlot *> object_chunks[OBJECTDB_SLOT_CHUNK_COUNT];
+	static uint32_t slot_max; // Slots used at least once, guarded by the lock.
+	static uint32_t free_slot_head; // Shared free list, guarded by the lock.
+	static SafeNumeric<uint32_t> slot_count;
+	static SafeNumeric<uint64_t> slot_reuse_count;
+	static thread_local ThreadSlotCache thread_slot_cache;
+
+	_ALWAYS_INLINE_ static ObjectSlot &_get_slot(uint32_t p_slot) {
+		return object_chunks[p_slot >> OBJECTDB_SLOT_CHUNK_BITS].load(std::memory_order_relaxed)[p_slot & OBJECTDB_SLOT_CHUNK_MASK];
+	}
+
+	static void _refill_thread_cache();
+	static void _drain_thread_cache(uint32_t p_count);
 
 	friend class Object;
 	friend void unregister_core_types();
@@ -975,25 +1032,32 @@ public:
 		uint64_t id = p_instance_id;
 		uint32_t slot = id & OBJECTDB_SLOT_MAX_COUNT_MASK;
 
-		ERR_FAIL_COND_V(slot >= slot_max, nullptr); // This should never happen unless RID is corrupted.
-
-		spin_lock.lock();
+		ObjectSlot *chunk = object_chunks[slot >> OBJECTDB_SLOT_CHUNK_BITS].load(std::memory_order_acquire);
+		ERR_FAIL_COND_V(!chunk, nullptr); // This should never happen unless RID is corrupted.
+		ObjectSlot &object_slot = chunk[slot & OBJECTDB_SLOT_CHUNK_MASK];
 
-		uint64_t validator = (id >> OBJECTDB_SLOT_MAX_COUNT_BITS) & OBJECTDB_VALIDATOR_MASK;
+		uint64_t expected = ((id >> OBJECTDB_SLOT_MAX_COUNT_BITS) & OBJECTDB_VALIDATOR_MASK) | OBJECTDB_SLOT_LIVE_BIT;
 
-		if (unlikely(object_slots[slot].validator != validator)) {
-			spin_lock.unlock();
+		if (unlikely((object_slot.state.load(std::memory_order_acquire) & OBJECTDB_SLOT_CHECK_MASK) != expected)) {
 			return nullptr;
 		}
 
-		Object *object = object_slots[slot].object;
+		Object *object = object_slot.object.load(std::memory_order_acquire);
 
-		spin_lock.unlock();
+		// Check again, in case the slot was freed and reused by another thread in between.
+		if (unlikely((object_slot.state.load(std::memory_order_acquire) & OBJECTDB_SLOT_CHECK_MASK) != expected)) {
+			return nullptr;
+		}
 
 		return object;
 	}
 	static void debug_objects(DebugFunc p_func);
 	static int get_object_count();
+	static uint32_t get_slot_count();
+	static uint64_t get_slot_reuse_count();
+
+	// Returns the slots cached by the calling thread to the shared free list, called when a thread exits.
+	static void thread_exit();
 };
 
 #endif // OBJECT_H
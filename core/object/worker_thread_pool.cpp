@@ -40,71 +40,122 @@ void WorkerThreadPool::Task::free_template_userdata() {
 }
 
 WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
+thread_local int WorkerThreadPool::current_thread_index = -1;
+
+WorkerThreadPool::Task *WorkerThreadPool::_pop_task() {
+	int index = current_thread_index;
+
+	if (index >= 0) {
+		// Own tasks first, newest first, as whatever they use is most likely still in cache.
+		ThreadData &own = threads[index];
+		if (own.queued.get() > 0) {
+			MutexLock lock(own.queue_mutex);
+			SelfList<Task> *E = own.queue.first();
+			if (E) {
+				own.queue.remove(E);
+				own.queued.decrement();
+				return E->self();
+			}
+		}
+	}
 
-void WorkerThreadPool::_process_task_queue() {
 	task_mutex.lock();
-	Task *task = task_queue.first()->self();
-	task_queue.remove(task_queue.first());
+	SelfList<Task> *E = task_queue.first();
+	if (E) {
+		task_queue.remove(E);
+		task_mutex.unlock();
+		return E->self();
+	}
 	task_mutex.unlock();
-	_process_task(task);
+
+	// Steal the oldest task of another thread. Start after our own index, so thieves spread out.
+	uint32_t thread_count = threads.size();
+	uint32_t start = index + 1;
+	for (uint32_t i = 0; i < thread_count; i++) {
+		ThreadData &victim = threads[(start + i) % thread_count];
+		if (int(victim.index) == index || victim.queued.get() == 0) {
+			continue;
+		}
+		MutexLock lock(victim.queue_mutex);
+		SelfList<Task> *V = victim.queue.last();
+		if (V) {
+			victim.queue.remove(V);
+			victim.queued.decrement();
+			return V->self();
+		}
+	}
+
+	return nullptr;
 }
 
-void WorkerThreadPool::_process_task(Task *p_task) {
-	bool low_priority = p_task->low_priority;
+bool WorkerThreadPool::_process_group_elements(Group *p_group) {
+	bool do_post = false;
+	Callable::CallError ce;
+	Variant ret;
+	Variant arg;
+	Variant *argptr = &arg;
 
-	if (p_task->group) {
-		// Handling a group
-		bool do_post = false;
-		Callable::CallError ce;
-		Variant ret;
-		Variant arg;
-		Variant *argptr = &arg;
+	while (true) {
+		// Elements are claimed in batches, so cheap ones don't all contend on the same counter.
+		uint32_t from = p_group->index.postadd(p_group->batch_size);
 
-		while (true) {
-			uint32_t work_index = p_task->group->index.postincrement();
+		if (from >= p_group->max) {
+			break;
+		}
+		uint32_t to = MIN(from + p_group->batch_size, p_group->max);
 
-			if (work_index >= p_task->group->max) {
-				break;
-			}
-			if (p_task->native_group_func) {
-				p_task->native_group_func(p_task->native_func_userdata, work_index);
-			} else if (p_task->template_userdata) {
-				p_task->template_userdata->callback_indexed(work_index);
+		for (uint32_t work_index = from; work_index < to; work_index++) {
+			if (p_group->native_group_func) {
+				p_group->native_group_func(p_group->native_func_userdata, work_index);
+			} else if (p_group->template_userdata) {
+				p_group->template_userdata->callback_indexed(work_index);
 			} else {
 				arg = work_index;
-				p_task->callable.callp((const Variant **)&argptr, 1, ret, ce);
+				p_group->callable.callp((const Variant **)&argptr, 1, ret, ce);
 			}
+		}
 
-			// This is the only way to ensure posting is done when all tasks are really complete.
-			uint32_t completed_amount = p_task->group->completed_index.increment();
+		// This is the only way to ensure posting is done when all tasks are really complete.
+		uint32_t completed_amount = p_group->completed_index.add(to - from);
 
-			if (completed_amount == p_task->group->max) {
-				do_post = true;
-			}
+		if (completed_amount == p_group->max) {
+			do_post = true;
 		}
+	}
 
-		if (do_post && p_task->template_userdata) {
-			memdelete(p_task->template_userdata); // This is no longer needed at this point, so get rid of it.
-		}
+	if (do_post && p_group->template_userdata) {
+		memdelete(p_group->template_userdata); // This is no longer needed at this point, so get rid of it.
+	}
+
+	return do_post;
+}
+
+void WorkerThreadPool::_process_task(Task *p_task) {
+	bool low_priority = p_task->low_priority;
+
+	if (p_task->group) {
+		// Handling a group
+		Group *group = p_task->group;
+		bool do_post = _process_group_elements(group);
 
 		if (low_priority && use_native_low_priority_threads) {
 			p_task->completed = true;
 			p_task->done_semaphore.post();
 			if (do_post) {
-				p_task->group->completed.set_to(true);
+				group->completed.set_to(true);
 			}
 		} else {
 			if (do_post) {
-				p_task->group->done_semaphore.post();
-				p_task->group->completed.set_to(true);
+				group->done_semaphore.post();
+				group->completed.set_to(true);
 			}
-			uint32_t max_users = p_task->group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
-			uint32_t finished_users = p_task->group->finished.increment();
+			uint32_t max_users = group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
+			uint32_t finished_users = group->finished.increment();
 
 			if (finished_users == max_users) {
 				// Get rid of the group, because nobody else is using it.
 				task_mutex.lock();
-				group_allocator.free(p_task->group);
+				group_allocator.free(group);
 				task_mutex.unlock();
 			}
 
@@ -126,36 +177,78 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			p_task->callable.callp(nullptr, 0, ret, ce);
 		}
 
-		p_task->completed = true;
-		p_task->done_semaphore.post();
+		_complete_task(p_task);
 	}
 
 	if (!use_native_low_priority_threads && low_priority) {
 		// A low prioriry task was freed, so see if we can move a pending one to the high priority queue.
-		bool post = false;
+		Task *low_prio_task = nullptr;
 		task_mutex.lock();
 		if (low_priority_task_queue.first()) {
-			Task *low_prio_task = low_priority_task_queue.first()->self();
+			low_prio_task = low_priority_task_queue.first()->self();
 			low_priority_task_queue.remove(low_priority_task_queue.first());
-			task_queue.add_last(&low_prio_task->task_elem);
-			post = true;
 		} else {
 			low_priority_threads_used.decrement();
 		}
-		task_mutex.lock();
-		if (post) {
+		task_mutex.unlock();
+		if (low_prio_task) {
+			_push_task(low_prio_task);
 			task_available_semaphore.post();
 		}
 	}
 }
 
+void WorkerThreadPool::_complete_task(Task *p_task) {
+	// Dependents can be added until the task is marked as completed, so both happen under the lock.
+	LocalVector<Task *> ready;
+	task_mutex.lock();
+	p_task->completed = true;
+	for (uint32_t i = 0; i < p_task->dependents.size(); i++) {
+		Task *dependent = p_task->dependents[i];
+		if (dependent->pending_dependencies.decrement() == 0) {
+			ready.push_back(dependent);
+		}
+	}
+	p_task->dependents.clear();
+	task_mutex.unlock();
+
+	p_task->done_semaphore.post(); // The waiting thread may free the task from here on.
+
+	// Continuations are posted from the thread that completed their last
+	// dependency, so a pool thread runs them next while the results are hot.
+	for (uint32_t i = 0; i < ready.size(); i++) {
+		_post_task(ready[i], !ready[i]->low_priority);
+	}
+}
+
+void WorkerThreadPool::_wait_helping(Semaphore &p_semaphore) {
+	// We are an actual process thread, we must not be blocked so continue processing stuff if available.
+	while (!p_semaphore.try_wait()) {
+		Task *task = _pop_task();
+		if (task) {
+			// Solve tasks while they are around.
+			_process_task(task);
+		} else {
+			OS::get_singleton()->delay_usec(1); // Microsleep, this could be converted to waiting for multiple objects in supported platforms for a bit more performance.
+		}
+	}
+}
+
 void WorkerThreadPool::_thread_function(void *p_user) {
+	ThreadData *thread_data = (ThreadData *)p_user;
+	current_thread_index = thread_data->index;
+
 	while (true) {
-		singleton->task_available_semaphore.wait();
+		Task *task = singleton->_pop_task();
+		if (task) {
+			singleton->_process_task(task);
+			continue;
+		}
+		// Only exit once there is nothing left, group tasks may still be queued after their group was waited for.
 		if (singleton->exit_threads.is_set()) {
 			break;
 		}
-		singleton->_process_task_queue();
+		singleton->task_available_semaphore.wait();
 	}
 }
 
@@ -164,33 +257,52 @@ void WorkerThreadPool::_native_low_priority_thread_function(void *p_user) {
 	singleton->_process_task(task);
 }
 
+void WorkerThreadPool::_push_task(Task *p_task) {
+	int index = current_thread_index;
+	if (index >= 0) {
+		// Posted from a pool thread, so it goes to its own queue.
+		ThreadData &own = threads[index];
+		MutexLock lock(own.queue_mutex);
+		own.queue.add(&p_task->task_elem);
+		own.queued.increment();
+	} else {
+		task_mutex.lock();
+		task_queue.add_last(&p_task->task_elem);
+		task_mutex.unlock();
+	}
+}
+
 void WorkerThreadPool::_post_task(Task *p_task, bool p_high_priority) {
-	task_mutex.lock();
-	p_task->low_priority = !p_high_priority;
 	if (!p_high_priority && use_native_low_priority_threads) {
-		task_mutex.unlock();
+		// Started under the lock, as the waiting thread may already be done waiting for the task when this is posted as a continuation.
+		task_mutex.lock();
 		p_task->low_priority_thread = native_thread_allocator.alloc();
 		p_task->low_priority_thread->start(_native_low_priority_thread_function, p_task); // Pask task directly to thread.
+		task_mutex.unlock();
+		return;
+	}
 
-	} else if (p_high_priority || low_priority_threads_used.get() < max_low_priority_threads) {
-		task_queue.add_last(&p_task->task_elem);
-		if (!p_high_priority) {
-			low_priority_threads_used.increment();
+	if (!p_high_priority) {
+		task_mutex.lock();
+		if (low_priority_threads_used.get() >= max_low_priority_threads) {
+			// Too many threads using low priority, must go to queue.
+			low_priority_task_queue.add_last(&p_task->task_elem);
+			task_mutex.unlock();
+			return;
 		}
-		task_mutex.unlock();
-		task_available_semaphore.post();
-	} else {
-		// Too many threads using low priority, must go to queue.
-		low_priority_task_queue.add_last(&p_task->task_elem);
+		low_priority_threads_used.increment();
 		task_mutex.unlock();
 	}
+
+	_push_task(p_task);
+	task_available_semaphore.post();
 }
 
 WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
 
-WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const TaskID *p_dependencies, uint32_t p_dependency_count) {
 	task_mutex.lock();
 	// Get a free task
 	Task *task = task_allocator.alloc();
@@ -200,10 +312,32 @@ WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable,
 	task->native_func_userdata = p_userdata;
 	task->description = p_description;
 	task->template_userdata = p_template_userdata;
+	task->low_priority = !p_high_priority;
+
+	// Hold an extra dependency while registering, so the task can't be posted before all of them are.
+	task->pending_dependencies.set(1);
+	for (uint32_t i = 0; i < p_dependency_count; i++) {
+		TaskID dependency_id = p_dependencies[i];
+		ERR_CONTINUE_MSG(groups.has(dependency_id), "Group ID used as a task dependency: " + itos(dependency_id));
+		Task **dependencyp = tasks.getptr(dependency_id);
+		if (!dependencyp) {
+			// It was already waited for, so it's completed.
+			ERR_CONTINUE_MSG(dependency_id <= 0 || dependency_id >= id, "Invalid dependency Task ID: " + itos(dependency_id));
+			continue;
+		}
+		if (!(*dependencyp)->completed) {
+			(*dependencyp)->dependents.push_back(task);
+			task->pending_dependencies.increment();
+		}
+	}
+
 	tasks.insert(id, task);
+	bool ready = task->pending_dependencies.decrement() == 0;
 	task_mutex.unlock();
 
-	_post_task(task, p_high_priority);
+	if (ready) {
+		_post_task(task, p_high_priority);
+	}
 
 	return id;
 }
@@ -212,6 +346,14 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_task(const Callable &p_action, bo
 	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description);
 }
 
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task_after(const Vector<TaskID> &p_dependencies, void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
+	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description, p_dependencies.ptr(), p_dependencies.size());
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_task_after(const Vector<TaskID> &p_dependencies, const Callable &p_action, bool p_high_priority, const String &p_description) {
+	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description, p_dependencies.ptr(), p_dependencies.size());
+}
+
 bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
 	task_mutex.lock();
 	const Task *const *taskp = tasks.getptr(p_task_id);
@@ -250,28 +392,19 @@ void WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 	task_mutex.unlock();
 
 	if (use_native_low_priority_threads && task->low_priority) {
-		task->low_priority_thread->wait_to_finish();
-		native_thread_allocator.free(task->low_priority_thread);
+		// Its thread is only started once the dependencies are completed, so wait for the task first.
+		task->done_semaphore.wait();
+		task_mutex.lock();
+		Thread *thread = task->low_priority_thread;
+		task_mutex.unlock();
+		thread->wait_to_finish();
+		task_mutex.lock();
+		native_thread_allocator.free(thread);
+		task_mutex.unlock();
+	} else if (current_thread_index >= 0) {
+		_wait_helping(task->done_semaphore);
 	} else {
-		int *index = thread_ids.getptr(Thread::get_caller_id());
-
-		if (index) {
-			// We are an actual process thread, we must not be blocked so continue processing stuff if available.
-			while (true) {
-				if (task->done_semaphore.try_wait()) {
-					// If done, exit
-					break;
-				}
-				if (task_available_semaphore.try_wait()) {
-					// Solve tasks while they are around.
-					_process_task_queue();
-					continue;
-				}
-				OS::get_singleton()->delay_usec(1); // Microsleep, this could be converted to waiting for multiple objects in supported platforms for a bit more performance.
-			}
-		} else {
-			task->done_semaphore.wait();
-		}
+		task->done_semaphore.wait();
 	}
 
 	task_mutex.lock();
@@ -305,15 +438,18 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 
 	} else {
 		group->tasks_used = p_tasks;
+		group->callable = p_callable;
+		group->native_group_func = p_func;
+		group->native_func_userdata = p_userdata;
+		group->template_userdata = p_template_userdata;
+		// Batches are kept small enough that every user, including the waiting thread, gets several of them to balance the load.
+		group->batch_size = CLAMP(uint32_t(p_elements) / ((p_tasks + 1) * 8), 1u, 64u);
 		tasks_posted = (Task **)alloca(sizeof(Task *) * p_tasks);
 		for (int i = 0; i < p_tasks; i++) {
 			Task *task = task_allocator.alloc();
-			task->native_group_func = p_func;
-			task->native_func_userdata = p_userdata;
 			task->description = p_description;
 			task->group = group;
-			task->callable = p_callable;
-			task->template_userdata = p_template_userdata;
+			task->low_priority = !p_high_priority;
 			tasks_posted[i] = task;
 			// No task ID is used.
 		}
@@ -370,26 +506,42 @@ bool WorkerThreadPool::is_group_task_completed(GroupID p_group) const {
 void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 	task_mutex.lock();
 	Group **groupp = groups.getptr(p_group);
-	task_mutex.unlock();
 	if (!groupp) {
+		task_mutex.unlock();
 		ERR_FAIL_MSG("Invalid Group ID");
 	}
 	Group *group = *groupp;
+	task_mutex.unlock();
 
 	if (group->low_priority_native_tasks.size() > 0) {
 		for (uint32_t i = 0; i < group->low_priority_native_tasks.size(); i++) {
 			group->low_priority_native_tasks[i]->low_priority_thread->wait_to_finish();
-			native_thread_allocator.free(group->low_priority_native_tasks[i]->low_priority_thread);
 			task_mutex.lock();
+			native_thread_allocator.free(group->low_priority_native_tasks[i]->low_priority_thread);
 			task_allocator.free(group->low_priority_native_tasks[i]);
 			task_mutex.unlock();
 		}
 
 		task_mutex.lock();
+		groups.erase(p_group);
 		group_allocator.free(group);
 		task_mutex.unlock();
 	} else {
-		group->done_semaphore.wait();
+		// Rather than just blocking, process elements until there are none left to claim.
+		if (_process_group_elements(group)) {
+			group->done_semaphore.post();
+			group->completed.set_to(true);
+		}
+
+		if (current_thread_index >= 0) {
+			_wait_helping(group->done_semaphore);
+		} else {
+			group->done_semaphore.wait();
+		}
+
+		task_mutex.lock();
+		groups.erase(p_group); // Erase before the group can be freed below.
+		task_mutex.unlock();
 
 		uint32_t max_users = group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
 		uint32_t finished_users = group->finished.increment(); // fetch happens before inc, so increment later.
@@ -401,8 +553,6 @@ void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 			task_mutex.unlock();
 		}
 	}
-
-	groups.erase(p_group); // Threads do not access this, so safe to erase here.
 }
 
 void WorkerThreadPool::init(int p_thread_count, bool p_use_native_threads_low_priority, float p_low_priority_task_ratio) {
@@ -423,8 +573,10 @@ void WorkerThreadPool::init(int p_thread_count, bool p_use_native_threads_low_pr
 
 	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].index = i;
+	}
+	// Threads steal from each other, so all of them must be set up before any starts.
+	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
-		thread_ids.insert(threads[i].thread.get_id(), i);
 	}
 }
 
@@ -456,6 +608,7 @@ void WorkerThreadPool::finish() {
 
 void WorkerThreadPool::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("add_task", "action", "high_priority", "description"), &WorkerThreadPool::add_task, DEFVAL(false), DEFVAL(String()));
+	ClassDB::bind_method(D_METHOD("add_task_after", "dependencies", "action", "high_priority", "description"), &WorkerThreadPool::add_task_after, DEFVAL(false), DEFVAL(String()));
 	ClassDB::bind_method(D_METHOD("is_task_completed", "task_id"), &WorkerThreadPool::is_task_completed);
 	ClassDB::bind_method(D_METHOD("wait_for_task_completion", "task_id"), &WorkerThreadPool::wait_for_task_completion);
 
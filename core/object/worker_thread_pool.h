@@ -68,13 +68,18 @@ private:
 		SafeFlag completed;
 		SafeNumeric<uint32_t> finished;
 		uint32_t tasks_used = 0;
+		uint32_t batch_size = 1;
 		TightLocalVector<Task *> low_priority_native_tasks;
+
+		Callable callable;
+		void (*native_group_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
 	};
 
 	struct Task {
 		Callable callable;
 		void (*native_func)(void *) = nullptr;
-		void (*native_group_func)(void *, uint32_t) = nullptr;
 		void *native_func_userdata = nullptr;
 		String description;
 		Semaphore done_semaphore;
@@ -85,6 +90,8 @@ private:
 		bool low_priority = false;
 		BaseTemplateUserdata *template_userdata = nullptr;
 		Thread *low_priority_thread = nullptr;
+		SafeNumeric<uint32_t> pending_dependencies; // Posted when it reaches zero.
+		LocalVector<Task *> dependents; // Protected by task_mutex, like completed.
 
 		void free_template_userdata();
 		Task() :
@@ -96,7 +103,7 @@ private:
 	PagedAllocator<Thread> native_thread_allocator;
 
 	SelfList<Task>::List low_priority_task_queue;
-	SelfList<Task>::List task_queue;
+	SelfList<Task>::List task_queue; // Tasks posted from outside the pool.
 
 	Mutex task_mutex;
 	Semaphore task_available_semaphore;
@@ -104,12 +111,18 @@ private:
 	struct ThreadData {
 		uint32_t index;
 		Thread thread;
+		// Tasks posted from this thread. It takes the newest ones while the
+		// other threads steal the oldest ones from the other end.
+		BinaryMutex queue_mutex;
+		SelfList<Task>::List queue;
+		SafeNumeric<uint32_t> queued;
 	};
 
 	TightLocalVector<ThreadData> threads;
 	SafeFlag exit_threads;
 
-	HashMap<Thread::ID, int> thread_ids;
+	static thread_local int current_thread_index;
+
 	HashMap<TaskID, Task *> tasks;
 	HashMap<GroupID, Group *> groups;
 
@@ -122,14 +135,18 @@ private:
 	static void _thread_function(void *p_user);
 	static void _native_low_priority_thread_function(void *p_user);
 
-	void _process_task_queue();
+	Task *_pop_task();
 	void _process_task(Task *task);
+	bool _process_group_elements(Group *p_group);
+	void _complete_task(Task *p_task);
+	void _wait_helping(Semaphore &p_semaphore);
 
+	void _push_task(Task *p_task);
 	void _post_task(Task *p_task, bool p_high_priority);
 
 	static WorkerThreadPool *singleton;
 
-	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description);
+	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const TaskID *p_dependencies = nullptr, uint32_t p_dependency_count = 0);
 	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
 
 	template <class C, class M, class U>
@@ -168,6 +185,19 @@ public:
 	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
 	TaskID add_task(const Callable &p_action, bool p_high_priority = false, const String &p_description = String());
 
+	// Tasks that only start once all their dependencies are completed.
+	template <class C, class M, class U>
+	TaskID add_template_task_after(const Vector<TaskID> &p_dependencies, C *p_instance, M p_method, U p_userdata, bool p_high_priority = false, const String &p_description = String()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task(Callable(), nullptr, nullptr, ud, p_high_priority, p_description, p_dependencies.ptr(), p_dependencies.size());
+	}
+	TaskID add_native_task_after(const Vector<TaskID> &p_dependencies, void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
+	TaskID add_task_after(const Vector<TaskID> &p_dependencies, const Callable &p_action, bool p_high_priority = false, const String &p_description = String());
+
 	bool is_task_completed(TaskID p_task_id) const;
 	void wait_for_task_completion(TaskID p_task_id);
 
@@ -187,6 +217,8 @@ public:
 	void wait_for_group_task_completion(GroupID p_group);
 
 	_FORCE_INLINE_ int get_thread_count() const { return threads.size(); }
+	// Index of the pool thread running the caller, or -1 from any other thread.
+	_FORCE_INLINE_ static int get_thread_index() { return current_thread_index; }
 
 	static WorkerThreadPool *get_singleton() { return singleton; }
 	void init(int p_thread_count = -1, bool p_use_native_threads_low_priority = true, float p_low_priority_task_ratio = 0.3);
@@ -0,0 +1,193 @@
+/*************************************************************************/
+/*  frame_arena.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "frame_arena.h"
+
+#include "core/variant/variant.h"
+
+#include <string.h>
+
+thread_local FrameArena::ThreadArena FrameArena::thread_arena;
+SafeNumeric<uint64_t> FrameArena::current_frame;
+
+void FrameArena::_begin_frame(ThreadArena &p_arena) {
+#ifdef DEBUG_ENABLED
+	if (p_arena.live_allocations > 0) {
+		WARN_PRINT_ONCE(vformat("%d frame arena allocations were not freed by the end of their frame. Containers using the frame arena must be destroyed within the frame.", p_arena.live_allocations));
+	}
+#endif
+	// Reset even if something leaked, a single leak must not keep the arena growing.
+	p_arena.live_allocations = 0;
+	p_arena.frame = current_frame.get();
+
+	if (!p_arena.blocks) {
+		return;
+	}
+
+#ifdef DEBUG_ENABLED
+	// Make reads of stale data stand out.
+	for (Block *block = p_arena.blocks; block; block = block->next) {
+		memset(_get_block_data(block), 0xCD, block->used);
+	}
+#endif
+
+	if (p_arena.blocks->next) {
+		// The last frame needed several blocks, replace them with one large enough for all of it.
+		size_t capacity = p_arena.capacity;
+		_free_blocks(p_arena);
+		_add_block(p_arena, capacity);
+	} else {
+		p_arena.blocks->used = 0;
+	}
+}
+
+FrameArena::Block *FrameArena::_add_block(ThreadArena &p_arena, size_t p_size) {
+	// Grow geometrically, so a thread needs few blocks even before its first reset.
+	size_t capacity = MAX(MAX(size_t(MIN_BLOCK_SIZE), p_size), p_arena.capacity);
+	Block *block = (Block *)memalloc(BLOCK_HEADER_SIZE + capacity);
+	CRASH_COND_MSG(!block, "Out of memory");
+	block->next = p_arena.blocks;
+	block->capacity = capacity;
+	block->used = 0;
+	p_arena.blocks = block;
+	p_arena.capacity += capacity;
+	return block;
+}
+
+void FrameArena::_free_blocks(ThreadArena &p_arena) {
+	while (p_arena.blocks) {
+		Block *block = p_arena.blocks;
+		p_arena.blocks = block->next;
+		memfree(block);
+	}
+	p_arena.capacity = 0;
+}
+
+void *FrameArena::alloc(size_t p_size) {
+	ThreadArena &arena = thread_arena;
+	if (unlikely(arena.frame != current_frame.get())) {
+		_begin_frame(arena);
+	}
+
+	size_t size = _get_allocation_size(p_size);
+	Block *block = arena.blocks;
+	if (unlikely(!block || block->used + size > block->capacity)) {
+		block = _add_block(arena, size);
+	}
+
+	Header *header = (Header *)(_get_block_data(block) + block->used);
+	block->used += size;
+	header->arena = &arena;
+	header->size = p_size;
+	header->frame = arena.frame;
+	arena.live_allocations++;
+
+	return header + 1;
+}
+
+void *FrameArena::realloc(void *p_ptr, size_t p_size) {
+	if (!p_ptr) {
+		return alloc(p_size);
+	}
+	if (p_size == 0) {
+		free(p_ptr);
+		return nullptr;
+	}
+
+	ThreadArena &arena = thread_arena;
+	Header *header = (Header *)p_ptr - 1;
+	ERR_FAIL_COND_V_MSG(header->arena != &arena, nullptr, "Reallocating frame arena memory which wasn't allocated by this thread, or after the end of its frame.");
+	size_t old_size = _get_allocation_size(header->size);
+	size_t size = _get_allocation_size(p_size);
+
+	// The last allocation of the current block can be resized in place.
+	Block *block = arena.blocks;
+	if (block && header->frame == arena.frame && (uint8_t *)header + old_size == _get_block_data(block) + block->used && block->used - old_size + size <= block->capacity) {
+		block->used = block->used - old_size + size;
+		header->size = p_size;
+		return p_ptr;
+	}
+
+	void *mem = alloc(p_size);
+	memcpy(mem, p_ptr, MIN(header->size, uint64_t(p_size)));
+	free(p_ptr);
+	return mem;
+}
+
+void FrameArena::free(void *p_ptr) {
+	ERR_FAIL_COND(p_ptr == nullptr);
+
+	ThreadArena &arena = thread_arena;
+	Header *header = (Header *)p_ptr - 1;
+	// The arena is per thread, memory must be freed by the thread that allocated it.
+	ERR_FAIL_COND_MSG(header->arena != &arena, "Freeing frame arena memory which wasn't allocated by this thread, or after the end of its frame.");
+	if (header->frame != arena.frame) {
+		// The arena was reset since, this memory is already reclaimed.
+#ifdef DEBUG_ENABLED
+		WARN_PRINT_ONCE("Freeing frame arena memory after the end of the frame it was allocated in.");
+#endif
+		return;
+	}
+	ERR_FAIL_COND(arena.live_allocations == 0);
+
+	// Freeing the last allocation makes its memory available again right away.
+	Block *block = arena.blocks;
+	size_t size = _get_allocation_size(header->size);
+	if (block && (uint8_t *)header + size == _get_block_data(block) + block->used) {
+		block->used -= size;
+	}
+
+	arena.live_allocations--;
+}
+
+void FrameArena::end_frame() {
+	current_frame.increment();
+
+	// Other threads are reset lazily, the next time they allocate.
+	ThreadArena &arena = thread_arena;
+	if (arena.frame != current_frame.get()) {
+		_begin_frame(arena);
+	}
+}
+
+uint64_t FrameArena::get_frame() {
+	return current_frame.get();
+}
+
+void FrameArena::thread_exit() {
+	ThreadArena &arena = thread_arena;
+#ifdef DEBUG_ENABLED
+	if (arena.live_allocations > 0) {
+		ERR_PRINT(vformat("%d frame arena allocations were not freed before their thread exited.", arena.live_allocations));
+	}
+#endif
+	_free_blocks(arena);
+	arena.live_allocations = 0;
+}
@@ -0,0 +1,121 @@
+/*************************************************************************/
+/*  frame_arena.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "core/os/memory.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Per-thread bump allocator for data that only lives during the current frame.
+// Freeing is cheap and memory is reclaimed all at once: a thread's arena is reset the first time it's used
+// after the frame ends. Data must not outlive its frame, its memory is reused once the frame ends. Leaks are
+// reported in debug builds.
+class FrameArena {
+	struct Block {
+		Block *next = nullptr;
+		size_t capacity = 0;
+		size_t used = 0;
+	};
+
+	struct ThreadArena;
+
+	// Each allocation starts with the arena that owns it, its size and the frame it was allocated in.
+	struct Header {
+		ThreadArena *arena;
+		uint64_t size;
+		uint64_t frame;
+		uint64_t padding; // Keeps allocations 16 bytes aligned.
+	};
+	static_assert(sizeof(Header) % 16 == 0, "FrameArena allocations must stay 16 bytes aligned.");
+
+	struct ThreadArena {
+		Block *blocks = nullptr; // Newest first, allocations come from the first one.
+		size_t capacity = 0;
+		uint64_t frame = 0; // Frame of the last reset.
+		uint32_t live_allocations = 0; // Allocated since the last reset and not freed yet.
+	};
+
+	enum {
+		BLOCK_HEADER_SIZE = (sizeof(Block) + 15) & ~15,
+		MIN_BLOCK_SIZE = 64 * 1024,
+	};
+
+	static thread_local ThreadArena thread_arena;
+	static SafeNumeric<uint64_t> current_frame;
+
+	_FORCE_INLINE_ static uint8_t *_get_block_data(Block *p_block) { return (uint8_t *)p_block + BLOCK_HEADER_SIZE; }
+	_FORCE_INLINE_ static size_t _get_allocation_size(size_t p_size) { return sizeof(Header) + ((p_size + 15) & ~size_t(15)); }
+
+	static void _begin_frame(ThreadArena &p_arena);
+	static Block *_add_block(ThreadArena &p_arena, size_t p_size);
+	static void _free_blocks(ThreadArena &p_arena);
+
+public:
+	static void *alloc(size_t p_size);
+	static void *realloc(void *p_ptr, size_t p_size);
+	static void free(void *p_ptr);
+
+	// Called by Main::iteration when the frame ends.
+	static void end_frame();
+	static uint64_t get_frame();
+
+	// Frees the memory of the calling thread's arena, called when a thread exits.
+	static void thread_exit();
+};
+
+class FrameArenaAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return FrameArena::alloc(p_memory); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return FrameArena::realloc(p_ptr, p_memory); }
+	_FORCE_INLINE_ static void free(void *p_ptr) { FrameArena::free(p_ptr); }
+};
+
+template <class T>
+class FrameArenaTypedAllocator {
+public:
+	template <class... Args>
+	_FORCE_INLINE_ T *new_allocation(const Args &&...p_args) { return memnew_placement(FrameArena::alloc(sizeof(T)), T(p_args...)); }
+	_FORCE_INLINE_ void delete_allocation(T *p_allocation) {
+		p_allocation->~T();
+		FrameArena::free(p_allocation);
+	}
+};
+
+// Containers which must be destroyed before the end of the frame.
+// The buckets of FrameHashMap are still allocated from the heap, only its elements come from the arena.
+template <class T, class U = uint32_t, bool force_trivial = false>
+using FrameLocalVector = LocalVector<T, U, force_trivial, false, FrameArenaAllocator>;
+
+template <class TKey, class TValue, class Hasher = HashMapHasherDefault, class Comparator = HashMapComparatorDefault<TKey>>
+using FrameHashMap = HashMap<TKey, TValue, Hasher, Comparator, FrameArenaTypedAllocator<HashMapElement<TKey, TValue>>>;
+
+#endif // FRAME_ARENA_H
@@ -33,6 +33,10 @@
 #include "core/error/error_macros.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef BUILTIN_ALLOCATOR_ENABLED
+#include "core/os/thread_cache_allocator.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -65,14 +69,41 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
-void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
-	bool prepad = true;
+// The built-in allocator needs the size to free a block, so the padding that stores it is always used.
+#if defined(DEBUG_ENABLED) || defined(BUILTIN_ALLOCATOR_ENABLED)
+#define MEMORY_PREPAD(m_pad_align) true
+#else
+#define MEMORY_PREPAD(m_pad_align) m_pad_align
+#endif
+
+static _FORCE_INLINE_ void *_memory_alloc(size_t p_size) {
+#ifdef BUILTIN_ALLOCATOR_ENABLED
+	return ThreadCacheAllocator::alloc(p_size);
 #else
-	bool prepad = p_pad_align;
+	return malloc(p_size);
 #endif
+}
 
-	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+static _FORCE_INLINE_ void *_memory_realloc(void *p_ptr, size_t p_old_size, size_t p_size) {
+#ifdef BUILTIN_ALLOCATOR_ENABLED
+	return ThreadCacheAllocator::realloc(p_ptr, p_old_size, p_size);
+#else
+	return realloc(p_ptr, p_size);
+#endif
+}
+
+static _FORCE_INLINE_ void _memory_free(void *p_ptr, size_t p_size) {
+#ifdef BUILTIN_ALLOCATOR_ENABLED
+	ThreadCacheAllocator::free(p_ptr, p_size);
+#else
+	free(p_ptr);
+#endif
+}
+
+void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+	bool prepad = MEMORY_PREPAD(p_pad_align);
+
+	void *mem = _memory_alloc(p_bytes + (prepad ? PAD_ALIGN : 0));
 
 	ERR_FAIL_COND_V(!mem, nullptr);
 
@@ -101,11 +132,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
-	bool prepad = true;
-#else
-	bool prepad = p_pad_align;
-#endif
+	bool prepad = MEMORY_PREPAD(p_pad_align);
 
 	if (prepad) {
 		mem -= PAD_ALIGN;
@@ -121,12 +148,13 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			_memory_free(mem, *s + PAD_ALIGN);
 			return nullptr;
 		} else {
+			size_t old_size = *s + PAD_ALIGN;
 			*s = p_bytes;
 
-			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+			mem = (uint8_t *)_memory_realloc(mem, old_size, p_bytes + PAD_ALIGN);
 			ERR_FAIL_COND_V(!mem, nullptr);
 
 			s = (uint64_t *)mem;
@@ -149,23 +177,19 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
-	bool prepad = true;
-#else
-	bool prepad = p_pad_align;
-#endif
+	bool prepad = MEMORY_PREPAD(p_pad_align);
 
 	alloc_count.decrement();
 
 	if (prepad) {
 		mem -= PAD_ALIGN;
+		uint64_t *s = (uint64_t *)mem;
 
 #ifdef DEBUG_ENABLED
-		uint64_t *s = (uint64_t *)mem;
 		mem_usage.sub(*s);
 #endif
 
-		free(mem);
+		_memory_free(mem, *s + PAD_ALIGN);
 	} else {
 		free(mem);
 	}
@@ -33,7 +33,11 @@
 
 #include "thread.h"
 
+#include "core/object/message_queue.h"
+#include "core/object/object.h"
 #include "core/object/script_language.h"
+#include "core/os/frame_arena.h"
+#include "core/os/thread_cache_allocator.h"
 
 #if !defined(NO_THREADS)
 
@@ -74,9 +78,13 @@ void Thread::callback(Thread *p_self, const Settings &p_settings, Callback p_cal
 	ScriptServer::thread_enter(); //scripts may need to attach a stack
 	p_callback(p_userdata);
 	ScriptServer::thread_exit();
+	MessageQueue::thread_exit();
+	ObjectDB::thread_exit();
+	FrameArena::thread_exit();
 	if (term_func) {
 		term_func();
 	}
+	ThreadCacheAllocator::thread_exit(); // Last, anything freed before ends up in the cache.
 }
 
 void Thread::start(Thread::Callback p_callback, void *p_user, const Settings &p_settings) {
@@ -0,0 +1,173 @@
+/*************************************************************************/
+/*  thread_cache_allocator.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "thread_cache_allocator.h"
+
+#include "core/error/error_macros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+thread_local ThreadCacheAllocator::ThreadCache ThreadCacheAllocator::thread_cache;
+ThreadCacheAllocator::SizeClass ThreadCacheAllocator::size_classes[SIZE_CLASS_COUNT];
+SpinLock ThreadCacheAllocator::span_lock;
+uint32_t ThreadCacheAllocator::span_count = 0;
+
+void *ThreadCacheAllocator::_refill(uint32_t p_class) {
+	ThreadCache &cache = thread_cache;
+	SizeClass &size_class = size_classes[p_class];
+	uint32_t batch_size = _get_batch_size(p_class);
+
+	size_class.lock.lock();
+	FreeBlock *blocks = size_class.blocks;
+	uint32_t count = 0;
+	FreeBlock *last = nullptr;
+	for (FreeBlock *block = blocks; block && count < batch_size; block = block->next) {
+		last = block;
+		count++;
+	}
+	if (last) {
+		size_class.blocks = last->next;
+		size_class.count -= count;
+		last->next = nullptr;
+	}
+	size_class.lock.unlock();
+
+	if (!blocks) {
+		// Carve a new span, all its blocks go to this thread.
+		uint8_t *span = (uint8_t *)::malloc(SPAN_SIZE);
+		ERR_FAIL_COND_V(!span, nullptr);
+
+		span_lock.lock();
+		span_count++;
+		span_lock.unlock();
+
+		uint32_t class_size = _get_class_size(p_class);
+		count = SPAN_SIZE / class_size;
+		blocks = (FreeBlock *)span;
+		for (uint32_t i = 0; i < count - 1; i++) {
+			((FreeBlock *)(span + i * class_size))->next = (FreeBlock *)(span + (i + 1) * class_size);
+		}
+		((FreeBlock *)(span + (count - 1) * class_size))->next = nullptr;
+	}
+
+	cache.blocks[p_class] = blocks->next;
+	cache.counts[p_class] = count - 1;
+	return blocks;
+}
+
+void ThreadCacheAllocator::_release(uint32_t p_class, uint32_t p_count) {
+	ThreadCache &cache = thread_cache;
+
+	// Detach the chain before locking, so the lock is only held to link it.
+	FreeBlock *first = cache.blocks[p_class];
+	FreeBlock *last = first;
+	for (uint32_t i = 1; i < p_count; i++) {
+		last = last->next;
+	}
+	cache.blocks[p_class] = last->next;
+	cache.counts[p_class] -= p_count;
+
+	SizeClass &size_class = size_classes[p_class];
+	size_class.lock.lock();
+	last->next = size_class.blocks;
+	size_class.blocks = first;
+	size_class.count += p_count;
+	size_class.lock.unlock();
+}
+
+void *ThreadCacheAllocator::alloc(size_t p_size) {
+	if (p_size > MAX_SMALL_SIZE) {
+		return ::malloc(p_size);
+	}
+
+	uint32_t size_class = _get_size_class(p_size);
+	ThreadCache &cache = thread_cache;
+	FreeBlock *block = cache.blocks[size_class];
+	if (unlikely(!block)) {
+		return _refill(size_class);
+	}
+	cache.blocks[size_class] = block->next;
+	cache.counts[size_class]--;
+	return block;
+}
+
+void *ThreadCacheAllocator::realloc(void *p_ptr, size_t p_old_size, size_t p_size) {
+	if (p_old_size > MAX_SMALL_SIZE && p_size > MAX_SMALL_SIZE) {
+		return ::realloc(p_ptr, p_size);
+	}
+	if (p_old_size <= MAX_SMALL_SIZE && p_size <= MAX_SMALL_SIZE && _get_size_class(p_old_size) == _get_size_class(p_size)) {
+		return p_ptr;
+	}
+
+	void *mem = alloc(p_size);
+	ERR_FAIL_COND_V(!mem, nullptr);
+	memcpy(mem, p_ptr, MIN(p_old_size, p_size));
+	free(p_ptr, p_old_size);
+	return mem;
+}
+
+void ThreadCacheAllocator::free(void *p_ptr, size_t p_size) {
+	if (p_size > MAX_SMALL_SIZE) {
+		::free(p_ptr);
+		return;
+	}
+
+	uint32_t size_class = _get_size_class(p_size);
+	ThreadCache &cache = thread_cache;
+
+	// Keep up to two batches, so alternating allocations and frees don't move blocks back and forth.
+	uint32_t batch_size = _get_batch_size(size_class);
+	if (unlikely(cache.counts[size_class] >= batch_size * 2)) {
+		_release(size_class, batch_size);
+	}
+
+	// The block freed last is allocated first, while it's still in the CPU cache.
+	FreeBlock *block = (FreeBlock *)p_ptr;
+	block->next = cache.blocks[size_class];
+	cache.blocks[size_class] = block;
+	cache.counts[size_class]++;
+}
+
+void ThreadCacheAllocator::thread_exit() {
+	ThreadCache &cache = thread_cache;
+	for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+		if (cache.counts[i] > 0) {
+			_release(i, cache.counts[i]);
+		}
+	}
+}
+
+uint32_t ThreadCacheAllocator::get_span_count() {
+	span_lock.lock();
+	uint32_t count = span_count;
+	span_lock.unlock();
+	return count;
+}
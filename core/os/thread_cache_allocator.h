@@ -0,0 +1,102 @@
+/*************************************************************************/
+/*  thread_cache_allocator.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef THREAD_CACHE_ALLOCATOR_H
+#define THREAD_CACHE_ALLOCATOR_H
+
+#include "core/os/spin_lock.h"
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Allocator for small blocks, with a cache of free blocks per size class in every thread.
+// Threads only lock a size class to move a batch of blocks between their cache and the shared free list.
+// Blocks are carved from spans which are never given back to the system, larger sizes go to malloc.
+// Freeing needs the size that was allocated, Memory keeps it in its padding when it uses this allocator.
+class ThreadCacheAllocator {
+public:
+	enum {
+		MAX_SMALL_SIZE = 1024,
+		SIZE_CLASS_COUNT = 28,
+		SPAN_SIZE = 64 * 1024,
+	};
+
+private:
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	struct ThreadCache {
+		FreeBlock *blocks[SIZE_CLASS_COUNT];
+		uint32_t counts[SIZE_CLASS_COUNT];
+	};
+
+	struct SizeClass {
+		SpinLock lock;
+		FreeBlock *blocks = nullptr;
+		uint32_t count = 0;
+	};
+
+	static thread_local ThreadCache thread_cache;
+	static SizeClass size_classes[SIZE_CLASS_COUNT];
+	static SpinLock span_lock;
+	static uint32_t span_count;
+
+	// Sizes go up in steps of 16 bytes up to 256, then in steps of 64.
+	_FORCE_INLINE_ static uint32_t _get_size_class(size_t p_size) {
+		if (p_size <= 256) {
+			return p_size <= 16 ? 0 : uint32_t((p_size + 15) >> 4) - 1;
+		}
+		return 16 + uint32_t((p_size - 256 + 63) >> 6) - 1;
+	}
+
+	_FORCE_INLINE_ static uint32_t _get_class_size(uint32_t p_class) {
+		return p_class < 16 ? (p_class + 1) << 4 : 256 + ((p_class - 15) << 6);
+	}
+
+	_FORCE_INLINE_ static uint32_t _get_batch_size(uint32_t p_class) {
+		return CLAMP(16384 / _get_class_size(p_class), 8u, 128u);
+	}
+
+	static void *_refill(uint32_t p_class);
+	static void _release(uint32_t p_class, uint32_t p_count);
+
+public:
+	static void *alloc(size_t p_size);
+	static void *realloc(void *p_ptr, size_t p_old_size, size_t p_size);
+	static void free(void *p_ptr, size_t p_size);
+
+	// Gives the blocks cached by the calling thread back to the shared free lists, called when a thread exits.
+	static void thread_exit();
+
+	static uint32_t get_span_count();
+};
+
+#endif // THREAD_CACHE_ALLOCATOR_H
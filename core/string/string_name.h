@@ -48,7 +48,10 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_MASK = STRING_TABLE_SHARDS - 1
 	};
 
 	struct _Data {
@@ -62,12 +65,27 @@ class StringName {
 		String get_name() const { return cname ? String(cname) : name; }
 		int idx = 0;
 		uint32_t hash = 0;
-		_Data *prev = nullptr;
-		_Data *next = nullptr;
+		_Data *prev = nullptr; // Only used with the shard locked, links the retired list once removed.
+		std::atomic<_Data *> next = { nullptr };
 		_Data() {}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	// Buckets are read without locking. Adding and removing names locks the shard the bucket belongs to.
+	// Removed names are only freed once no reader is in the shard, until then they're kept in the retired list.
+	struct Shard {
+		Mutex mutex;
+		std::atomic<uint32_t> readers = { 0 };
+		_Data *retired = nullptr;
+	};
+
+	static std::atomic<_Data *> _table[STRING_TABLE_LEN];
+	static Shard shards[STRING_TABLE_SHARDS];
+
+	template <typename T>
+	static _Data *_find(uint32_t p_hash, const T &p_name);
+	template <typename T>
+	static _Data *_find_or_add(uint32_t p_hash, const T &p_name, const char *p_cname, bool p_static);
+	static void _free_retired(Shard &p_shard);
 
 	_Data *_data = nullptr;
 
@@ -80,7 +98,6 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
 	static void setup();
 	static void cleanup();
 	static bool configured;
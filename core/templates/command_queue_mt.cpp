@@ -30,53 +30,58 @@
 
 #include "command_queue_mt.h"
 
-#include "core/config/project_settings.h"
-#include "core/os/os.h"
-
-void CommandQueueMT::lock() {
-	mutex.lock();
-}
+CommandQueueMT::CommandPage *CommandQueueMT::_alloc_page() {
+	free_pages_lock.lock();
+	CommandPage *page = free_pages;
+	if (page) {
+		free_pages = page->next.load(std::memory_order_relaxed);
+	}
+	free_pages_lock.unlock();
 
-void CommandQueueMT::unlock() {
-	mutex.unlock();
+	if (page) {
+		page->next.store(nullptr, std::memory_order_relaxed);
+		page->committed.store(0, std::memory_order_relaxed);
+	} else {
+		page = memnew(CommandPage);
+	}
+	return page;
 }
 
-void CommandQueueMT::wait_for_flush() {
-	// wait one millisecond for a flush to happen
-	OS::get_singleton()->delay_usec(1000);
+void CommandQueueMT::_free_page(CommandPage *p_page) {
+	free_pages_lock.lock();
+	p_page->next.store(free_pages, std::memory_order_relaxed);
+	free_pages = p_page;
+	free_pages_lock.unlock();
 }
 
-CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
-	int idx = -1;
-
-	while (true) {
-		lock();
-		for (int i = 0; i < SYNC_SEMAPHORES; i++) {
-			if (!sync_sems[i].in_use) {
-				sync_sems[i].in_use = true;
-				idx = i;
-				break;
-			}
-		}
-		unlock();
-
-		if (idx == -1) {
-			wait_for_flush();
-		} else {
-			break;
-		}
-	}
-
-	return &sync_sems[idx];
+Semaphore *CommandQueueMT::_get_sync_semaphore() {
+	// A thread waits for one command at a time, so one semaphore per thread is enough.
+	static thread_local Semaphore sync_semaphore;
+	return &sync_semaphore;
 }
 
 CommandQueueMT::CommandQueueMT(bool p_sync) {
+	write_page = memnew(CommandPage);
+	read_page = write_page;
+
 	if (p_sync) {
 		sync = memnew(Semaphore);
 	}
 }
 
 CommandQueueMT::~CommandQueueMT() {
+	CommandPage *page = read_page;
+	while (page) {
+		CommandPage *next = page->next.load(std::memory_order_relaxed);
+		memdelete(page);
+		page = next;
+	}
+	while (free_pages) {
+		CommandPage *next = free_pages->next.load(std::memory_order_relaxed);
+		memdelete(free_pages);
+		free_pages = next;
+	}
+
 	if (sync) {
 		memdelete(sync);
 	}
@@ -34,11 +34,13 @@
 #include "core/os/memory.h"
 #include "core/os/mutex.h"
 #include "core/os/semaphore.h"
+#include "core/os/spin_lock.h"
 #include "core/string/print_string.h"
-#include "core/templates/local_vector.h"
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -255,8 +257,7 @@
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
 		unlock();                                                            \
-		if (sync)                                                            \
-			sync->post();                                                    \
+		_post_sync();                                                        \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -264,7 +265,7 @@
 #define DECL_PUSH_AND_RET(N)                                                                   \
 	template <class T, class M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) class R>                \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
-		SyncSemaphore *ss = _alloc_sync_sem();                                                 \
+		Semaphore *ss = _get_sync_semaphore();                                                 \
 		CMD_RET_TYPE(N) *cmd = allocate_and_lock<CMD_RET_TYPE(N)>();                           \
 		cmd->instance = p_instance;                                                            \
 		cmd->method = p_method;                                                                \
@@ -272,10 +273,8 @@
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
 		unlock();                                                                              \
-		if (sync)                                                                              \
-			sync->post();                                                                      \
-		ss->sem.wait();                                                                        \
-		ss->in_use = false;                                                                    \
+		_post_sync();                                                                          \
+		ss->wait();                                                                            \
 	}
 
 #define CMD_SYNC_TYPE(N) CommandSync##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
@@ -283,27 +282,28 @@
 #define DECL_PUSH_AND_SYNC(N)                                                         \
 	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>                \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
-		SyncSemaphore *ss = _alloc_sync_sem();                                        \
+		Semaphore *ss = _get_sync_semaphore();                                        \
 		CMD_SYNC_TYPE(N) *cmd = allocate_and_lock<CMD_SYNC_TYPE(N)>();                \
 		cmd->instance = p_instance;                                                   \
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
 		unlock();                                                                     \
-		if (sync)                                                                     \
-			sync->post();                                                             \
-		ss->sem.wait();                                                               \
-		ss->in_use = false;                                                           \
+		_post_sync();                                                                 \
+		ss->wait();                                                                   \
 	}
 
 #define MAX_CMD_PARAMS 15
 
+// Commands are written to a chain of pages, which works as a ring growing on
+// demand: the thread flushing the queue gives fully read pages back to be
+// written again, and a new page is only allocated when none is free.
+//
+// Reading never locks. Pushing only takes a spin lock, which is uncontended
+// unless several threads push at once (e.g. the main thread and a resource
+// loading thread), so the pushing thread never waits for commands being
+// executed. A command is published to the reader when the lock is released.
 class CommandQueueMT {
-	struct SyncSemaphore {
-		Semaphore sem;
-		bool in_use = false;
-	};
-
 	struct CommandBase {
 		virtual void call() = 0;
 		virtual void post() {}
@@ -311,10 +311,10 @@ class CommandQueueMT {
 	};
 
 	struct SyncCommand : public CommandBase {
-		SyncSemaphore *sync_sem = nullptr;
+		Semaphore *sync_sem = nullptr;
 
 		virtual void post() override {
-			sync_sem->sem.post();
+			sync_sem->post();
 		}
 	};
 
@@ -332,23 +332,53 @@ class CommandQueueMT {
 	/***** BASE *******/
 
 	enum {
-		DEFAULT_COMMAND_MEM_SIZE_KB = 256,
-		SYNC_SEMAPHORES = 8
+		COMMAND_PAGE_SIZE_KB = 64,
+		COMMAND_HEADER_SIZE = 8,
 	};
 
-	LocalVector<uint8_t> command_mem;
-	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
-	Mutex mutex;
+	struct CommandPage {
+		std::atomic<uint32_t> committed = { 0 }; // Bytes the reader can execute.
+		std::atomic<CommandPage *> next = { nullptr };
+		alignas(8) uint8_t data[COMMAND_PAGE_SIZE_KB * 1024];
+	};
+
+	// Written only while holding write_lock.
+	SpinLock write_lock;
+	CommandPage *write_page = nullptr;
+	uint32_t write_pos = 0;
+
+	// Only touched by the thread flushing.
+	Mutex flush_mutex;
+	CommandPage *read_page = nullptr;
+	uint32_t read_pos = 0;
+	bool flushing = false;
+
+	SpinLock free_pages_lock;
+	CommandPage *free_pages = nullptr;
+
+	// Counts the commands pushed, without touching the semaphore unless the reader sleeps.
 	Semaphore *sync = nullptr;
+	std::atomic<int64_t> sync_count = { 0 };
+
+	CommandPage *_alloc_page();
+	void _free_page(CommandPage *p_page);
 
 	template <class T>
 	T *allocate() {
 		// alloc size is size+T+safeguard
+		static_assert(sizeof(T) + COMMAND_HEADER_SIZE <= COMMAND_PAGE_SIZE_KB * 1024, "Command is too large for a command page.");
 		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1));
-		uint64_t size = command_mem.size();
-		command_mem.resize(size + alloc_size + 8);
-		*(uint64_t *)&command_mem[size] = alloc_size;
-		T *cmd = memnew_placement(&command_mem[size + 8], T);
+		if (unlikely(write_pos + COMMAND_HEADER_SIZE + alloc_size > COMMAND_PAGE_SIZE_KB * 1024)) {
+			// Everything written to the current page is committed already,
+			// so the reader will have read all of it before following the link.
+			CommandPage *page = _alloc_page();
+			write_page->next.store(page, std::memory_order_release);
+			write_page = page;
+			write_pos = 0;
+		}
+		*(uint64_t *)&write_page->data[write_pos] = alloc_size;
+		T *cmd = memnew_placement(&write_page->data[write_pos + COMMAND_HEADER_SIZE], T);
+		write_pos += COMMAND_HEADER_SIZE + alloc_size;
 		return cmd;
 	}
 
@@ -359,32 +389,59 @@ class CommandQueueMT {
 		return ret;
 	}
 
-	void _flush() {
-		lock();
-
-		uint64_t read_ptr = 0;
-		uint64_t limit = command_mem.size();
-
-		while (read_ptr < limit) {
-			uint64_t size = *(uint64_t *)&command_mem[read_ptr];
-			read_ptr += 8;
-			CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[read_ptr]);
-
-			cmd->call(); //execute the function
-			cmd->post(); //release in case it needs sync/ret
-			cmd->~CommandBase(); //should be done, so erase the command
+	_FORCE_INLINE_ bool _has_pending() const {
+		return read_pos < read_page->committed.load(std::memory_order_acquire) || read_page->next.load(std::memory_order_acquire) != nullptr;
+	}
 
-			read_ptr += size;
+	void _flush() {
+		MutexLock flush_lock(flush_mutex);
+		if (flushing) {
+			return; // A command being executed flushed again.
+		}
+		flushing = true;
+
+		while (true) {
+			if (read_pos < read_page->committed.load(std::memory_order_acquire)) {
+				uint64_t size = *(uint64_t *)&read_page->data[read_pos];
+				CommandBase *cmd = reinterpret_cast<CommandBase *>(&read_page->data[read_pos + COMMAND_HEADER_SIZE]);
+
+				cmd->call(); //execute the function
+				cmd->post(); //release in case it needs sync/ret
+				cmd->~CommandBase(); //should be done, so erase the command
+
+				read_pos += COMMAND_HEADER_SIZE + size;
+				continue;
+			}
+
+			CommandPage *next = read_page->next.load(std::memory_order_acquire);
+			if (next == nullptr) {
+				break;
+			}
+			if (read_pos < read_page->committed.load(std::memory_order_acquire)) {
+				continue; // Committed right before the page was linked.
+			}
+			CommandPage *page = read_page;
+			read_page = next;
+			read_pos = 0;
+			_free_page(page);
 		}
 
-		command_mem.clear();
-		unlock();
+		flushing = false;
 	}
 
-	void lock();
-	void unlock();
-	void wait_for_flush();
-	SyncSemaphore *_alloc_sync_sem();
+	_FORCE_INLINE_ void lock() {
+		write_lock.lock();
+	}
+	_FORCE_INLINE_ void unlock() {
+		write_page->committed.store(write_pos, std::memory_order_release);
+		write_lock.unlock();
+	}
+	_FORCE_INLINE_ void _post_sync() {
+		if (sync && sync_count.fetch_add(1, std::memory_order_release) < 0) {
+			sync->post();
+		}
+	}
+	static Semaphore *_get_sync_semaphore();
 
 public:
 	/* NORMAL PUSH COMMANDS */
@@ -400,7 +457,7 @@ public:
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 15)
 
 	_FORCE_INLINE_ void flush_if_pending() {
-		if (unlikely(command_mem.size() > 0)) {
+		if (unlikely(_has_pending())) {
 			_flush();
 		}
 	}
@@ -410,7 +467,9 @@ public:
 
 	void wait_and_flush() {
 		ERR_FAIL_COND(!sync);
-		sync->wait();
+		if (sync_count.fetch_sub(1, std::memory_order_acquire) <= 0) {
+			sync->wait();
+		}
 		_flush();
 	}
 
@@ -0,0 +1,534 @@
+/*************************************************************************/
+/*  compact_hash_map.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef COMPACT_HASH_MAP_H
+#define COMPACT_HASH_MAP_H
+
+#include "core/os/memory.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/pair.h"
+
+#if defined(__GNUC__)
+#define COMPACT_HASH_MAP_CLZ32(x) __builtin_clz(x)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+static _FORCE_INLINE_ int __compact_hash_map_clz32(uint32_t x) {
+	unsigned long index;
+	_BitScanReverse(&index, x);
+	return 31 - index;
+}
+#define COMPACT_HASH_MAP_CLZ32(x) __compact_hash_map_clz32(x)
+#endif
+
+/**
+ * An insertion-ordered hash map with the same API as HashMap, but stored
+ * compactly:
+ *
+ * - Elements live in a dense array, in insertion order, so iterating is a
+ *   linear walk over memory and no allocation happens per element.
+ * - A separate open-addressing index table (linear probing, at most half full)
+ *   maps hashes to positions in that array. Each slot is 8 bytes and keeps the
+ *   hash, so most failed comparisons don't touch the elements at all.
+ *
+ * The dense array is made of pages of doubling size, so elements never move
+ * when the map grows: pointers to keys and values stay valid across inserts,
+ * like in HashMap. Erasing leaves a hole that iteration skips. Once holes
+ * outnumber the elements, the remaining elements are compacted, which moves
+ * them; pointers to elements are only guaranteed to survive inserts.
+ *
+ * Erasing the last inserted element never leaves a hole, and accessing an
+ * element by its position in the insertion order is constant time as long as
+ * nothing else was erased.
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class CompactHashMap {
+public:
+	static constexpr uint32_t MIN_CAPACITY = 8; // Index slots, must be a power of 2.
+	static constexpr uint32_t EMPTY_HASH = 0;
+
+private:
+	static constexpr uint32_t FIRST_PAGE_SHIFT = 3; // The first two pages hold 8 elements each.
+
+	typedef KeyValue<TKey, TValue> Element;
+
+	struct Slot {
+		uint32_t hash;
+		uint32_t index;
+	};
+
+	LocalVector<KeyValue<TKey, TValue> *> pages;
+	LocalVector<uint32_t> hashes; // One per position in the dense array, EMPTY_HASH for holes.
+	Slot *slots = nullptr;
+	uint32_t capacity = 0; // Index slots, a power of 2.
+	uint32_t num_elements = 0;
+
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
+		uint32_t hash = Hasher::hash(p_key);
+
+		if (unlikely(hash == EMPTY_HASH)) {
+			hash = EMPTY_HASH + 1;
+		}
+
+		return hash;
+	}
+
+	_FORCE_INLINE_ uint32_t _home_slot(uint32_t p_hash) const {
+		// Mixed again, as the index table is a power of 2 and only uses the lowest bits.
+		return hash_fmix32(p_hash) & (capacity - 1);
+	}
+
+	static _FORCE_INLINE_ uint32_t _page_of(uint32_t p_index) {
+		uint32_t block = p_index >> FIRST_PAGE_SHIFT;
+		return block == 0 ? 0 : 32 - COMPACT_HASH_MAP_CLZ32(block);
+	}
+
+	static _FORCE_INLINE_ uint32_t _page_start(uint32_t p_page) {
+		return p_page == 0 ? 0 : (1u << (FIRST_PAGE_SHIFT + p_page - 1));
+	}
+
+	static _FORCE_INLINE_ uint32_t _page_size(uint32_t p_page) {
+		return p_page == 0 ? (1u << FIRST_PAGE_SHIFT) : _page_start(p_page);
+	}
+
+	_FORCE_INLINE_ KeyValue<TKey, TValue> *_element(uint32_t p_index) const {
+		uint32_t page = _page_of(p_index);
+		return pages[page] + (p_index - _page_start(page));
+	}
+
+	_FORCE_INLINE_ uint32_t _next_index(uint32_t p_index) const {
+		const uint32_t used = hashes.size();
+		do {
+			p_index++;
+		} while (p_index < used && hashes[p_index] == EMPTY_HASH);
+		return p_index;
+	}
+
+	bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false;
+		}
+		return _lookup_pos_with_hash(p_key, _hash(p_key), r_pos);
+	}
+
+	bool _lookup_pos_with_hash(const TKey &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false;
+		}
+
+		const uint32_t hash = p_hash;
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = _home_slot(hash);
+
+		while (true) {
+			const Slot &slot = slots[pos];
+			if (slot.hash == EMPTY_HASH) {
+				return false;
+			}
+			if (slot.hash == hash && Comparator::compare(_element(slot.index)->key, p_key)) {
+				r_pos = pos;
+				return true;
+			}
+			pos = (pos + 1) & mask;
+		}
+	}
+
+	_FORCE_INLINE_ void _insert_slot(uint32_t p_hash, uint32_t p_index) {
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = _home_slot(p_hash);
+		while (slots[pos].hash != EMPTY_HASH) {
+			pos = (pos + 1) & mask;
+		}
+		slots[pos].hash = p_hash;
+		slots[pos].index = p_index;
+	}
+
+	void _rebuild_index(uint32_t p_capacity) {
+		if (p_capacity != capacity) {
+			if (slots != nullptr) {
+				Memory::free_static(slots);
+			}
+			capacity = p_capacity;
+			slots = reinterpret_cast<Slot *>(Memory::alloc_static(sizeof(Slot) * capacity));
+		}
+		for (uint32_t i = 0; i < capacity; i++) {
+			slots[i].hash = EMPTY_HASH;
+		}
+		for (uint32_t i = 0; i < hashes.size(); i++) {
+			if (hashes[i] != EMPTY_HASH) {
+				_insert_slot(hashes[i], i);
+			}
+		}
+	}
+
+	// Moves the elements over the holes, keeping their order.
+	void _compact() {
+		uint32_t to = 0;
+		for (uint32_t from = 0; from < hashes.size(); from++) {
+			if (hashes[from] == EMPTY_HASH) {
+				continue;
+			}
+			if (from != to) {
+				KeyValue<TKey, TValue> *src = _element(from);
+				memnew_placement(_element(to), Element(*src));
+				src->~KeyValue<TKey, TValue>();
+				hashes[to] = hashes[from];
+			}
+			to++;
+		}
+		hashes.resize(to);
+		_rebuild_index(capacity);
+	}
+
+	// Returns uninitialized storage for a new element at the end of the dense array.
+	_FORCE_INLINE_ KeyValue<TKey, TValue> *_append(uint32_t p_hash) {
+		const uint32_t index = hashes.size();
+		const uint32_t page = _page_of(index);
+		if (page == pages.size()) {
+			pages.push_back(reinterpret_cast<KeyValue<TKey, TValue> *>(Memory::alloc_static(sizeof(KeyValue<TKey, TValue>) * _page_size(page))));
+		}
+		hashes.push_back(p_hash);
+		_insert_slot(p_hash, index);
+		num_elements++;
+		return pages[page] + (index - _page_start(page));
+	}
+
+	// Returns the position of the element in the dense array.
+	uint32_t _insert(const TKey &p_key, const TValue &p_value) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		if (_lookup_pos_with_hash(p_key, hash, pos)) {
+			_element(slots[pos].index)->value = p_value;
+			return slots[pos].index;
+		}
+
+		ERR_FAIL_COND_V_MSG(hashes.size() == (UINT32_MAX >> 1), UINT32_MAX, "Hash table maximum capacity reached, aborting insertion.");
+
+		if ((num_elements + 1) * 2 > capacity) {
+			_rebuild_index(MAX(MIN_CAPACITY, capacity * 2));
+		}
+
+		memnew_placement(_append(hash), Element(p_key, p_value));
+		return hashes.size() - 1;
+	}
+
+	void _free_pages() {
+		for (uint32_t i = 0; i < pages.size(); i++) {
+			Memory::free_static(pages[i]);
+		}
+		pages.clear();
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity / 2; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < hashes.size(); i++) {
+			if (hashes[i] != EMPTY_HASH) {
+				_element(i)->~KeyValue<TKey, TValue>();
+			}
+		}
+		for (uint32_t i = 0; i < capacity; i++) {
+			slots[i].hash = EMPTY_HASH;
+		}
+		hashes.clear();
+		num_elements = 0;
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "CompactHashMap key not found.");
+		return _element(slots[pos].index)->value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "CompactHashMap key not found.");
+		return _element(slots[pos].index)->value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &_element(slots[pos].index)->value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &_element(slots[pos].index)->value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return _lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return false;
+		}
+
+		const uint32_t index = slots[pos].index;
+
+		// Backward shift deletion, so the index never needs tombstones.
+		const uint32_t mask = capacity - 1;
+		uint32_t next_pos = (pos + 1) & mask;
+		while (slots[next_pos].hash != EMPTY_HASH) {
+			uint32_t home = _home_slot(slots[next_pos].hash);
+			if (((next_pos - home) & mask) >= ((next_pos - pos) & mask)) {
+				slots[pos] = slots[next_pos];
+				pos = next_pos;
+			}
+			next_pos = (next_pos + 1) & mask;
+		}
+		slots[pos].hash = EMPTY_HASH;
+
+		_element(index)->~KeyValue<TKey, TValue>();
+		hashes[index] = EMPTY_HASH;
+		num_elements--;
+
+		// Trailing holes are dropped right away.
+		uint32_t used = hashes.size();
+		while (used > 0 && hashes[used - 1] == EMPTY_HASH) {
+			used--;
+		}
+		hashes.resize(used);
+
+		if (hashes.size() - num_elements > MAX(num_elements, MIN_CAPACITY)) {
+			_compact();
+		}
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	void reserve(uint32_t p_new_capacity) {
+		uint32_t new_capacity = next_power_of_2(MAX(p_new_capacity, MIN_CAPACITY / 2) * 2);
+		if (new_capacity > capacity) {
+			_rebuild_index(new_capacity);
+		}
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return *map->_element(index);
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const {
+			return map->_element(index);
+		}
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			index = map->_next_index(index);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return index == b.index; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return index != b.index; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map != nullptr && index < map->hashes.size();
+		}
+
+		_FORCE_INLINE_ ConstIterator(const CompactHashMap *p_map, uint32_t p_index) :
+				map(p_map), index(p_index) {}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		const CompactHashMap *map = nullptr;
+		uint32_t index = 0;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return *map->_element(index);
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const {
+			return map->_element(index);
+		}
+		_FORCE_INLINE_ Iterator &operator++() {
+			index = map->_next_index(index);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return index == b.index; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return index != b.index; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map != nullptr && index < map->hashes.size();
+		}
+
+		_FORCE_INLINE_ Iterator(CompactHashMap *p_map, uint32_t p_index) :
+				map(p_map), index(p_index) {}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, index);
+		}
+
+	private:
+		CompactHashMap *map = nullptr;
+		uint32_t index = 0;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(this, hashes.is_empty() || hashes[0] != EMPTY_HASH ? 0 : _next_index(0));
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, hashes.size());
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return Iterator(this, slots[pos].index);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(this, hashes.is_empty() || hashes[0] != EMPTY_HASH ? 0 : _next_index(0));
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, hashes.size());
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return ConstIterator(this, slots[pos].index);
+	}
+
+	// Returns the element at the given position in insertion order.
+	// Constant time unless elements other than the last one were erased.
+	ConstIterator get_by_index(uint32_t p_index) const {
+		ERR_FAIL_UNSIGNED_INDEX_V(p_index, num_elements, end());
+		if (num_elements == hashes.size()) {
+			return ConstIterator(this, p_index);
+		}
+		ConstIterator it = begin();
+		for (uint32_t i = 0; i < p_index; i++) {
+			++it;
+		}
+		return it;
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND(!exists);
+		return _element(slots[pos].index)->value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return _element(slots[pos].index)->value;
+		}
+		const uint32_t index = _insert(p_key, TValue());
+		CRASH_COND(index == UINT32_MAX);
+		return _element(index)->value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		const uint32_t index = _insert(p_key, p_value);
+		return index == UINT32_MAX ? end() : Iterator(this, index);
+	}
+
+	/* Constructors */
+
+	void operator=(const CompactHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		if (p_other.num_elements == 0) {
+			return;
+		}
+
+		// Copied compacted, in order. Hashes are already known, so nothing is hashed again.
+		reserve(p_other.num_elements);
+		for (uint32_t i = 0; i < p_other.hashes.size(); i++) {
+			if (p_other.hashes[i] == EMPTY_HASH) {
+				continue;
+			}
+			memnew_placement(_append(p_other.hashes[i]), Element(*p_other._element(i)));
+		}
+	}
+
+	CompactHashMap(const CompactHashMap &p_other) {
+		operator=(p_other);
+	}
+
+	CompactHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	CompactHashMap() {}
+
+	~CompactHashMap() {
+		clear();
+		_free_pages();
+		if (slots != nullptr) {
+			Memory::free_static(slots);
+		}
+	}
+};
+
+#endif // COMPACT_HASH_MAP_H
@@ -276,6 +276,41 @@ Error CowData<T>::resize(int p_size) {
 		return OK;
 	}
 
+	if (_ptr && _get_refcount()->get() > 1) {
+		// Shared with other copies: instead of copying it all and resizing the copy,
+		// allocate the new size directly and only copy the elements that are kept.
+		size_t alloc_size;
+		ERR_FAIL_COND_V(!_get_alloc_size_checked(p_size, &alloc_size), ERR_OUT_OF_MEMORY);
+		uint32_t *mem_new = (uint32_t *)Memory::alloc_static(alloc_size, true);
+		ERR_FAIL_COND_V(!mem_new, ERR_OUT_OF_MEMORY);
+
+		new (mem_new - 2) SafeNumeric<uint32_t>(1); //refcount
+		*(mem_new - 1) = p_size; //size
+
+		T *_data = (T *)(mem_new);
+		int copy_size = MIN(current_size, p_size);
+
+		if (std::is_trivially_copyable<T>::value) {
+			memcpy(mem_new, _ptr, copy_size * sizeof(T));
+		} else {
+			for (int i = 0; i < copy_size; i++) {
+				memnew_placement(&_data[i], T(_ptr[i]));
+			}
+		}
+
+		if (!std::is_trivially_constructible<T>::value) {
+			for (int i = copy_size; i < p_size; i++) {
+				memnew_placement(&_data[i], T);
+			}
+		} else if (p_ensure_zero && p_size > copy_size) {
+			memset((void *)(_data + copy_size), 0, (p_size - copy_size) * sizeof(T));
+		}
+
+		_unref(_ptr);
+		_ptr = _data;
+		return OK;
+	}
+
 	// possibly changing size, copy on write
 	uint32_t rc = _copy_on_write();
 
@@ -0,0 +1,378 @@
+/*************************************************************************/
+/*  parallel.h                                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/sort_array.h"
+#include "core/typedefs.h"
+
+// Parallel versions of common loops and algorithms, running on the
+// WorkerThreadPool. Work is split in a few chunks per thread so uneven
+// chunks still balance, and the calling thread processes chunks too.
+// Anything smaller than the grain size runs directly on the caller.
+
+template <class T>
+struct _DefaultRadixKey {
+	_FORCE_INLINE_ T operator()(const T &p_value) const { return p_value; }
+};
+
+class Parallel {
+	template <class F>
+	static void _call_chunk(void *p_userdata, uint32_t p_chunk) {
+		(*(F *)p_userdata)(p_chunk);
+	}
+
+	// Merge path: how many elements of A are among the first p_diagonal elements of A and B merged.
+	template <class T, class Comparator>
+	static uint32_t _merge_path(const T *p_a, uint32_t p_a_count, const T *p_b, uint32_t p_b_count, uint32_t p_diagonal, const Comparator &p_compare) {
+		uint32_t low = p_diagonal > p_b_count ? p_diagonal - p_b_count : 0;
+		uint32_t high = MIN(p_diagonal, p_a_count);
+		while (low < high) {
+			uint32_t i = (low + high) / 2;
+			if (p_compare(p_b[p_diagonal - i - 1], p_a[i])) {
+				high = i;
+			} else {
+				low = i + 1;
+			}
+		}
+		return low;
+	}
+
+public:
+	enum {
+		DEFAULT_GRAIN = 256,
+		SORT_GRAIN = 4096,
+	};
+
+	// Number of chunks to split p_count elements in, so none has less than p_grain elements.
+	static uint32_t get_chunk_count(uint32_t p_count, uint32_t p_grain = DEFAULT_GRAIN) {
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		uint32_t thread_count = pool ? pool->get_thread_count() : 0;
+		p_grain = MAX(p_grain, 1u);
+		if (thread_count == 0 || p_count <= p_grain) {
+			return 1;
+		}
+		return MIN((thread_count + 1) * 4, (p_count + p_grain - 1) / p_grain);
+	}
+
+	// Calls p_func(chunk) for every chunk in [0, p_chunk_count), and returns once all are done.
+	template <class F>
+	static void run_chunks(uint32_t p_chunk_count, F p_func) {
+		if (p_chunk_count <= 1) {
+			if (p_chunk_count == 1) {
+				p_func(0);
+			}
+			return;
+		}
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		WorkerThreadPool::GroupID group = pool->add_native_group_task(&_call_chunk<F>, &p_func, p_chunk_count, -1, true);
+		pool->wait_for_group_task_completion(group);
+	}
+
+	// Calls p_func(from, to) over consecutive sub-ranges covering [p_begin, p_end).
+	template <class F>
+	static void for_range(uint32_t p_begin, uint32_t p_end, F p_func, uint32_t p_grain = DEFAULT_GRAIN) {
+		ERR_FAIL_COND(p_begin > p_end);
+		uint32_t count = p_end - p_begin;
+		uint32_t chunk_count = get_chunk_count(count, p_grain);
+		run_chunks(chunk_count, [&](uint32_t p_chunk) {
+			uint32_t from = p_begin + uint64_t(count) * p_chunk / chunk_count;
+			uint32_t to = p_begin + uint64_t(count) * (p_chunk + 1) / chunk_count;
+			p_func(from, to);
+		});
+	}
+
+	// Merge sort. Chunks are sorted with SortArray, then merged in rounds that are split evenly between threads.
+	// Not stable, as the chunks themselves are sorted with introsort.
+	template <class T, class Comparator = _DefaultComparator<T>>
+	static void sort(T *p_array, uint32_t p_count, const Comparator &p_compare = Comparator()) {
+		uint32_t chunk_count = previous_power_of_2(get_chunk_count(p_count, SORT_GRAIN));
+		if (chunk_count <= 1) {
+			SortArray<T, Comparator> sorter;
+			sorter.compare = p_compare;
+			sorter.sort(p_array, p_count);
+			return;
+		}
+
+		run_chunks(chunk_count, [&](uint32_t p_chunk) {
+			uint32_t from = uint64_t(p_count) * p_chunk / chunk_count;
+			uint32_t to = uint64_t(p_count) * (p_chunk + 1) / chunk_count;
+			SortArray<T, Comparator> sorter;
+			sorter.compare = p_compare;
+			sorter.sort(p_array + from, to - from);
+		});
+
+		LocalVector<T> buffer;
+		buffer.resize(p_count);
+		T *src = p_array;
+		T *dst = buffer.ptr();
+
+		for (uint32_t width = 1; width < chunk_count; width *= 2) {
+			// Each round merges pairs of runs of `width` chunks. Every merge is split in as many
+			// parts as it has chunks, so all rounds use the same number of jobs.
+			uint32_t parts = width * 2;
+			run_chunks(chunk_count, [&](uint32_t p_job) {
+				uint32_t first_chunk = p_job / parts * parts;
+				uint32_t part = p_job % parts;
+				uint32_t begin = uint64_t(p_count) * first_chunk / chunk_count;
+				uint32_t middle = uint64_t(p_count) * (first_chunk + width) / chunk_count;
+				uint32_t end = uint64_t(p_count) * (first_chunk + parts) / chunk_count;
+
+				const T *a = src + begin;
+				const T *b = src + middle;
+				uint32_t a_count = middle - begin;
+				uint32_t b_count = end - middle;
+				uint32_t out_from = uint64_t(end - begin) * part / parts;
+				uint32_t out_to = uint64_t(end - begin) * (part + 1) / parts;
+
+				uint32_t i = _merge_path(a, a_count, b, b_count, out_from, p_compare);
+				uint32_t j = out_from - i;
+				uint32_t i_end = _merge_path(a, a_count, b, b_count, out_to, p_compare);
+				uint32_t j_end = out_to - i_end;
+				T *out = dst + begin + out_from;
+
+				while (i < i_end && j < j_end) {
+					if (p_compare(b[j], a[i])) {
+						*out++ = b[j++];
+					} else {
+						*out++ = a[i++];
+					}
+				}
+				while (i < i_end) {
+					*out++ = a[i++];
+				}
+				while (j < j_end) {
+					*out++ = b[j++];
+				}
+			});
+			SWAP(src, dst);
+		}
+
+		if (src != p_array) {
+			for_range(0, p_count, [&](uint32_t p_from, uint32_t p_to) {
+				for (uint32_t i = p_from; i < p_to; i++) {
+					p_array[i] = src[i];
+				}
+			},
+					SORT_GRAIN);
+		}
+	}
+
+	// Stable LSD radix sort on unsigned integer keys, 8 bits per pass. Passes where all keys share the same digit are skipped.
+	template <class T, class KeyGetter = _DefaultRadixKey<T>>
+	static void radix_sort(T *p_array, uint32_t p_count, const KeyGetter &p_key = KeyGetter()) {
+		typedef decltype(p_key(*p_array)) Key;
+		const uint32_t pass_count = sizeof(Key);
+		if (p_count < 2) {
+			return;
+		}
+
+		uint32_t chunk_count = get_chunk_count(p_count, SORT_GRAIN);
+		LocalVector<uint32_t> offsets; // 256 per chunk.
+		offsets.resize(chunk_count * 256);
+		LocalVector<T> buffer;
+		buffer.resize(p_count);
+		T *src = p_array;
+		T *dst = buffer.ptr();
+
+		for (uint32_t pass = 0; pass < pass_count; pass++) {
+			uint32_t shift = pass * 8;
+
+			run_chunks(chunk_count, [&](uint32_t p_chunk) {
+				uint32_t *histogram = offsets.ptr() + p_chunk * 256;
+				memset(histogram, 0, sizeof(uint32_t) * 256);
+				uint32_t from = uint64_t(p_count) * p_chunk / chunk_count;
+				uint32_t to = uint64_t(p_count) * (p_chunk + 1) / chunk_count;
+				for (uint32_t i = from; i < to; i++) {
+					histogram[(p_key(src[i]) >> shift) & 0xFF]++;
+				}
+			});
+
+			// Turn the histograms into where each chunk writes each digit, in digit then chunk order.
+			uint32_t total = 0;
+			bool single_digit = false;
+			for (uint32_t digit = 0; digit < 256; digit++) {
+				uint32_t digit_count = 0;
+				for (uint32_t chunk = 0; chunk < chunk_count; chunk++) {
+					uint32_t &offset = offsets[chunk * 256 + digit];
+					uint32_t count = offset;
+					offset = total;
+					total += count;
+					digit_count += count;
+				}
+				if (digit_count == p_count) {
+					single_digit = true;
+				}
+			}
+			if (single_digit) {
+				continue;
+			}
+
+			run_chunks(chunk_count, [&](uint32_t p_chunk) {
+				uint32_t *chunk_offsets = offsets.ptr() + p_chunk * 256;
+				uint32_t from = uint64_t(p_count) * p_chunk / chunk_count;
+				uint32_t to = uint64_t(p_count) * (p_chunk + 1) / chunk_count;
+				for (uint32_t i = from; i < to; i++) {
+					dst[chunk_offsets[(p_key(src[i]) >> shift) & 0xFF]++] = src[i];
+				}
+			});
+			SWAP(src, dst);
+		}
+
+		if (src != p_array) {
+			for_range(0, p_count, [&](uint32_t p_from, uint32_t p_to) {
+				for (uint32_t i = p_from; i < p_to; i++) {
+					p_array[i] = src[i];
+				}
+			},
+					SORT_GRAIN);
+		}
+	}
+
+	// Combines p_map(i) for every i in [0, p_count) with p_reduce, which must be associative.
+	// Chunks are combined in order, so the result doesn't depend on which threads run them.
+	template <class T, class Map, class Reduce>
+	static T reduce(uint32_t p_count, const T &p_identity, Map p_map, Reduce p_reduce, uint32_t p_grain = DEFAULT_GRAIN) {
+		uint32_t chunk_count = get_chunk_count(p_count, p_grain);
+		LocalVector<T> partial;
+		partial.resize(chunk_count);
+		run_chunks(chunk_count, [&](uint32_t p_chunk) {
+			uint32_t from = uint64_t(p_count) * p_chunk / chunk_count;
+			uint32_t to = uint64_t(p_count) * (p_chunk + 1) / chunk_count;
+			T value = p_identity;
+			for (uint32_t i = from; i < to; i++) {
+				value = p_reduce(value, p_map(i));
+			}
+			partial[p_chunk] = value;
+		});
+
+		T result = p_identity;
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			result = p_reduce(result, partial[i]);
+		}
+		return result;
+	}
+
+	// Inclusive prefix sum: p_dst[i] = p_src[0] + ... + p_src[i]. p_src and p_dst may be the same array.
+	template <class T>
+	static void prefix_sum(const T *p_src, T *p_dst, uint32_t p_count, uint32_t p_grain = DEFAULT_GRAIN) {
+		uint32_t chunk_count = get_chunk_count(p_count, p_grain);
+		LocalVector<T> chunk_offsets;
+		chunk_offsets.resize(chunk_count);
+
+		if (chunk_count > 1) {
+			run_chunks(chunk_count, [&](uint32_t p_chunk) {
+				uint32_t from = uint64_t(p_count) * p_chunk / chunk_count;
+				uint32_t to = uint64_t(p_count) * (p_chunk + 1) / chunk_count;
+				T sum = T();
+				for (uint32_t i = from; i < to; i++) {
+					sum += p_src[i];
+				}
+				chunk_offsets[p_chunk] = sum;
+			});
+		}
+
+		T offset = T();
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			T sum = chunk_offsets[i];
+			chunk_offsets[i] = offset;
+			offset += sum;
+		}
+
+		run_chunks(chunk_count, [&](uint32_t p_chunk) {
+			uint32_t from = uint64_t(p_count) * p_chunk / chunk_count;
+			uint32_t to = uint64_t(p_count) * (p_chunk + 1) / chunk_count;
+			T sum = chunk_offsets[p_chunk];
+			for (uint32_t i = from; i < to; i++) {
+				sum += p_src[i];
+				p_dst[i] = sum;
+			}
+		});
+	}
+
+	// Stable partition: elements for which p_predicate is true are moved before the rest,
+	// keeping their relative order. Returns how many there are.
+	template <class T, class Predicate>
+	static uint32_t partition(T *p_array, uint32_t p_count, Predicate p_predicate, uint32_t p_grain = DEFAULT_GRAIN) {
+		uint32_t chunk_count = get_chunk_count(p_count, p_grain);
+		LocalVector<uint8_t> selected;
+		selected.resize(p_count);
+		LocalVector<uint32_t> selected_offsets;
+		selected_offsets.resize(chunk_count);
+
+		run_chunks(chunk_count, [&](uint32_t p_chunk) {
+			uint32_t from = uint64_t(p_count) * p_chunk / chunk_count;
+			uint32_t to = uint64_t(p_count) * (p_chunk + 1) / chunk_count;
+			uint32_t count = 0;
+			for (uint32_t i = from; i < to; i++) {
+				selected[i] = p_predicate(p_array[i]) ? 1 : 0;
+				count += selected[i];
+			}
+			selected_offsets[p_chunk] = count;
+		});
+
+		uint32_t selected_count = 0;
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			uint32_t count = selected_offsets[i];
+			selected_offsets[i] = selected_count;
+			selected_count += count;
+		}
+
+		LocalVector<T> buffer;
+		buffer.resize(p_count);
+		run_chunks(chunk_count, [&](uint32_t p_chunk) {
+			uint32_t from = uint64_t(p_count) * p_chunk / chunk_count;
+			uint32_t to = uint64_t(p_count) * (p_chunk + 1) / chunk_count;
+			uint32_t selected_pos = selected_offsets[p_chunk];
+			// Elements before this chunk that weren't selected go first in the second part.
+			uint32_t rest_pos = selected_count + (from - selected_pos);
+			for (uint32_t i = from; i < to; i++) {
+				if (selected[i]) {
+					buffer[selected_pos++] = p_array[i];
+				} else {
+					buffer[rest_pos++] = p_array[i];
+				}
+			}
+		});
+
+		for_range(0, p_count, [&](uint32_t p_from, uint32_t p_to) {
+			for (uint32_t i = p_from; i < p_to; i++) {
+				p_array[i] = buffer[i];
+			}
+		});
+
+		return selected_count;
+	}
+};
+
+#endif // PARALLEL_H
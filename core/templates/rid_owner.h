@@ -36,11 +36,13 @@
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
 
 #include <stdio.h>
+#include <atomic>
 #include <typeinfo>
 
 class RID_AllocBase {
@@ -69,46 +71,85 @@ public:
 
 template <class T, bool THREAD_SAFE = false>
 class RID_Alloc : public RID_AllocBase {
-	T **chunks = nullptr;
+	// Chunks never move once allocated, and the tables pointing to them are
+	// replaced instead of being reallocated in place (old tables are freed
+	// along with the allocator when THREAD_SAFE). Together with the atomic
+	// validators, this lets get_or_null() and owns() run without locking:
+	// only allocating, initializing and freeing take the lock.
+	std::atomic<T **> chunks = { nullptr };
+	std::atomic<std::atomic<uint32_t> **> validator_chunks = { nullptr };
 	uint32_t **free_list_chunks = nullptr;
-	uint32_t **validator_chunks = nullptr;
+	uint32_t chunk_table_size = 0;
+	LocalVector<void *> retired_tables;
 
 	uint32_t elements_in_chunk;
-	uint32_t max_alloc = 0;
+	std::atomic<uint32_t> max_alloc = { 0 };
 	uint32_t alloc_count = 0;
 
 	const char *description = nullptr;
 
 	mutable SpinLock spin_lock;
 
+	void _grow_chunk_tables() {
+		uint32_t chunk_count = max_alloc.load(std::memory_order_relaxed) / elements_in_chunk;
+		uint32_t new_size = MAX(4u, chunk_table_size * 2);
+
+		T **old_chunks = chunks.load(std::memory_order_relaxed);
+		std::atomic<uint32_t> **old_validator_chunks = validator_chunks.load(std::memory_order_relaxed);
+		T **new_chunks = (T **)memalloc(sizeof(T *) * new_size);
+		std::atomic<uint32_t> **new_validator_chunks = (std::atomic<uint32_t> **)memalloc(sizeof(std::atomic<uint32_t> *) * new_size);
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			new_chunks[i] = old_chunks[i];
+			new_validator_chunks[i] = old_validator_chunks[i];
+		}
+		chunks.store(new_chunks, std::memory_order_release);
+		validator_chunks.store(new_validator_chunks, std::memory_order_release);
+
+		if (old_chunks) {
+			if (THREAD_SAFE) {
+				// Readers may still be using them.
+				retired_tables.push_back(old_chunks);
+				retired_tables.push_back(old_validator_chunks);
+			} else {
+				memfree(old_chunks);
+				memfree(old_validator_chunks);
+			}
+		}
+
+		free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * new_size);
+		chunk_table_size = new_size;
+	}
+
 	_FORCE_INLINE_ RID _allocate_rid() {
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
 
-		if (alloc_count == max_alloc) {
+		if (alloc_count == max_alloc.load(std::memory_order_relaxed)) {
 			//allocate a new chunk
-			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc / elements_in_chunk);
+			uint32_t chunk_count = alloc_count / elements_in_chunk;
+
+			//grow chunk tables
+			if (chunk_count == chunk_table_size) {
+				_grow_chunk_tables();
+			}
 
-			//grow chunks
-			chunks = (T **)memrealloc(chunks, sizeof(T *) * (chunk_count + 1));
-			chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
+			chunks.load(std::memory_order_relaxed)[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
 
-			//grow validators
-			validator_chunks = (uint32_t **)memrealloc(validator_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			validator_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
-			//grow free lists
-			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
+			std::atomic<uint32_t> *validators = (std::atomic<uint32_t> *)memalloc(sizeof(std::atomic<uint32_t>) * elements_in_chunk);
+			uint32_t *free_list = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
 
 			//initialize
 			for (uint32_t i = 0; i < elements_in_chunk; i++) {
 				// Don't initialize chunk.
-				validator_chunks[chunk_count][i] = 0xFFFFFFFF;
-				free_list_chunks[chunk_count][i] = alloc_count + i;
+				memnew_placement(&validators[i], std::atomic<uint32_t>(0xFFFFFFFF));
+				free_list[i] = alloc_count + i;
 			}
+			validator_chunks.load(std::memory_order_relaxed)[chunk_count] = validators;
+			free_list_chunks[chunk_count] = free_list;
 
-			max_alloc += elements_in_chunk;
+			// Publishes the new chunk to lock-free readers.
+			max_alloc.store(alloc_count + elements_in_chunk, std::memory_order_release);
 		}
 
 		uint32_t free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
@@ -121,9 +162,7 @@ class RID_Alloc : public RID_AllocBase {
 		id <<= 32;
 		id |= free_index;
 
-		validator_chunks[free_chunk][free_element] = validator;
-
-		validator_chunks[free_chunk][free_element] |= 0x80000000; //mark uninitialized bit
+		validator_chunks.load(std::memory_order_relaxed)[free_chunk][free_element].store(validator | 0x80000000, std::memory_order_release); //mark uninitialized bit
 
 		alloc_count++;
 
@@ -134,6 +173,61 @@ class RID_Alloc : public RID_AllocBase {
 		return _make_from_id(id);
 	}
 
+	// Returns the memory of an allocated RID that was not initialized yet.
+	T *_get_uninitialized(const RID &p_rid) {
+		if (p_rid == RID()) {
+			return nullptr;
+		}
+		if (THREAD_SAFE) {
+			spin_lock.lock();
+		}
+
+		uint64_t id = p_rid.get_id();
+		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
+		if (unlikely(idx >= max_alloc.load(std::memory_order_relaxed))) {
+			if (THREAD_SAFE) {
+				spin_lock.unlock();
+			}
+			return nullptr;
+		}
+
+		uint32_t idx_chunk = idx / elements_in_chunk;
+		uint32_t idx_element = idx % elements_in_chunk;
+
+		uint32_t validator = uint32_t(id >> 32);
+		uint32_t current = validator_chunks.load(std::memory_order_relaxed)[idx_chunk][idx_element].load(std::memory_order_relaxed);
+
+		if (unlikely(!(current & 0x80000000))) {
+			if (THREAD_SAFE) {
+				spin_lock.unlock();
+			}
+			ERR_FAIL_V_MSG(nullptr, "Initializing already initialized RID");
+		}
+
+		if (unlikely((current & 0x7FFFFFFF) != validator)) {
+			if (THREAD_SAFE) {
+				spin_lock.unlock();
+			}
+			ERR_FAIL_V_MSG(nullptr, "Attempting to initialize the wrong RID");
+		}
+
+		T *ptr = &chunks.load(std::memory_order_relaxed)[idx_chunk][idx_element];
+
+		if (THREAD_SAFE) {
+			spin_lock.unlock();
+		}
+
+		return ptr;
+	}
+
+	// Marks the RID as initialized. Done once the element is constructed, so
+	// lock-free readers never get a pointer to an element being constructed.
+	void _set_initialized(const RID &p_rid) {
+		uint64_t id = p_rid.get_id();
+		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
+		validator_chunks.load(std::memory_order_relaxed)[idx / elements_in_chunk][idx % elements_in_chunk].store(uint32_t(id >> 32), std::memory_order_release);
+	}
+
 public:
 	RID make_rid() {
 		RID rid = _allocate_rid();
@@ -155,16 +249,18 @@ public:
 		if (p_rid == RID()) {
 			return nullptr;
 		}
-		if (THREAD_SAFE) {
-			spin_lock.lock();
+
+		if (unlikely(p_initialize)) {
+			T *ptr = _get_uninitialized(p_rid);
+			if (ptr) {
+				_set_initialized(p_rid);
+			}
+			return ptr;
 		}
 
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(std::memory_order_acquire))) {
 			return nullptr;
 		}
 
@@ -172,65 +268,34 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
+		uint32_t current = validator_chunks.load(std::memory_order_acquire)[idx_chunk][idx_element].load(std::memory_order_acquire);
 
-		if (unlikely(p_initialize)) {
-			if (unlikely(!(validator_chunks[idx_chunk][idx_element] & 0x80000000))) {
-				if (THREAD_SAFE) {
-					spin_lock.unlock();
-				}
-				ERR_FAIL_V_MSG(nullptr, "Initializing already initialized RID");
-			}
-
-			if (unlikely((validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) != validator)) {
-				if (THREAD_SAFE) {
-					spin_lock.unlock();
-				}
-				ERR_FAIL_V_MSG(nullptr, "Attempting to initialize the wrong RID");
-				return nullptr;
-			}
-
-			validator_chunks[idx_chunk][idx_element] &= 0x7FFFFFFF; //initialized
-
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
-			if ((validator_chunks[idx_chunk][idx_element] & 0x80000000) && validator_chunks[idx_chunk][idx_element] != 0xFFFFFFFF) {
+		if (unlikely(current != validator)) {
+			if ((current & 0x80000000) && current != 0xFFFFFFFF) {
 				ERR_FAIL_V_MSG(nullptr, "Attempting to use an uninitialized RID");
 			}
 			return nullptr;
 		}
 
-		T *ptr = &chunks[idx_chunk][idx_element];
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return ptr;
+		return &chunks.load(std::memory_order_acquire)[idx_chunk][idx_element];
 	}
 	void initialize_rid(RID p_rid) {
-		T *mem = get_or_null(p_rid, true);
+		T *mem = _get_uninitialized(p_rid);
 		ERR_FAIL_COND(!mem);
 		memnew_placement(mem, T);
+		_set_initialized(p_rid);
 	}
 	void initialize_rid(RID p_rid, const T &p_value) {
-		T *mem = get_or_null(p_rid, true);
+		T *mem = _get_uninitialized(p_rid);
 		ERR_FAIL_COND(!mem);
 		memnew_placement(mem, T(p_value));
+		_set_initialized(p_rid);
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(std::memory_order_acquire))) {
 			return false;
 		}
 
@@ -239,13 +304,7 @@ public:
 
 		uint32_t validator = uint32_t(id >> 32);
 
-		bool owned = (validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) == validator;
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return owned;
+		return (validator_chunks.load(std::memory_order_acquire)[idx_chunk][idx_element].load(std::memory_order_acquire) & 0x7FFFFFFF) == validator;
 	}
 
 	_FORCE_INLINE_ void free(const RID &p_rid) {
@@ -255,7 +314,7 @@ public:
 
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
+		if (unlikely(idx >= max_alloc.load(std::memory_order_relaxed))) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
@@ -266,20 +325,21 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] & 0x80000000)) {
+		std::atomic<uint32_t> &current = validator_chunks.load(std::memory_order_relaxed)[idx_chunk][idx_element];
+		if (unlikely(current.load(std::memory_order_relaxed) & 0x80000000)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL_MSG("Attempted to free an uninitialized or invalid RID");
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
+		} else if (unlikely(current.load(std::memory_order_relaxed) != validator)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL();
 		}
 
-		chunks[idx_chunk][idx_element].~T();
-		validator_chunks[idx_chunk][idx_element] = 0xFFFFFFFF; // go invalid
+		current.store(0xFFFFFFFF, std::memory_order_release); // go invalid, before destroying so readers stop finding it
+		chunks.load(std::memory_order_relaxed)[idx_chunk][idx_element].~T();
 
 		alloc_count--;
 		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
@@ -296,8 +356,9 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		std::atomic<uint32_t> **validators = validator_chunks.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < max_alloc.load(std::memory_order_relaxed); i++) {
+			uint64_t validator = validators[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 			if (validator != 0xFFFFFFFF) {
 				p_owned->push_back(_make_from_id((validator << 32) | i));
 			}
@@ -312,9 +373,10 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
+		std::atomic<uint32_t> **validators = validator_chunks.load(std::memory_order_relaxed);
 		uint32_t idx = 0;
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		for (size_t i = 0; i < max_alloc.load(std::memory_order_relaxed); i++) {
+			uint64_t validator = validators[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 			if (validator != 0xFFFFFFFF) {
 				p_rid_buffer[idx] = _make_from_id((validator << 32) | i);
 				idx++;
@@ -334,6 +396,10 @@ public:
 	}
 
 	~RID_Alloc() {
+		T **chunk_table = chunks.load(std::memory_order_relaxed);
+		std::atomic<uint32_t> **validator_table = validator_chunks.load(std::memory_order_relaxed);
+		uint32_t max = max_alloc.load(std::memory_order_relaxed);
+
 		if (alloc_count) {
 			if (description) {
 				print_error("ERROR: " + itos(alloc_count) + " RID allocations of type '" + description + "' were leaked at exit.");
@@ -345,28 +411,31 @@ public:
 #endif
 			}
 
-			for (size_t i = 0; i < max_alloc; i++) {
-				uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+			for (size_t i = 0; i < max; i++) {
+				uint64_t validator = validator_table[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 				if (validator & 0x80000000) {
 					continue; //uninitialized
 				}
 				if (validator != 0xFFFFFFFF) {
-					chunks[i / elements_in_chunk][i % elements_in_chunk].~T();
+					chunk_table[i / elements_in_chunk][i % elements_in_chunk].~T();
 				}
 			}
 		}
 
-		uint32_t chunk_count = max_alloc / elements_in_chunk;
+		uint32_t chunk_count = max / elements_in_chunk;
 		for (uint32_t i = 0; i < chunk_count; i++) {
-			memfree(chunks[i]);
-			memfree(validator_chunks[i]);
+			memfree(chunk_table[i]);
+			memfree(validator_table[i]);
 			memfree(free_list_chunks[i]);
 		}
 
-		if (chunks) {
-			memfree(chunks);
+		if (chunk_table) {
+			memfree(chunk_table);
 			memfree(free_list_chunks);
-			memfree(validator_chunks);
+			memfree(validator_table);
+		}
+		for (uint32_t i = 0; i < retired_tables.size(); i++) {
+			memfree(retired_tables[i]);
 		}
 	}
 };
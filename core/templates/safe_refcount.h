@@ -118,6 +118,11 @@ public:
 		}
 	}
 
+	// Sets the value only if it still equals the expected one, returns whether it did.
+	_ALWAYS_INLINE_ bool compare_exchange(T p_expected, T p_value) {
+		return value.compare_exchange_strong(p_expected, p_value, std::memory_order_acq_rel);
+	}
+
 	_ALWAYS_INLINE_ T conditional_increment() {
 		while (true) {
 			T c = value.load(std::memory_order_acquire);
@@ -250,6 +255,14 @@ public:
 		return value;
 	}
 
+	_ALWAYS_INLINE_ bool compare_exchange(T p_expected, T p_value) {
+		if (value != p_expected) {
+			return false;
+		}
+		value = p_value;
+		return true;
+	}
+
 	_ALWAYS_INLINE_ T conditional_increment() {
 		if (value == 0) {
 			return 0;
@@ -101,6 +101,8 @@ public:
 
 		_FORCE_INLINE_ SelfList<T> *first() { return _first; }
 		_FORCE_INLINE_ const SelfList<T> *first() const { return _first; }
+		_FORCE_INLINE_ SelfList<T> *last() { return _last; }
+		_FORCE_INLINE_ const SelfList<T> *last() const { return _last; }
 
 		_FORCE_INLINE_ List() {}
 		_FORCE_INLINE_ ~List() { ERR_FAIL_COND(_first != nullptr); }
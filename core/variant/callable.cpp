@@ -63,6 +63,25 @@ void Callable::callp(const Variant **p_arguments, int p_argcount, Variant &r_ret
 	}
 }
 
+void Callable::callp(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error, ObjectLookupCache &r_cache) const {
+	if (is_null() || is_custom()) {
+		callp(p_arguments, p_argcount, r_return_value, r_call_error);
+		return;
+	}
+
+	Object *obj = ObjectDB::get_instance(ObjectID(object));
+#ifdef DEBUG_ENABLED
+	if (!obj) {
+		r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
+		r_call_error.argument = 0;
+		r_call_error.expected = 0;
+		r_return_value = Variant();
+		return;
+	}
+#endif
+	r_return_value = obj->callp_cached(r_cache, method, p_arguments, p_argcount, r_call_error);
+}
+
 Error Callable::rpcp(int p_id, const Variant **p_arguments, int p_argcount, CallError &r_call_error) const {
 	if (is_null()) {
 		r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
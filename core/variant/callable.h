@@ -36,6 +36,7 @@
 #include "core/templates/list.h"
 
 class Object;
+class ObjectLookupCache;
 class Variant;
 class CallableCustom;
 
@@ -70,6 +71,8 @@ public:
 	};
 
 	void callp(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error) const;
+	// For callers invoking the same callable repeatedly, caches the method lookup.
+	void callp(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error, ObjectLookupCache &r_cache) const;
 	void call_deferredp(const Variant **p_arguments, int p_argcount) const;
 
 	Error rpcp(int p_id, const Variant **p_arguments, int p_argcount, CallError &r_call_error) const;
@@ -61,6 +61,7 @@
 #include "core/variant/dictionary.h"
 
 class Object;
+class ObjectLookupCache;
 
 struct PropertyInfo;
 struct MethodInfo;
@@ -577,6 +578,7 @@ public:
 	static uint32_t get_builtin_method_hash(Variant::Type p_type, const StringName &p_method);
 
 	void callp(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+	void callp(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error, ObjectLookupCache &r_cache);
 
 	template <typename... VarArgs>
 	Variant call(const StringName &p_method, VarArgs... p_args) {
@@ -632,6 +634,9 @@ public:
 
 	void set_named(const StringName &p_member, const Variant &p_value, bool &r_valid);
 	Variant get_named(const StringName &p_member, bool &r_valid) const;
+	// Same as above, but object lookups go through a cache kept by the call site.
+	void set_named(const StringName &p_member, const Variant &p_value, bool &r_valid, ObjectLookupCache &r_cache);
+	Variant get_named(const StringName &p_member, bool &r_valid, ObjectLookupCache &r_cache) const;
 
 	typedef void (*ValidatedSetter)(Variant *base, const Variant *value);
 	typedef void (*ValidatedGetter)(const Variant *base, Variant *value);
@@ -1061,6 +1061,26 @@ void Variant::callp(const StringName &p_method, const Variant **p_args, int p_ar
 	}
 }
 
+void Variant::callp(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error, ObjectLookupCache &r_cache) {
+	if (type != Variant::OBJECT) {
+		callp(p_method, p_args, p_argcount, r_ret, r_error);
+		return;
+	}
+
+	Object *obj = _get_obj().obj;
+	if (!obj) {
+		r_error.error = Callable::CallError::CALL_ERROR_INSTANCE_IS_NULL;
+		return;
+	}
+#ifdef DEBUG_ENABLED
+	if (EngineDebugger::is_active() && !_get_obj().id.is_ref_counted() && ObjectDB::get_instance(_get_obj().id) == nullptr) {
+		r_error.error = Callable::CallError::CALL_ERROR_INSTANCE_IS_NULL;
+		return;
+	}
+#endif
+	r_ret = obj->callp_cached(r_cache, p_method, p_args, p_argcount, r_error);
+}
+
 void Variant::call_const(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
 	if (type == Variant::OBJECT) {
 		//call object
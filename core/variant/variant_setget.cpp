@@ -302,6 +302,33 @@ Variant Variant::get_named(const StringName &p_member, bool &r_valid) const {
 	return ret;
 }
 
+void Variant::set_named(const StringName &p_member, const Variant &p_value, bool &r_valid, ObjectLookupCache &r_cache) {
+	if (type != Variant::OBJECT) {
+		set_named(p_member, p_value, r_valid);
+		return;
+	}
+
+	Object *obj = get_validated_object();
+	if (!obj) {
+		r_valid = false;
+	} else {
+		obj->set(p_member, p_value, &r_valid, &r_cache);
+	}
+}
+
+Variant Variant::get_named(const StringName &p_member, bool &r_valid, ObjectLookupCache &r_cache) const {
+	if (type != Variant::OBJECT) {
+		return get_named(p_member, r_valid);
+	}
+
+	Object *obj = get_validated_object();
+	if (!obj) {
+		r_valid = false;
+		return "Instance base is null.";
+	}
+	return obj->get(p_member, &r_valid, &r_cache);
+}
+
 /**** INDEXED SETTERS AND GETTERS ****/
 
 #ifdef DEBUG_ENABLED
@@ -47,6 +47,7 @@
 #include "core/io/ip.h"
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/register_core_types.h"
@@ -3064,6 +3065,8 @@ bool Main::iteration() {
 		frames = 0;
 	}
 
+	FrameArena::end_frame();
+
 	iterating--;
 
 	// Needed for OSs using input buffering regardless accumulation (like Android)
@@ -3248,6 +3251,7 @@ void Main::cleanup(bool p_force) {
 	unregister_core_driver_types();
 	unregister_core_extensions();
 	uninitialize_modules(MODULE_INITIALIZATION_LEVEL_CORE);
+	FrameArena::thread_exit();
 	unregister_core_types();
 
 	OS::get_singleton()->finalize_core();
@@ -89,6 +89,7 @@ public:
 		PHYSICS_3D_COLLISION_PAIRS,
 		PHYSICS_3D_ISLAND_COUNT,
 		AUDIO_OUTPUT_LATENCY,
+		OBJECT_POOLED_NODE_COUNT,
 		MONITOR_MAX
 	};
 
@@ -58,6 +58,7 @@
 
 GDScriptNativeClass::GDScriptNativeClass(const StringName &p_name) {
 	name = p_name;
+	_set_custom_callp();
 }
 
 bool GDScriptNativeClass::_get(const StringName &p_name, Variant &r_ret) const {
@@ -1185,6 +1186,7 @@ String GDScript::_get_gdscript_reference_class_name(const GDScript *p_gdscript)
 
 GDScript::GDScript() :
 		script_list(this) {
+	_set_custom_callp();
 #ifdef DEBUG_ENABLED
 	{
 		MutexLock lock(GDScriptLanguage::get_singleton()->lock);
@@ -1802,6 +1804,13 @@ void GDScriptLanguage::init() {
 		_add_global(E.name, E.ptr);
 	}
 
+#ifdef DEBUG_ENABLED
+	if (EngineDebugger::is_active()) {
+		sampling_profiler.instantiate();
+		sampling_profiler->bind("gdscript_sampler");
+	}
+#endif
+
 #ifdef TESTS_ENABLED
 	GDScriptTests::GDScriptTestRunner::handle_cmdline();
 #endif
@@ -1821,6 +1830,70 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 }
 
 void GDScriptLanguage::finish() {
+	if (sampling_profiler.is_valid()) {
+		sampling_profiler->stop();
+		sampling_profiler.unref();
+	}
+}
+
+Vector<uint8_t> GDScriptLanguage::_acquire_await_stack(uint32_t p_size) {
+	uint32_t bucket = get_shift_from_power_of_2(next_power_of_2(p_size));
+	Vector<uint8_t> stack;
+	if (bucket < AWAIT_STACK_POOL_BUCKETS && await_stack_pool[bucket].size() > 0) {
+		uint32_t last = await_stack_pool[bucket].size() - 1;
+		stack = await_stack_pool[bucket][last];
+		await_stack_pool[bucket].remove_at(last);
+	} else {
+		stack.resize(next_power_of_2(p_size));
+	}
+	return stack;
+}
+
+void GDScriptLanguage::_release_await_stack(Vector<uint8_t> &r_stack) {
+	uint32_t bucket = get_shift_from_power_of_2(r_stack.size());
+	if (bucket < AWAIT_STACK_POOL_BUCKETS && await_stack_pool[bucket].size() < AWAIT_STACK_POOL_MAX_PER_BUCKET) {
+		await_stack_pool[bucket].push_back(r_stack);
+	}
+	r_stack = Vector<uint8_t>();
+}
+
+void GDScriptLanguage::_take_sample() {
+	if (Thread::get_main_id() != Thread::get_caller_id()) {
+		return; // The call stack is only tracked for the main thread.
+	}
+
+	uint32_t count = sample_requests.get();
+	if (count == 0) {
+		return;
+	}
+	sample_requests.sub(count);
+
+	if (!active_sampler) {
+		return;
+	}
+
+	// Folded stack format: frames from the outermost to the innermost, separated by ';'.
+	String folded = "[engine]";
+	for (int i = 0; i < _debug_call_stack_pos; i++) {
+		const CallLevel &cl = _call_stack[i];
+		if (!cl.function) {
+			continue;
+		}
+		folded += ";" + String(cl.function->get_name()) + " (" + cl.function->get_source() + ":" + itos(cl.line ? *cl.line : 0) + ")";
+	}
+	active_sampler->add_sample(folded, count);
+}
+
+void GDScriptLanguage::_take_engine_samples() {
+	uint32_t count = engine_sample_requests.get();
+	if (count == 0) {
+		return;
+	}
+	engine_sample_requests.sub(count);
+
+	if (active_sampler) {
+		active_sampler->add_sample("[engine]", count);
+	}
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -2077,6 +2150,11 @@ void GDScriptLanguage::frame() {
 	calls = 0;
 
 #ifdef DEBUG_ENABLED
+	// Script requests still pending here were raised by a script that returned to the
+	// engine before reaching a safe point, so they are charged to the engine as well.
+	sample_poll();
+	_take_engine_samples();
+
 	if (profiling) {
 		MutexLock lock(this->lock);
 
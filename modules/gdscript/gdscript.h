@@ -37,8 +37,10 @@
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/object/script_language.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_set.h"
 #include "gdscript_function.h"
+#include "gdscript_sampling_profiler.h"
 
 class GDScriptNativeClass : public RefCounted {
 	GDCLASS(GDScriptNativeClass, RefCounted);
@@ -350,14 +352,56 @@ class GDScriptLanguage : public ScriptLanguage {
 	friend class GDScriptFunction;
 
 	SelfList<GDScriptFunction>::List function_list;
+
+	// Heap stacks of coroutines suspended by `await`, recycled once they complete.
+	// Bucketed by power of two size. Guarded by `lock`.
+	enum {
+		AWAIT_STACK_POOL_BUCKETS = 24,
+		AWAIT_STACK_POOL_MAX_PER_BUCKET = 256,
+	};
+	LocalVector<Vector<uint8_t>> await_stack_pool[AWAIT_STACK_POOL_BUCKETS];
+
+	Vector<uint8_t> _acquire_await_stack(uint32_t p_size);
+	void _release_await_stack(Vector<uint8_t> &r_stack);
+
 	bool profiling;
 	uint64_t script_frame_time;
 
+	Ref<GDScriptSamplingProfiler> sampling_profiler;
+	friend class GDScriptSamplingProfiler;
+	GDScriptSamplingProfiler *active_sampler = nullptr; // Set by the profiler while it samples.
+	void _take_sample();
+	void _take_engine_samples();
+
 	HashMap<String, ObjectID> orphan_subclasses;
 
 public:
 	int calls;
 
+	// Pending sample requests from the sampling profiler thread, split by whether a script was
+	// executing on the main thread when they were raised.
+	SafeNumeric<uint32_t> sample_requests;
+	SafeNumeric<uint32_t> engine_sample_requests;
+	// Depth of the main thread's call stack, read by the sampling profiler thread.
+	SafeNumeric<uint32_t> sample_call_depth;
+
+	// Called by the sampling profiler thread. Requests raised outside scripts are charged to the
+	// engine, not to whichever script line runs next.
+	_FORCE_INLINE_ void request_sample() {
+		if (sample_call_depth.get() > 0) {
+			sample_requests.increment();
+		} else {
+			engine_sample_requests.increment();
+		}
+	}
+
+	// Called at safe points; records the current call stack if the sampling profiler asked for it.
+	_FORCE_INLINE_ void sample_poll() {
+		if (unlikely(sample_requests.get() > 0)) {
+			_take_sample();
+		}
+	}
+
 	bool debug_break(const String &p_error, bool p_allow_continue = true);
 	bool debug_break_parse(const String &p_file, int p_line, const String &p_error);
 
@@ -377,12 +421,16 @@ public:
 			return;
 		}
 
+		// Requests raised in a native call of the caller belong to the caller's line.
+		sample_poll();
+
 		_call_stack[_debug_call_stack_pos].stack = p_stack;
 		_call_stack[_debug_call_stack_pos].instance = p_instance;
 		_call_stack[_debug_call_stack_pos].function = p_function;
 		_call_stack[_debug_call_stack_pos].ip = p_ip;
 		_call_stack[_debug_call_stack_pos].line = p_line;
 		_debug_call_stack_pos++;
+		sample_call_depth.set(_debug_call_stack_pos);
 	}
 
 	_FORCE_INLINE_ void exit_function() {
@@ -400,7 +448,11 @@ public:
 			return;
 		}
 
+		// Requests raised since the last line still belong to the returning function.
+		sample_poll();
+
 		_debug_call_stack_pos--;
+		sample_call_depth.set(_debug_call_stack_pos);
 	}
 
 	virtual Vector<StackInfo> debug_get_current_stack_info() override {
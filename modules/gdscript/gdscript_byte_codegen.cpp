@@ -214,10 +214,13 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 			function->global_names.write[E.value] = E.key;
 		}
 		function->_global_names_count = function->global_names.size();
+		function->lookup_caches.resize(name_map.size());
+		function->_lookup_caches_ptr = function->lookup_caches.ptrw();
 
 	} else {
 		function->_global_names_ptr = nullptr;
 		function->_global_names_count = 0;
+		function->_lookup_caches_ptr = nullptr;
 	}
 
 	if (opcodes.size()) {
@@ -164,23 +164,12 @@ GDScriptFunction::~GDScriptFunction() {
 /////////////////////
 
 Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
-	Variant arg;
 	r_error.error = Callable::CallError::CALL_OK;
 
 	if (p_argcount == 0) {
 		r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
 		r_error.argument = 1;
 		return Variant();
-	} else if (p_argcount == 1) {
-		//noooneee
-	} else if (p_argcount == 2) {
-		arg = *p_args[0];
-	} else {
-		Array extra_args;
-		for (int i = 0; i < p_argcount - 1; i++) {
-			extra_args.push_back(*p_args[i]);
-		}
-		arg = extra_args;
 	}
 
 	Ref<GDScriptFunctionState> self = *p_args[p_argcount - 1];
@@ -192,6 +181,24 @@ Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_ar
 		return Variant();
 	}
 
+	return _resume_from_signal(p_args, p_argcount - 1);
+}
+
+Variant GDScriptFunctionState::_resume_from_signal(const Variant **p_args, int p_argcount) {
+	Variant arg;
+
+	if (p_argcount == 0) {
+		//noooneee
+	} else if (p_argcount == 1) {
+		arg = *p_args[0];
+	} else {
+		Array extra_args;
+		for (int i = 0; i < p_argcount; i++) {
+			extra_args.push_back(*p_args[i]);
+		}
+		arg = extra_args;
+	}
+
 	return resume(arg);
 }
 
@@ -272,7 +279,12 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 		}
 
 		_clear_stack();
+#else
+		state.stack_size = 0; // Already freed by the function when it returned.
 #endif
+
+		MutexLock lock(GDScriptLanguage::singleton->lock);
+		GDScriptLanguage::singleton->_release_await_stack(state.stack);
 	}
 
 	return ret;
@@ -297,6 +309,48 @@ void GDScriptFunctionState::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("completed", PropertyInfo(Variant::NIL, "result", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NIL_IS_VARIANT)));
 }
 
+bool GDScriptFunctionStateCallable::compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+	// Resume callables are only compared by reference.
+	return p_a == p_b;
+}
+
+bool GDScriptFunctionStateCallable::compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+	// Resume callables are only compared by reference.
+	return p_a < p_b;
+}
+
+uint32_t GDScriptFunctionStateCallable::hash() const {
+	return h;
+}
+
+String GDScriptFunctionStateCallable::get_as_text() const {
+	return "GDScriptFunctionState::_signal_callback";
+}
+
+CallableCustom::CompareEqualFunc GDScriptFunctionStateCallable::get_compare_equal_func() const {
+	return compare_equal;
+}
+
+CallableCustom::CompareLessFunc GDScriptFunctionStateCallable::get_compare_less_func() const {
+	return compare_less;
+}
+
+ObjectID GDScriptFunctionStateCallable::get_object() const {
+	return state->get_instance_id();
+}
+
+void GDScriptFunctionStateCallable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const {
+	r_call_error.error = Callable::CallError::CALL_OK;
+	// Keep the state alive while resuming, as the connection holding this callable may be released meanwhile.
+	Ref<GDScriptFunctionState> self = state;
+	r_return_value = self->_resume_from_signal(p_arguments, p_argcount);
+}
+
+GDScriptFunctionStateCallable::GDScriptFunctionStateCallable(const Ref<GDScriptFunctionState> &p_state) {
+	state = p_state;
+	h = (uint32_t)hash_murmur3_one_64((uint64_t)this);
+}
+
 GDScriptFunctionState::GDScriptFunctionState() :
 		scripts_list(this),
 		instances_list(this) {
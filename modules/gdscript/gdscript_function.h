@@ -440,6 +440,7 @@ private:
 	int _constant_count = 0;
 	const StringName *_global_names_ptr = nullptr;
 	int _global_names_count = 0;
+	ObjectLookupCache *_lookup_caches_ptr = nullptr; // One per global name, for dynamic calls and property access.
 	const int *_default_arg_ptr = nullptr;
 	int _default_arg_count = 0;
 	int _operator_funcs_count = 0;
@@ -484,6 +485,7 @@ private:
 	StringName name;
 	Vector<Variant> constants;
 	Vector<StringName> global_names;
+	Vector<ObjectLookupCache> lookup_caches;
 	Vector<int> default_arguments;
 	Vector<Variant::ValidatedOperatorEvaluator> operator_funcs;
 	Vector<Variant::ValidatedSetter> setters;
@@ -607,9 +609,11 @@ public:
 class GDScriptFunctionState : public RefCounted {
 	GDCLASS(GDScriptFunctionState, RefCounted);
 	friend class GDScriptFunction;
+	friend class GDScriptFunctionStateCallable;
 	GDScriptFunction *function = nullptr;
 	GDScriptFunction::CallState state;
 	Variant _signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+	Variant _resume_from_signal(const Variant **p_args, int p_argcount);
 	Ref<GDScriptFunctionState> first_state;
 
 	SelfList<GDScriptFunctionState> scripts_list;
@@ -628,4 +632,25 @@ public:
 	~GDScriptFunctionState();
 };
 
+// Resumes a function state when the awaited signal is emitted. Holds the state directly,
+// so no method lookup or argument binding is needed per `await`.
+class GDScriptFunctionStateCallable : public CallableCustom {
+	Ref<GDScriptFunctionState> state;
+	uint32_t h;
+
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b);
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b);
+
+public:
+	uint32_t hash() const override;
+	String get_as_text() const override;
+	CompareEqualFunc get_compare_equal_func() const override;
+	CompareLessFunc get_compare_less_func() const override;
+	ObjectID get_object() const override;
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override;
+
+	GDScriptFunctionStateCallable(const Ref<GDScriptFunctionState> &p_state);
+	virtual ~GDScriptFunctionStateCallable() = default;
+};
+
 #endif // GDSCRIPT_FUNCTION_H
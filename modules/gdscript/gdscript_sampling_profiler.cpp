@@ -0,0 +1,167 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "core/config/engine.h"
+#include "core/debugger/engine_debugger.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+#include "gdscript.h"
+
+void GDScriptSamplingProfiler::_thread_func(void *p_user) {
+	GDScriptSamplingProfiler *profiler = static_cast<GDScriptSamplingProfiler *>(p_user);
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+
+	while (!profiler->exit_thread.is_set()) {
+		// Sleep in slices, so long intervals don't delay stopping.
+		uint64_t remaining = profiler->interval_usec;
+		while (remaining > 0 && !profiler->exit_thread.is_set()) {
+			uint64_t slice = MIN(remaining, (uint64_t)MAX_SLEEP_SLICE_USEC);
+			OS::get_singleton()->delay_usec(slice);
+			remaining -= slice;
+		}
+		if (remaining == 0) {
+			language->request_sample();
+		}
+	}
+}
+
+void GDScriptSamplingProfiler::add_sample(const String &p_folded_stack, uint32_t p_count) {
+	HashMap<String, uint64_t>::Iterator E = frame_samples.find(p_folded_stack);
+	if (E) {
+		E->value += p_count;
+	} else {
+		frame_samples.insert(p_folded_stack, p_count);
+	}
+}
+
+uint64_t GDScriptSamplingProfiler::get_sample_count(const String &p_folded_stack) const {
+	const uint64_t *count = total_samples.getptr(p_folded_stack);
+	return count ? *count : 0;
+}
+
+Error GDScriptSamplingProfiler::save_folded(const String &p_path) const {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Can't save GDScript samples to file: '" + p_path + "'.");
+
+	for (const KeyValue<String, uint64_t> &E : total_samples) {
+		f->store_line(E.key + " " + itos(E.value));
+	}
+	return OK;
+}
+
+void GDScriptSamplingProfiler::start(uint64_t p_interval_usec) {
+	if (thread.is_started()) {
+		stop();
+	}
+
+	frame_samples.clear();
+	total_samples.clear();
+	total_sample_count = 0;
+	interval_usec = MAX(p_interval_usec, (uint64_t)100);
+
+	// Discard requests left over from a previous session.
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	language->sample_requests.set(0);
+	language->engine_sample_requests.set(0);
+	language->active_sampler = this;
+
+	exit_thread.clear();
+	thread.start(_thread_func, this);
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!thread.is_started()) {
+		return;
+	}
+
+	exit_thread.set();
+	thread.wait_to_finish();
+
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	language->sample_requests.set(0);
+	language->engine_sample_requests.set(0);
+	if (language->active_sampler == this) {
+		language->active_sampler = nullptr;
+	}
+}
+
+void GDScriptSamplingProfiler::toggle(bool p_enable, const Array &p_opts) {
+	if (p_enable) {
+		// Options: [interval_usec, output_path].
+		uint64_t interval = 1000;
+		if (p_opts.size() > 0 && p_opts[0].get_type() == Variant::INT) {
+			interval = MAX(0, int64_t(p_opts[0]));
+		}
+		output_path = p_opts.size() > 1 ? String(p_opts[1]) : String();
+		start(interval);
+	} else {
+		stop();
+		tick(0, 0, 0, 0); // Flush pending samples.
+		if (!output_path.is_empty()) {
+			save_folded(output_path);
+		}
+	}
+}
+
+void GDScriptSamplingProfiler::tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) {
+	if (frame_samples.is_empty()) {
+		return;
+	}
+
+	Array arr;
+	arr.resize(2 + frame_samples.size() * 2);
+	arr[0] = Engine::get_singleton()->get_process_frames();
+	arr[1] = interval_usec;
+	int idx = 2;
+	for (const KeyValue<String, uint64_t> &E : frame_samples) {
+		arr[idx++] = E.key;
+		arr[idx++] = E.value;
+
+		HashMap<String, uint64_t>::Iterator T = total_samples.find(E.key);
+		if (T) {
+			T->value += E.value;
+		} else {
+			total_samples.insert(E.key, E.value);
+		}
+		total_sample_count += E.value;
+	}
+	frame_samples.clear();
+
+	if (EngineDebugger::get_singleton()) {
+		EngineDebugger::get_singleton()->send_message("gdscript_sampler:frame", arr);
+	}
+}
+
+GDScriptSamplingProfiler::~GDScriptSamplingProfiler() {
+	stop();
+}
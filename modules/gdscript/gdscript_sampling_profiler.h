@@ -0,0 +1,86 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/debugger/engine_profiler.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/safe_refcount.h"
+
+// Statistical profiler for GDScript.
+//
+// A background thread requests a sample every `interval` microseconds. Requests are
+// serviced by the main thread at the next safe point (a script line boundary, a call or
+// return, or the end of the frame), where the current GDScript call stack is recorded.
+// Requests raised while no script was executing are attributed to a single `[engine]`
+// frame when the frame ends, and time spent in native calls made from a script line is
+// attributed to that line. No timing is done per call, so the cost while idle is a
+// single atomic load per executed line.
+//
+// Samples are streamed to the debugger every frame as `gdscript_sampler:frame`
+// messages, and can be written in the folded stack format understood by most
+// flame graph tools (`frame;frame;frame count`).
+class GDScriptSamplingProfiler : public EngineProfiler {
+	enum {
+		MAX_SLEEP_SLICE_USEC = 10000,
+	};
+
+	Thread thread;
+	SafeFlag exit_thread;
+	uint64_t interval_usec = 1000;
+	String output_path;
+
+	HashMap<String, uint64_t> frame_samples;
+	HashMap<String, uint64_t> total_samples;
+	uint64_t total_sample_count = 0;
+
+	static void _thread_func(void *p_user);
+
+public:
+	void add_sample(const String &p_folded_stack, uint32_t p_count);
+
+	uint64_t get_sample_count(const String &p_folded_stack) const; // Samples counted up to the last tick.
+	Error save_folded(const String &p_path) const;
+	uint64_t get_total_sample_count() const { return total_sample_count; }
+	uint64_t get_interval_usec() const { return interval_usec; }
+	bool is_sampling() const { return thread.is_started(); }
+
+	void start(uint64_t p_interval_usec);
+	void stop();
+
+	virtual void toggle(bool p_enable, const Array &p_opts) override;
+	virtual void tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) override;
+
+	~GDScriptSamplingProfiler();
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -495,6 +495,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 	uint32_t alloca_size = 0;
+	bool stack_moved = false;
 	GDScript *script;
 	int ip = 0;
 	int line = _initial_line;
@@ -995,7 +996,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				const StringName *index = &_global_names_ptr[indexname];
 
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				dst->set_named(*index, *value, valid, _lookup_caches_ptr[indexname]);
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -1037,10 +1038,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				bool valid;
 #ifdef DEBUG_ENABLED
 				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+				Variant ret = src->get_named(*index, valid, _lookup_caches_ptr[indexname]);
 
 #else
-				*dst = src->get_named(*index, valid);
+				*dst = src->get_named(*index, valid, _lookup_caches_ptr[indexname]);
 #endif
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -1077,9 +1078,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				bool valid;
 #ifndef DEBUG_ENABLED
-				ClassDB::set_property(p_instance->owner, *index, *src, &valid);
+				ClassDB::set_property(p_instance->owner, *index, *src, &valid, &_lookup_caches_ptr[indexname]);
 #else
-				bool ok = ClassDB::set_property(p_instance->owner, *index, *src, &valid);
+				bool ok = ClassDB::set_property(p_instance->owner, *index, *src, &valid, &_lookup_caches_ptr[indexname]);
 				if (!ok) {
 					err_text = "Internal error setting property: " + String(*index);
 					OPCODE_BREAK;
@@ -1099,9 +1100,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 #ifndef DEBUG_ENABLED
-				ClassDB::get_property(p_instance->owner, *index, *dst);
+				ClassDB::get_property(p_instance->owner, *index, *dst, &_lookup_caches_ptr[indexname]);
 #else
-				bool ok = ClassDB::get_property(p_instance->owner, *index, *dst);
+				bool ok = ClassDB::get_property(p_instance->owner, *index, *dst, &_lookup_caches_ptr[indexname]);
 				if (!ok) {
 					err_text = "Internal error getting property: " + String(*index);
 					OPCODE_BREAK;
@@ -1533,7 +1534,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err, _lookup_caches_ptr[methodname_idx]);
 #ifdef DEBUG_ENABLED
 					if (!call_async && ret->get_type() == Variant::OBJECT) {
 						// Check if getting a function state without await.
@@ -1552,7 +1553,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				} else {
 					Variant ret;
-					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err, _lookup_caches_ptr[methodname_idx]);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -2204,19 +2205,16 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 					gdfs->function = this;
 
-					gdfs->state.stack.resize(alloca_size);
-
-					// First 3 stack addresses are special, so we just skip them here.
-					for (int i = 3; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
-					}
-					gdfs->state.stack_size = _stack_size;
-					gdfs->state.alloca_size = alloca_size;
-					gdfs->state.ip = ip + 2;
-					gdfs->state.line = line;
-					gdfs->state.script = _script;
 					{
 						MutexLock lock(GDScriptLanguage::get_singleton()->lock);
+						if (p_state) {
+							// Resumed coroutine awaiting again: hand over the heap stack we are already running on.
+							gdfs->state.stack = p_state->stack;
+							p_state->stack = Vector<uint8_t>();
+							p_state->stack_size = 0;
+						} else {
+							gdfs->state.stack = GDScriptLanguage::get_singleton()->_acquire_await_stack(alloca_size);
+						}
 						_script->pending_func_states.add(&gdfs->scripts_list);
 						if (p_instance) {
 							gdfs->state.instance = p_instance;
@@ -2225,6 +2223,19 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 							gdfs->state.instance = nullptr;
 						}
 					}
+
+					if (!p_state) {
+						// Variants are relocatable, so move them out of the native stack instead of copying them.
+						// First 3 stack addresses are special, so we just skip them here.
+						memcpy(&gdfs->state.stack.ptrw()[sizeof(Variant) * 3], (void *)&stack[3], sizeof(Variant) * (_stack_size - 3));
+					}
+					stack_moved = true;
+
+					gdfs->state.stack_size = _stack_size;
+					gdfs->state.alloca_size = alloca_size;
+					gdfs->state.ip = ip + 2;
+					gdfs->state.line = line;
+					gdfs->state.script = _script;
 #ifdef DEBUG_ENABLED
 					gdfs->state.function_name = name;
 					gdfs->state.script_path = _script->get_path();
@@ -2234,7 +2245,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 					retvalue = gdfs;
 
-					Error err = sig.connect(Callable(gdfs.ptr(), "_signal_callback").bind(retvalue), Object::CONNECT_ONE_SHOT);
+					Error err = sig.connect(Callable(memnew(GDScriptFunctionStateCallable(gdfs))), Object::CONNECT_ONE_SHOT);
 					if (err != OK) {
 						err_text = "Error connecting to signal: " + sig.get_name() + " during await.";
 						OPCODE_BREAK;
@@ -3390,6 +3401,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_LINE) {
 				CHECK_SPACE(2);
 
+#ifdef DEBUG_ENABLED
+				if (EngineDebugger::is_active()) {
+					// Sample before the line changes, so native calls are attributed to the line that made them.
+					GDScriptLanguage::get_singleton()->sample_poll();
+				}
+#endif
+
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
@@ -3492,9 +3510,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		}
 #endif
 
-		// Free stack, except reserved addresses.
-		for (int i = 3; i < _stack_size; i++) {
-			stack[i].~Variant();
+		// Free stack, except reserved addresses. If the function awaited, the state owns them now.
+		if (!stack_moved) {
+			for (int i = 3; i < _stack_size; i++) {
+				stack[i].~Variant();
+			}
 		}
 #ifdef DEBUG_ENABLED
 	}
@@ -0,0 +1,20 @@
+# Resuming the same coroutine several times must keep its locals intact.
+
+signal resumed(value)
+signal resumed_twice(a, b)
+
+var events = []
+
+
+func coroutine():
+	var kept = "kept"
+	events.append(await resumed)
+	events.append(await resumed_twice)
+	events.append(kept)
+
+
+func test():
+	coroutine()
+	resumed.emit(1)
+	resumed_twice.emit(2, 3)
+	print(events)
@@ -0,0 +1,86 @@
+/*************************************************************************/
+/*  test_gdscript_sampling_profiler.h                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GDSCRIPT_SAMPLING_PROFILER_H
+#define TEST_GDSCRIPT_SAMPLING_PROFILER_H
+
+#ifdef DEBUG_ENABLED
+
+#include "../gdscript.h"
+#include "../gdscript_sampling_profiler.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+TEST_CASE("[Modules][GDScript] Attributing sampling profiler requests") {
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	Ref<GDScriptSamplingProfiler> profiler;
+	profiler.instantiate();
+	profiler->start(3600000000); // Long enough for the thread to never request a sample itself.
+
+	SUBCASE("Requests raised outside scripts are charged to the engine") {
+		language->request_sample();
+		language->request_sample();
+		// Not left for the next script line to take.
+		CHECK(language->sample_requests.get() == 0);
+		CHECK(language->engine_sample_requests.get() == 2);
+
+		language->frame();
+		profiler->tick(0, 0, 0, 0);
+		CHECK(language->engine_sample_requests.get() == 0);
+		CHECK(profiler->get_sample_count("[engine]") == 2);
+		CHECK(profiler->get_total_sample_count() == 2);
+	}
+
+	SUBCASE("Requests raised while a script is executing are left for the script") {
+		language->sample_call_depth.set(1); // As if raised while in a script function.
+		language->request_sample();
+		language->sample_call_depth.set(0);
+		CHECK(language->sample_requests.get() == 1);
+		CHECK(language->engine_sample_requests.get() == 0);
+
+		// Taken at the end of the frame if the script never reached a safe point.
+		language->frame();
+		profiler->tick(0, 0, 0, 0);
+		CHECK(language->sample_requests.get() == 0);
+		CHECK(profiler->get_sample_count("[engine]") == 1);
+	}
+
+	profiler->stop();
+	CHECK(language->sample_requests.get() == 0);
+	CHECK(language->engine_sample_requests.get() == 0);
+}
+
+} // namespace GDScriptTests
+
+#endif // DEBUG_ENABLED
+
+#endif // TEST_GDSCRIPT_SAMPLING_PROFILER_H
@@ -30,7 +30,7 @@
 
 #include "nav_map.h"
 
-#include "core/object/worker_thread_pool.h"
+#include "core/templates/parallel.h"
 #include "nav_link.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
@@ -827,8 +827,13 @@ void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 	if (controlled_agents.size() > 0) {
-		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_step, controlled_agents.ptr(), controlled_agents.size(), -1, true, SNAME("NavigationMapAgents"));
-		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		// A few agents per chunk, so small crowds are simulated right away instead of going through the pool.
+		Parallel::for_range(0, controlled_agents.size(), [&](uint32_t p_from, uint32_t p_to) {
+			for (uint32_t i = p_from; i < p_to; i++) {
+				compute_single_step(i, controlled_agents.ptr());
+			}
+		},
+				8);
 	}
 }
 
@@ -69,6 +69,7 @@ Variant JavaClass::callp(const StringName &, const Variant **, int, Callable::Ca
 }
 
 JavaClass::JavaClass() {
+	_set_custom_callp();
 }
 
 Variant JavaObject::callp(const StringName &, const Variant **, int, Callable::CallError &) {
@@ -216,6 +216,7 @@ public:
 #endif
 
 	JNISingleton() {
+		_set_custom_callp();
 #ifdef ANDROID_ENABLED
 		instance = nullptr;
 #endif
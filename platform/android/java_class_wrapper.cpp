@@ -496,6 +496,7 @@ Variant JavaClass::callp(const StringName &p_method, const Variant **p_args, int
 }
 
 JavaClass::JavaClass() {
+	_set_custom_callp();
 }
 
 /////////////////////
@@ -505,6 +506,7 @@ Variant JavaObject::callp(const StringName &p_method, const Variant **p_args, in
 }
 
 JavaObject::JavaObject(const Ref<JavaClass> &p_base, jobject *p_instance) {
+	_set_custom_callp();
 }
 
 JavaObject::~JavaObject() {
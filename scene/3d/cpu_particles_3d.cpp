@@ -30,6 +30,7 @@
 
 #include "cpu_particles_3d.h"
 
+#include "core/math/math_batch.h"
 #include "scene/3d/camera_3d.h"
 #include "scene/3d/gpu_particles_3d.h"
 #include "scene/main/viewport.h"
@@ -1294,29 +1295,15 @@ void CPUParticles3D::_notification(int p_what) {
 
 				float *w = particle_data.ptrw();
 				const Particle *r = particles.ptr();
-				float *ptr = w;
+
+				if (pc > 0) {
+					MathBatch::multiply_transforms_to_3x4(inv_emission_transform, &r[0].transform, sizeof(Particle), w, 20, pc);
+				}
 
 				for (int i = 0; i < pc; i++) {
-					Transform3D t = inv_emission_transform * r[i].transform;
-
-					if (r[i].active) {
-						ptr[0] = t.basis.rows[0][0];
-						ptr[1] = t.basis.rows[0][1];
-						ptr[2] = t.basis.rows[0][2];
-						ptr[3] = t.origin.x;
-						ptr[4] = t.basis.rows[1][0];
-						ptr[5] = t.basis.rows[1][1];
-						ptr[6] = t.basis.rows[1][2];
-						ptr[7] = t.origin.y;
-						ptr[8] = t.basis.rows[2][0];
-						ptr[9] = t.basis.rows[2][1];
-						ptr[10] = t.basis.rows[2][2];
-						ptr[11] = t.origin.z;
-					} else {
-						memset(ptr, 0, sizeof(float) * 12);
+					if (!r[i].active) {
+						memset(w + i * 20, 0, sizeof(float) * 12);
 					}
-
-					ptr += 20;
 				}
 
 				can_update.set();
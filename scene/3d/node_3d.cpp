@@ -31,6 +31,7 @@
 #include "node_3d.h"
 
 #include "core/object/message_queue.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/3d/visual_instance_3d.h"
 #include "scene/main/viewport.h"
 #include "scene/property_utils.h"
@@ -46,7 +47,9 @@
 
  1) If a node sets a LOCAL, it produces an invalidation of everything above
  .  a) If above is invalid, don't keep invalidating upwards
+ .  b) A subtree invalidated since the last transform flush is already queued, so it is not walked again
  2) If a node sets a GLOBAL, it is converted to LOCAL (and forces validation of everything pending below)
+ 3) When flushing notifications, all invalid globals are validated at once, ordered by depth
 
  drawback: setting/reading globals is useful and used very often, and using affine inverses is slow
 
@@ -74,6 +77,9 @@ Node3DGizmo::Node3DGizmo() {
 }
 
 void Node3D::_notify_dirty() {
+	if (!is_inside_tree()) {
+		return; // May have been deferred from another thread.
+	}
 #ifdef TOOLS_ENABLED
 	if ((!data.gizmos.is_empty() || data.notify_transform) && !data.ignore_notification && !xform_change.in_list()) {
 #else
@@ -101,11 +107,27 @@ void Node3D::_update_rotation_and_scale() const {
 	data.dirty &= ~DIRTY_EULER_ROTATION_AND_SCALE;
 }
 
+void Node3D::_invalidate_propagation_pass() {
+	// Subtrees made dirty earlier assumed this node did not want to be notified,
+	// so they must be walked again when their transform changes.
+	if (is_inside_tree() && (data.dirty & DIRTY_GLOBAL_TRANSFORM)) {
+		get_tree()->xform_propagation_pass.increment();
+	}
+}
+
 void Node3D::_propagate_transform_changed(Node3D *p_origin) {
 	if (!is_inside_tree()) {
 		return;
 	}
 
+	SceneTree *tree = get_tree();
+	bool is_main_thread = Thread::get_caller_id() == Thread::get_main_id();
+	uint64_t pass = tree->xform_propagation_pass.get();
+
+	if (is_main_thread && (data.dirty & DIRTY_GLOBAL_TRANSFORM) && data.propagation_pass == pass) {
+		return; // Whole subtree is already dirty and queued for notification.
+	}
+
 	data.children_lock++;
 
 	for (Node3D *&E : data.children) {
@@ -119,13 +141,84 @@ void Node3D::_propagate_transform_changed(Node3D *p_origin) {
 #else
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+		if (is_main_thread) {
+			tree->xform_change_list.add(&xform_change);
+		} else {
+			// The list is only safe to modify from the main thread (i.e. when processing a thread group).
+			MessageQueue::get_singleton()->push_callable(callable_mp(this, &Node3D::_notify_dirty));
+		}
 	}
 	data.dirty |= DIRTY_GLOBAL_TRANSFORM;
+	data.propagation_pass = is_main_thread ? pass : 0;
 
 	data.children_lock--;
 }
 
+LocalVector<Node3D *> Node3D::global_transform_batch;
+LocalVector<Node3D *> Node3D::global_transform_levels;
+LocalVector<uint32_t> Node3D::global_transform_level_offsets;
+
+void Node3D::_update_global_transform_group(void *p_nodes, uint32_t p_index) {
+	// Parents were updated in a previous level, so this does not recurse.
+	static_cast<Node3D **>(p_nodes)[p_index]->_update_global_transform();
+}
+
+void Node3D::_update_global_transforms(const SelfList<Node>::List &p_list) {
+	// Collect every dirty global transform the queued nodes depend on, including
+	// ancestors that are not queued for notification themselves.
+	int max_depth = -1;
+	for (const SelfList<Node> *E = p_list.first(); E; E = E->next()) {
+		Node3D *node = Object::cast_to<Node3D>(E->self());
+		while (node && (node->data.dirty & DIRTY_GLOBAL_TRANSFORM) && !node->data.global_transform_batched) {
+			node->data.global_transform_batched = true;
+			global_transform_batch.push_back(node);
+			max_depth = MAX(max_depth, node->data.depth);
+			node = node->data.top_level_active ? nullptr : node->data.parent;
+		}
+	}
+
+	if (global_transform_batch.is_empty()) {
+		return;
+	}
+
+	// Sort by depth, so each level only depends on the previous ones.
+	global_transform_level_offsets.resize(max_depth + 2);
+	for (uint32_t i = 0; i < global_transform_level_offsets.size(); i++) {
+		global_transform_level_offsets[i] = 0;
+	}
+	for (uint32_t i = 0; i < global_transform_batch.size(); i++) {
+		global_transform_level_offsets[global_transform_batch[i]->data.depth + 1]++;
+	}
+	for (int i = 0; i <= max_depth; i++) {
+		global_transform_level_offsets[i + 1] += global_transform_level_offsets[i];
+	}
+	global_transform_levels.resize(global_transform_batch.size());
+	for (uint32_t i = 0; i < global_transform_batch.size(); i++) {
+		Node3D *node = global_transform_batch[i];
+		global_transform_levels[global_transform_level_offsets[node->data.depth]++] = node;
+		node->data.global_transform_batched = false;
+	}
+	global_transform_batch.clear();
+
+	// Offsets were advanced to the end of each level while filling it.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	uint32_t from = 0;
+	for (int i = 0; i <= max_depth; i++) {
+		uint32_t to = global_transform_level_offsets[i];
+		uint32_t count = to - from;
+		if (count >= GLOBAL_TRANSFORM_PARALLEL_THRESHOLD && pool && pool->get_thread_count() > 1) {
+			WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&Node3D::_update_global_transform_group, global_transform_levels.ptr() + from, count);
+			pool->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t j = from; j < to; j++) {
+				global_transform_levels[j]->_update_global_transform();
+			}
+		}
+		from = to;
+	}
+	global_transform_levels.clear();
+}
+
 void Node3D::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_ENTER_TREE: {
@@ -138,9 +231,12 @@ void Node3D::_notification(int p_what) {
 
 			if (data.parent) {
 				data.C = data.parent->data.children.push_back(this);
+				data.depth = data.parent->data.depth + 1;
 			} else {
 				data.C = nullptr;
+				data.depth = 0;
 			}
+			data.propagation_pass = 0;
 
 			if (data.top_level && !Engine::get_singleton()->is_editor_hint()) {
 				if (data.parent) {
@@ -173,12 +269,8 @@ void Node3D::_notification(int p_what) {
 
 		case NOTIFICATION_ENTER_WORLD: {
 			data.inside_world = true;
-			data.viewport = nullptr;
-			Node *parent = get_parent();
-			while (parent && !data.viewport) {
-				data.viewport = Object::cast_to<Viewport>(parent);
-				parent = parent->get_parent();
-			}
+			// Node already resolved the closest viewport when entering the tree.
+			data.viewport = get_viewport();
 
 			ERR_FAIL_COND(!data.viewport);
 
@@ -296,25 +388,31 @@ Transform3D Node3D::get_transform() const {
 
 	return data.local_transform;
 }
-Transform3D Node3D::get_global_transform() const {
-	ERR_FAIL_COND_V(!is_inside_tree(), Transform3D());
+void Node3D::_update_global_transform() const {
+	// This function is called when the global transform is dirty, parents are updated first if needed.
 
-	if (data.dirty & DIRTY_GLOBAL_TRANSFORM) {
-		if (data.dirty & DIRTY_LOCAL_TRANSFORM) {
-			_update_local_transform();
-		}
+	if (data.dirty & DIRTY_LOCAL_TRANSFORM) {
+		_update_local_transform();
+	}
 
-		if (data.parent && !data.top_level_active) {
-			data.global_transform = data.parent->get_global_transform() * data.local_transform;
-		} else {
-			data.global_transform = data.local_transform;
-		}
+	if (data.parent && !data.top_level_active) {
+		data.global_transform = data.parent->get_global_transform() * data.local_transform;
+	} else {
+		data.global_transform = data.local_transform;
+	}
 
-		if (data.disable_scale) {
-			data.global_transform.basis.orthonormalize();
-		}
+	if (data.disable_scale) {
+		data.global_transform.basis.orthonormalize();
+	}
 
-		data.dirty &= ~DIRTY_GLOBAL_TRANSFORM;
+	data.dirty &= ~DIRTY_GLOBAL_TRANSFORM;
+}
+
+Transform3D Node3D::get_global_transform() const {
+	ERR_FAIL_COND_V(!is_inside_tree(), Transform3D());
+
+	if (data.dirty & DIRTY_GLOBAL_TRANSFORM) {
+		_update_global_transform();
 	}
 
 	return data.global_transform;
@@ -531,6 +629,7 @@ void Node3D::add_gizmo(Ref<Node3DGizmo> p_gizmo) {
 		return;
 	}
 	data.gizmos.push_back(p_gizmo);
+	_invalidate_propagation_pass();
 
 	if (p_gizmo.is_valid() && is_inside_world()) {
 		p_gizmo->create();
@@ -810,6 +909,9 @@ Vector3 Node3D::to_global(Vector3 p_local) const {
 }
 
 void Node3D::set_notify_transform(bool p_enabled) {
+	if (!data.notify_transform && p_enabled) {
+		_invalidate_propagation_pass();
+	}
 	data.notify_transform = p_enabled;
 }
 
@@ -831,6 +933,7 @@ void Node3D::force_update_transform() {
 		return; //nothing to update
 	}
 	get_tree()->xform_change_list.remove(&xform_change);
+	get_tree()->xform_propagation_pass.increment();
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
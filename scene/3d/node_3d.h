@@ -115,6 +115,9 @@ private:
 		RID visibility_parent;
 
 		int children_lock = 0;
+		int depth = 0; // Among Node3D ancestors, used to update parents before their children.
+		uint64_t propagation_pass = 0; // Set when this subtree was made dirty, see SceneTree::xform_propagation_pass.
+		bool global_transform_batched = false;
 		Node3D *parent = nullptr;
 		List<Node3D *> children;
 		List<Node3D *>::Element *C = nullptr;
@@ -139,18 +142,36 @@ private:
 
 	void _update_gizmos();
 	void _notify_dirty();
+	void _invalidate_propagation_pass();
 	void _propagate_transform_changed(Node3D *p_origin);
 
+	enum {
+		GLOBAL_TRANSFORM_PARALLEL_THRESHOLD = 1024, // Depth levels with fewer dirty nodes are updated on the calling thread.
+	};
+
+	friend class SceneTree;
+	static LocalVector<Node3D *> global_transform_batch;
+	static LocalVector<Node3D *> global_transform_levels;
+	static LocalVector<uint32_t> global_transform_level_offsets;
+	static void _update_global_transform_group(void *p_nodes, uint32_t p_index);
+	static void _update_global_transforms(const SelfList<Node>::List &p_list);
+
 	void _propagate_visibility_changed();
 
 	void _propagate_visibility_parent();
 	void _update_visibility_parent(bool p_update_root);
 
 protected:
-	_FORCE_INLINE_ void set_ignore_transform_notification(bool p_ignore) { data.ignore_notification = p_ignore; }
+	_FORCE_INLINE_ void set_ignore_transform_notification(bool p_ignore) {
+		if (data.ignore_notification && !p_ignore) {
+			_invalidate_propagation_pass();
+		}
+		data.ignore_notification = p_ignore;
+	}
 
 	_FORCE_INLINE_ void _update_local_transform() const;
 	_FORCE_INLINE_ void _update_rotation_and_scale() const;
+	void _update_global_transform() const;
 
 	void _notification(int p_what);
 	static void _bind_methods();
@@ -52,6 +52,76 @@ void VisualInstance3D::_update_visibility() {
 	RS::get_singleton()->instance_set_visible(get_instance(), is_visible_in_tree());
 }
 
+int VisualInstance3D::server_batch_depth = 0;
+uint64_t VisualInstance3D::server_batch_pass = 1;
+uint32_t VisualInstance3D::transform_batch_removed = 0;
+LocalVector<RID> VisualInstance3D::transform_batch_instances;
+LocalVector<Transform3D> VisualInstance3D::transform_batch_transforms;
+
+void VisualInstance3D::_flush_server_batch() {
+	if (transform_batch_removed > 0) {
+		// Drop the entries of instances freed during the batch.
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < transform_batch_instances.size(); i++) {
+			if (transform_batch_instances[i].is_valid()) {
+				transform_batch_instances[count] = transform_batch_instances[i];
+				transform_batch_transforms[count] = transform_batch_transforms[i];
+				count++;
+			}
+		}
+		transform_batch_instances.resize(count);
+		transform_batch_transforms.resize(count);
+		transform_batch_removed = 0;
+	}
+
+	if (!transform_batch_instances.is_empty()) {
+		RS::get_singleton()->instances_set_transforms(transform_batch_instances, transform_batch_transforms);
+		transform_batch_instances.clear();
+		transform_batch_transforms.clear();
+	}
+	server_batch_pass++;
+}
+
+void VisualInstance3D::_push_transform_to_server_batch(const Transform3D &p_transform) {
+	if (transform_batch_pass == server_batch_pass) {
+		transform_batch_transforms[transform_batch_index] = p_transform; // Already in this batch.
+		return;
+	}
+	transform_batch_pass = server_batch_pass;
+	transform_batch_index = transform_batch_instances.size();
+	transform_batch_instances.push_back(instance);
+	transform_batch_transforms.push_back(p_transform);
+}
+
+void VisualInstance3D::_remove_from_server_batch() {
+	if (transform_batch_pass != server_batch_pass) {
+		return;
+	}
+	// The entry is skipped when flushing, so freeing many instances stays linear.
+	transform_batch_instances[transform_batch_index] = RID();
+	transform_batch_removed++;
+	transform_batch_pass = 0;
+}
+
+void VisualInstance3D::_begin_server_batch() {
+	// The batch belongs to the main thread, other threads always call the server directly.
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		return;
+	}
+	server_batch_depth++;
+}
+
+void VisualInstance3D::_end_server_batch() {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		return;
+	}
+	ERR_FAIL_COND(server_batch_depth == 0);
+	server_batch_depth--;
+	if (server_batch_depth == 0) {
+		_flush_server_batch();
+	}
+}
+
 void VisualInstance3D::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_ENTER_WORLD: {
@@ -62,7 +132,11 @@ void VisualInstance3D::_notification(int p_what) {
 
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 			Transform3D gt = get_global_transform();
-			RenderingServer::get_singleton()->instance_set_transform(instance, gt);
+			if (_is_server_batching()) {
+				_push_transform_to_server_batch(gt);
+			} else {
+				RenderingServer::get_singleton()->instance_set_transform(instance, gt);
+			}
 		} break;
 
 		case NOTIFICATION_EXIT_WORLD: {
@@ -143,6 +217,10 @@ VisualInstance3D::VisualInstance3D() {
 }
 
 VisualInstance3D::~VisualInstance3D() {
+	// This instance may still be in the batch, drop its entries before it's freed.
+	if (_is_server_batching()) {
+		_remove_from_server_batch();
+	}
 	RenderingServer::get_singleton()->free(instance);
 }
 
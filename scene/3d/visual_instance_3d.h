@@ -42,6 +42,23 @@ class VisualInstance3D : public Node3D {
 
 	RID _get_visual_instance_rid() const;
 
+	// While SceneTree flushes transform notifications, instance transforms are collected here
+	// and sent to the RenderingServer in bulk.
+	friend class SceneTree;
+	static int server_batch_depth;
+	static uint64_t server_batch_pass; // Incremented by every flush.
+	static uint32_t transform_batch_removed;
+	static LocalVector<RID> transform_batch_instances;
+	static LocalVector<Transform3D> transform_batch_transforms;
+	static void _flush_server_batch();
+	uint64_t transform_batch_pass = 0; // Pass of the batch this instance has an entry in.
+	uint32_t transform_batch_index = 0;
+	void _push_transform_to_server_batch(const Transform3D &p_transform);
+	void _remove_from_server_batch();
+	static void _begin_server_batch();
+	static void _end_server_batch();
+	static _FORCE_INLINE_ bool _is_server_batching() { return server_batch_depth > 0 && Thread::get_caller_id() == Thread::get_main_id(); }
+
 protected:
 	void _update_visibility();
 
@@ -46,6 +46,9 @@
 #include <stdint.h>
 
 VARIANT_ENUM_CAST(Node::ProcessMode);
+VARIANT_ENUM_CAST(Node::ProcessThreadGroup);
+
+thread_local Node *Node::current_process_thread_group = nullptr;
 VARIANT_ENUM_CAST(Node::InternalMode);
 
 int Node::orphan_node_count = 0;
@@ -76,6 +79,15 @@ void Node::_notification(int p_notification) {
 				data.process_owner = this;
 			}
 
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+				data.process_thread_group_owner = data.parent ? data.parent->data.process_thread_group_owner : nullptr;
+			} else {
+				data.process_thread_group_owner = data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD ? this : nullptr;
+			}
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+				get_tree()->process_thread_group_count++;
+			}
+
 			if (data.input) {
 				add_to_group("_vp_input" + itos(get_viewport()->get_instance_id()));
 			}
@@ -114,6 +126,10 @@ void Node::_notification(int p_notification) {
 			}
 
 			data.process_owner = nullptr;
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+				get_tree()->process_thread_group_count--;
+			}
+			data.process_thread_group_owner = nullptr;
 			if (data.path_cache) {
 				memdelete(data.path_cache);
 				data.path_cache = nullptr;
@@ -164,6 +180,7 @@ void Node::_notification(int p_notification) {
 			}
 
 			// kill children as cleanly as possible
+			_update_children_cache();
 			while (data.children.size()) {
 				Node *child = data.children[data.children.size() - 1]; //begin from the end because its faster and more consistent with creation
 				memdelete(child);
@@ -174,6 +191,7 @@ void Node::_notification(int p_notification) {
 
 void Node::_propagate_ready() {
 	data.ready_notified = true;
+	_update_children_cache();
 	data.blocked++;
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->_propagate_ready();
@@ -224,6 +242,7 @@ void Node::_propagate_enter_tree() {
 		data.parent->emit_signalp(SNAME("child_entered_tree"), &cptr, 1);
 	}
 
+	_update_children_cache();
 	data.blocked++;
 	//block while adding children
 
@@ -265,6 +284,7 @@ void Node::_propagate_after_exit_tree() {
 		}
 	}
 
+	_update_children_cache();
 	data.blocked++;
 	for (int i = data.children.size() - 1; i >= 0; i--) {
 		data.children[i]->_propagate_after_exit_tree();
@@ -280,6 +300,7 @@ void Node::_propagate_exit_tree() {
 #ifdef DEBUG_ENABLED
 	SceneDebugger::remove_from_cache(data.scene_file_path, this);
 #endif
+	_update_children_cache();
 	data.blocked++;
 
 	for (int i = data.children.size() - 1; i >= 0; i--) {
@@ -324,8 +345,11 @@ void Node::_propagate_exit_tree() {
 
 void Node::move_child(Node *p_child, int p_pos) {
 	ERR_FAIL_NULL(p_child);
+	ERR_FAIL_COND_MSG(current_process_thread_group, "Can't move children while processing a thread group. Consider using call_deferred(\"move_child\") instead.");
 	ERR_FAIL_COND_MSG(p_child->data.parent != this, "Child is not a child of this node.");
 
+	_update_children_cache();
+
 	// We need to check whether node is internal and move it only in the relevant node range.
 	if (p_child->_is_internal_front()) {
 		if (p_pos < 0) {
@@ -351,6 +375,8 @@ void Node::move_child(Node *p_child, int p_pos) {
 void Node::_move_child(Node *p_child, int p_pos, bool p_ignore_end) {
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, move_child() failed. Consider using call_deferred(\"move_child\") instead (or \"popup\" if this is from a popup).");
 
+	_update_children_cache();
+
 	// Specifying one place beyond the end
 	// means the same as moving to the last position
 	if (!p_ignore_end) { // p_ignore_end is a little hack to make back internal children work properly.
@@ -405,6 +431,7 @@ void Node::_propagate_groups_dirty() {
 		}
 	}
 
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->_propagate_groups_dirty();
 	}
@@ -526,8 +553,12 @@ void Node::_propagate_pause_notification(bool p_enable) {
 		notification(NOTIFICATION_UNPAUSED);
 	}
 
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
-		data.children[i]->_propagate_pause_notification(p_enable);
+		Node *c = data.children[i];
+		if (c) { // May have been removed while notifying.
+			c->_propagate_pause_notification(p_enable);
+		}
 	}
 }
 
@@ -546,18 +577,115 @@ void Node::_propagate_process_owner(Node *p_owner, int p_pause_notification, int
 		notification(p_enabled_notification);
 	}
 
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		Node *c = data.children[i];
-		if (c->data.process_mode == PROCESS_MODE_INHERIT) {
+		if (c && c->data.process_mode == PROCESS_MODE_INHERIT) { // May have been removed while notifying.
 			c->_propagate_process_owner(p_owner, p_pause_notification, p_enabled_notification);
 		}
 	}
 }
 
+void Node::set_process_thread_group(ProcessThreadGroup p_mode) {
+	ERR_FAIL_COND_MSG(current_process_thread_group, "Thread groups can't be changed while they are being processed.");
+	if (data.process_thread_group == p_mode) {
+		return;
+	}
+
+	if (is_inside_tree()) {
+		if (data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+			data.tree->process_thread_group_count--;
+		}
+		if (p_mode == PROCESS_THREAD_GROUP_SUB_THREAD) {
+			data.tree->process_thread_group_count++;
+		}
+	}
+
+	data.process_thread_group = p_mode;
+
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	Node *owner = nullptr;
+	if (p_mode == PROCESS_THREAD_GROUP_INHERIT) {
+		owner = data.parent ? data.parent->data.process_thread_group_owner : nullptr;
+	} else if (p_mode == PROCESS_THREAD_GROUP_SUB_THREAD) {
+		owner = this;
+	}
+	_propagate_process_thread_group_owner(owner);
+}
+
+Node::ProcessThreadGroup Node::get_process_thread_group() const {
+	return data.process_thread_group;
+}
+
+void Node::_propagate_process_thread_group_owner(Node *p_owner) {
+	data.process_thread_group_owner = p_owner;
+
+	_update_children_cache();
+	for (int i = 0; i < data.children.size(); i++) {
+		Node *c = data.children[i];
+		if (c->data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+			c->_propagate_process_thread_group_owner(p_owner);
+		}
+	}
+}
+
+bool Node::is_accessible_from_caller_thread() const {
+	if (current_process_thread_group) {
+		// Processing a thread group, only nodes within it can be used.
+		return data.process_thread_group_owner == current_process_thread_group;
+	}
+	return !data.inside_tree || Thread::get_caller_id() == Thread::get_main_id();
+}
+
+Variant Node::_call_thread_safe_bind(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	if (p_argcount < 1) {
+		r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
+		r_error.argument = 0;
+		return Variant();
+	}
+
+	if (p_args[0]->get_type() != Variant::STRING_NAME && p_args[0]->get_type() != Variant::STRING) {
+		r_error.error = Callable::CallError::CALL_ERROR_INVALID_ARGUMENT;
+		r_error.argument = 0;
+		r_error.expected = Variant::STRING_NAME;
+		return Variant();
+	}
+
+	StringName method = *p_args[0];
+
+	if (is_accessible_from_caller_thread()) {
+		return callp(method, &p_args[1], p_argcount - 1, r_error);
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+	MessageQueue::get_singleton()->push_callp(get_instance_id(), method, &p_args[1], p_argcount - 1, true);
+	return Variant();
+}
+
+void Node::set_thread_safe(const StringName &p_property, const Variant &p_value) {
+	if (is_accessible_from_caller_thread()) {
+		set(p_property, p_value);
+	} else {
+		MessageQueue::get_singleton()->push_set(this, p_property, p_value);
+	}
+}
+
+void Node::notify_thread_safe(int p_notification) {
+	if (is_accessible_from_caller_thread()) {
+		notification(p_notification);
+	} else {
+		MessageQueue::get_singleton()->push_notification(this, p_notification);
+	}
+}
+
 void Node::set_multiplayer_authority(int p_peer_id, bool p_recursive) {
 	data.multiplayer_authority = p_peer_id;
 
 	if (p_recursive) {
+		_update_children_cache();
 		for (int i = 0; i < data.children.size(); i++) {
 			data.children[i]->set_multiplayer_authority(p_peer_id, true);
 		}
@@ -898,7 +1026,13 @@ StringName Node::get_name() const {
 }
 
 void Node::_set_name_nocheck(const StringName &p_name) {
+	if (data.parent) {
+		data.parent->_remove_child_name(this);
+	}
 	data.name = p_name;
+	if (data.parent) {
+		data.parent->_add_child_name(this);
+	}
 }
 
 void Node::set_name(const String &p_name) {
@@ -909,10 +1043,14 @@ void Node::set_name(const String &p_name) {
 	if (data.unique_name_in_owner && data.owner) {
 		_release_unique_name_in_owner();
 	}
+	if (data.parent) {
+		data.parent->_remove_child_name(this);
+	}
 	data.name = name;
 
 	if (data.parent) {
 		data.parent->_validate_child_name(this, true);
+		data.parent->_add_child_name(this);
 	}
 
 	if (data.unique_name_in_owner && data.owner) {
@@ -975,18 +1113,7 @@ void Node::_validate_child_name(Node *p_child, bool p_force_human_readable) {
 			unique = false;
 		} else {
 			//check if exists
-			Node **children = data.children.ptrw();
-			int cc = data.children.size();
-
-			for (int i = 0; i < cc; i++) {
-				if (children[i] == p_child) {
-					continue;
-				}
-				if (children[i]->data.name == p_child->data.name) {
-					unique = false;
-					break;
-				}
-			}
+			unique = !_has_child_name(p_child->data.name, p_child);
 		}
 
 		if (!unique) {
@@ -1031,25 +1158,9 @@ void Node::_generate_serial_child_name(const Node *p_child, StringName &name) co
 		name = adjust_name_casing(name);
 	}
 
-	//quickly test if proposed name exists
-	int cc = data.children.size(); //children count
-	const Node *const *children_ptr = data.children.ptr();
-
-	{
-		bool exists = false;
-
-		for (int i = 0; i < cc; i++) {
-			if (children_ptr[i] == p_child) { //exclude self in renaming if it's already a child
-				continue;
-			}
-			if (children_ptr[i]->data.name == name) {
-				exists = true;
-			}
-		}
-
-		if (!exists) {
-			return; //if it does not exist, it does not need validation
-		}
+	//quickly test if proposed name exists, excluding self in renaming if it's already a child
+	if (!_has_child_name(name, p_child)) {
+		return; //if it does not exist, it does not need validation
 	}
 
 	// Extract trailing number
@@ -1076,18 +1187,8 @@ void Node::_generate_serial_child_name(const Node *p_child, StringName &name) co
 
 	for (;;) {
 		StringName attempt = name_string + nums;
-		bool exists = false;
 
-		for (int i = 0; i < cc; i++) {
-			if (children_ptr[i] == p_child) {
-				continue;
-			}
-			if (children_ptr[i]->data.name == attempt) {
-				exists = true;
-			}
-		}
-
-		if (!exists) {
+		if (!_has_child_name(attempt, p_child)) {
 			name = attempt;
 			return;
 		} else {
@@ -1109,8 +1210,10 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
 	p_child->data.pos = data.children.size();
 	data.children.push_back(p_child);
 	p_child->data.parent = this;
+	_add_child_name(p_child);
 
 	if (data.internal_children_back > 0) {
+		_update_children_cache();
 		_move_child(p_child, data.children.size() - data.internal_children_back - 1);
 	}
 	p_child->notification(NOTIFICATION_PARENTED);
@@ -1133,6 +1236,7 @@ void Node::add_child(Node *p_child, bool p_force_readable_name, InternalMode p_i
 	ERR_FAIL_COND_MSG(p_child->is_ancestor_of(this), vformat("Can't add child '%s' to '%s' as it would result in a cyclic dependency since '%s' is already a parent of '%s'.", p_child->get_name(), get_name(), p_child->get_name(), get_name()));
 #endif
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, add_node() failed. Consider using call_deferred(\"add_child\", child) instead.");
+	ERR_FAIL_COND_MSG(current_process_thread_group, "Can't add children while processing a thread group. Consider using call_deferred(\"add_child\", child) instead.");
 
 	_validate_child_name(p_child, p_force_readable_name);
 	_add_child_nocheck(p_child, p_child->data.name);
@@ -1142,10 +1246,12 @@ void Node::add_child(Node *p_child, bool p_force_readable_name, InternalMode p_i
 		data.internal_children_front++;
 	} else if (p_internal == INTERNAL_MODE_BACK) {
 		if (data.internal_children_back > 0) {
+			_update_children_cache();
 			_move_child(p_child, data.children.size() - 1, true);
 		}
 		data.internal_children_back++;
 	}
+	p_child->data.internal_mode = p_internal;
 }
 
 void Node::add_sibling(Node *p_sibling, bool p_force_readable_name) {
@@ -1168,6 +1274,7 @@ void Node::add_sibling(Node *p_sibling, bool p_force_readable_name) {
 void Node::remove_child(Node *p_child) {
 	ERR_FAIL_NULL(p_child);
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, remove_node() failed. Consider using call_deferred(\"remove_child\", child) instead.");
+	ERR_FAIL_COND_MSG(current_process_thread_group, "Can't remove children while processing a thread group. Consider using call_deferred(\"remove_child\", child) instead.");
 
 	int child_count = data.children.size();
 	Node **children = data.children.ptrw();
@@ -1190,6 +1297,7 @@ void Node::remove_child(Node *p_child) {
 
 	ERR_FAIL_COND_MSG(idx == -1, vformat("Cannot remove child node '%s' as it is not a child of this node.", p_child->get_name()));
 	//ERR_FAIL_COND( p_child->data.blocked > 0 );
+	p_child->data.pos = idx;
 
 	// If internal child, update the counter.
 	if (p_child->_is_internal_front()) {
@@ -1204,19 +1312,43 @@ void Node::remove_child(Node *p_child) {
 	remove_child_notify(p_child);
 	p_child->notification(NOTIFICATION_UNPARENTED);
 
-	data.children.remove_at(idx);
-
-	//update pointer and size
+	// Leave a hole instead of shifting the following children, they keep their relative order
+	// and are compacted at once when next accessed by index.
+	idx = p_child->data.pos;
 	child_count = data.children.size();
 	children = data.children.ptrw();
+	children[idx] = nullptr;
+	data.children_holes++;
 
-	for (int i = idx; i < child_count; i++) {
-		children[i]->data.pos = i;
-		children[i]->notification(NOTIFICATION_MOVED_IN_PARENT);
+	if (idx == child_count - 1) {
+		// Trailing holes can be dropped right away, so removing from the end stays cheap.
+		while (child_count > 0 && !children[child_count - 1]) {
+			child_count--;
+			data.children_holes--;
+		}
+		data.children.resize(child_count);
+		if (data.children_holes == 0) {
+			data.children_first_hole = -1;
+		}
+	} else {
+		if (data.children_first_hole == -1 || idx < data.children_first_hole) {
+			data.children_first_hole = idx;
+		}
+		// The following children moved. They are notified once at idle time, rather than on
+		// every removal or from whichever getter compacts the children first.
+		if (data.children_moved_from == -1) {
+			MessageQueue::get_singleton()->push_callable(callable_mp(this, &Node::_notify_children_moved));
+			data.children_moved_from = idx;
+		} else if (idx < data.children_moved_from) {
+			data.children_moved_from = idx;
+		}
 	}
 
+	_remove_child_name(p_child);
+
 	p_child->data.parent = nullptr;
 	p_child->data.pos = -1;
+	p_child->data.internal_mode = INTERNAL_MODE_DISABLED;
 
 	if (data.inside_tree) {
 		p_child->_propagate_after_exit_tree();
@@ -1225,13 +1357,15 @@ void Node::remove_child(Node *p_child) {
 
 int Node::get_child_count(bool p_include_internal) const {
 	if (p_include_internal) {
-		return data.children.size();
+		return data.children.size() - data.children_holes;
 	} else {
-		return data.children.size() - data.internal_children_front - data.internal_children_back;
+		return data.children.size() - data.children_holes - data.internal_children_front - data.internal_children_back;
 	}
 }
 
 Node *Node::get_child(int p_index, bool p_include_internal) const {
+	_update_children_cache();
+
 	if (p_include_internal) {
 		if (p_index < 0) {
 			p_index += data.children.size();
@@ -1249,16 +1383,108 @@ Node *Node::get_child(int p_index, bool p_include_internal) const {
 }
 
 Node *Node::_get_child_by_name(const StringName &p_name) const {
-	int cc = data.children.size();
-	Node *const *cd = data.children.ptr();
+	if (unlikely(data.children_name_collisions > 0)) {
+		// Some siblings share a name, return the first one in order.
+		_update_children_cache();
+		int cc = data.children.size();
+		Node *const *cd = data.children.ptr();
 
-	for (int i = 0; i < cc; i++) {
-		if (cd[i]->data.name == p_name) {
-			return cd[i];
+		for (int i = 0; i < cc; i++) {
+			if (cd[i]->data.name == p_name) {
+				return cd[i];
+			}
 		}
+
+		return nullptr;
 	}
 
-	return nullptr;
+	Node *const *child = data.children_by_name.getptr(p_name);
+	return child ? *child : nullptr;
+}
+
+bool Node::_has_child_name(const StringName &p_name, const Node *p_exclude) const {
+	if (unlikely(data.children_name_collisions > 0)) {
+		int cc = data.children.size();
+		Node *const *cd = data.children.ptr();
+
+		for (int i = 0; i < cc; i++) {
+			if (cd[i] && cd[i] != p_exclude && cd[i]->data.name == p_name) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	Node *const *child = data.children_by_name.getptr(p_name);
+	return child && *child != p_exclude;
+}
+
+void Node::_add_child_name(Node *p_child) {
+	if (data.children_by_name.has(p_child->data.name)) {
+		data.children_name_collisions++; // Only possible when added without name validation.
+	} else {
+		data.children_by_name.insert(p_child->data.name, p_child);
+	}
+}
+
+void Node::_remove_child_name(Node *p_child) {
+	HashMap<StringName, Node *>::Iterator E = data.children_by_name.find(p_child->data.name);
+	if (!E || E->value != p_child) {
+		data.children_name_collisions--;
+		return;
+	}
+
+	data.children_by_name.remove(E);
+
+	if (data.children_name_collisions > 0) {
+		// Index a sibling sharing the same name instead, if any.
+		int cc = data.children.size();
+		Node *const *cd = data.children.ptr();
+
+		for (int i = 0; i < cc; i++) {
+			if (cd[i] && cd[i] != p_child && cd[i]->data.name == p_child->data.name) {
+				data.children_by_name.insert(cd[i]->data.name, cd[i]);
+				data.children_name_collisions--;
+				break;
+			}
+		}
+	}
+}
+
+void Node::_compact_children() const {
+	Node **children = data.children.ptrw();
+	int count = data.children.size();
+	int to = data.children_first_hole;
+
+	for (int from = to; from < count; from++) {
+		Node *child = children[from];
+		if (child) {
+			child->data.pos = to;
+			children[to++] = child;
+		}
+	}
+
+	data.children.resize(to);
+	data.children_holes = 0;
+	data.children_first_hole = -1;
+}
+
+void Node::_notify_children_moved() {
+	if (data.children_moved_from == -1) {
+		return;
+	}
+	_update_children_cache();
+
+	// Compacting only moves children down, so every moved child is at or after the first hole.
+	int from = data.children_moved_from;
+	data.children_moved_from = -1;
+
+	data.blocked++;
+	for (int i = from; i < data.children.size(); i++) {
+		data.children[i]->notification(NOTIFICATION_MOVED_IN_PARENT);
+	}
+	data.blocked--;
 }
 
 Node *Node::get_node_or_null(const NodePath &p_path) const {
@@ -1319,16 +1545,7 @@ Node *Node::get_node_or_null(const NodePath &p_path) const {
 			}
 
 		} else {
-			next = nullptr;
-
-			for (int j = 0; j < current->data.children.size(); j++) {
-				Node *child = current->data.children[j];
-
-				if (child->data.name == name) {
-					next = child;
-					break;
-				}
-			}
+			next = current->_get_child_by_name(name);
 			if (next == nullptr) {
 				return nullptr;
 			};
@@ -1364,6 +1581,7 @@ bool Node::has_node(const NodePath &p_path) const {
 Node *Node::find_child(const String &p_pattern, bool p_recursive, bool p_owned) const {
 	ERR_FAIL_COND_V(p_pattern.is_empty(), nullptr);
 
+	_update_children_cache();
 	Node *const *cptr = data.children.ptr();
 	int ccount = data.children.size();
 	for (int i = 0; i < ccount; i++) {
@@ -1393,6 +1611,7 @@ TypedArray<Node> Node::find_children(const String &p_pattern, const String &p_ty
 	TypedArray<Node> ret;
 	ERR_FAIL_COND_V(p_pattern.is_empty() && p_type.is_empty(), ret);
 
+	_update_children_cache();
 	Node *const *cptr = data.children.ptr();
 	int ccount = data.children.size();
 	for (int i = 0; i < ccount; i++) {
@@ -1808,6 +2027,7 @@ int Node::get_persistent_group_count() const {
 void Node::_print_tree_pretty(const String &prefix, const bool last) {
 	String new_prefix = last ? String::utf8(" ┖╴") : String::utf8(" ┠╴");
 	print_line(prefix + new_prefix + String(get_name()));
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		new_prefix = last ? String::utf8("   ") : String::utf8(" ┃ ");
 		data.children[i]->_print_tree_pretty(prefix + new_prefix, i == data.children.size() - 1);
@@ -1824,6 +2044,7 @@ void Node::print_tree() {
 
 void Node::_print_tree(const Node *p_node) {
 	print_line(String(p_node->get_path_to(this)));
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->_print_tree(p_node);
 	}
@@ -1831,6 +2052,7 @@ void Node::_print_tree(const Node *p_node) {
 
 void Node::_propagate_reverse_notification(int p_notification) {
 	data.blocked++;
+	_update_children_cache();
 	for (int i = data.children.size() - 1; i >= 0; i--) {
 		data.children[i]->_propagate_reverse_notification(p_notification);
 	}
@@ -1848,6 +2070,7 @@ void Node::_propagate_deferred_notification(int p_notification, bool p_reverse)
 		MessageQueue::get_singleton()->push_notification(this, p_notification);
 	}
 
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->_propagate_deferred_notification(p_notification, p_reverse);
 	}
@@ -1863,6 +2086,7 @@ void Node::propagate_notification(int p_notification) {
 	data.blocked++;
 	notification(p_notification);
 
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->propagate_notification(p_notification);
 	}
@@ -1876,6 +2100,7 @@ void Node::propagate_call(const StringName &p_method, const Array &p_args, const
 		callv(p_method, p_args);
 	}
 
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->propagate_call(p_method, p_args, p_parent_first);
 	}
@@ -1893,6 +2118,7 @@ void Node::_propagate_replace_owner(Node *p_owner, Node *p_by_owner) {
 	}
 
 	data.blocked++;
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->_propagate_replace_owner(p_owner, p_by_owner);
 	}
@@ -1903,6 +2129,9 @@ int Node::get_index(bool p_include_internal) const {
 	// p_include_internal = false doesn't make sense if the node is internal.
 	ERR_FAIL_COND_V_MSG(!p_include_internal && (_is_internal_front() || _is_internal_back()), -1, "Node is internal. Can't get index with 'include_internal' being false.");
 
+	if (data.parent) {
+		data.parent->_update_children_cache();
+	}
 	if (data.parent && !p_include_internal) {
 		return data.pos - data.parent->data.internal_children_front;
 	}
@@ -2401,7 +2630,7 @@ void Node::replace_by(Node *p_node, bool p_keep_groups) {
 	}
 
 	Node *parent = data.parent;
-	int pos_in_parent = data.pos;
+	int pos_in_parent = get_index(true);
 
 	if (data.parent) {
 		parent->remove_child(this);
@@ -2582,6 +2811,12 @@ void Node::print_orphan_nodes() {
 }
 
 void Node::queue_delete() {
+	if (current_process_thread_group) {
+		// The deletion queue belongs to the main thread.
+		MessageQueue::get_singleton()->push_callable(callable_mp(this, &Node::queue_delete));
+		return;
+	}
+
 	if (is_inside_tree()) {
 		get_tree()->queue_delete(this);
 	} else {
@@ -2635,6 +2870,7 @@ void Node::get_argument_options(const StringName &p_function, int p_idx, List<St
 
 void Node::clear_internal_tree_resource_paths() {
 	clear_internal_resource_paths();
+	_update_children_cache();
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->clear_internal_tree_resource_paths();
 	}
@@ -2788,6 +3024,11 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_process_delta_time"), &Node::get_process_delta_time);
 	ClassDB::bind_method(D_METHOD("set_process", "enable"), &Node::set_process);
 	ClassDB::bind_method(D_METHOD("set_process_priority", "priority"), &Node::set_process_priority);
+	ClassDB::bind_method(D_METHOD("set_process_thread_group", "mode"), &Node::set_process_thread_group);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group"), &Node::get_process_thread_group);
+	ClassDB::bind_method(D_METHOD("is_accessible_from_caller_thread"), &Node::is_accessible_from_caller_thread);
+	ClassDB::bind_method(D_METHOD("set_thread_safe", "property", "value"), &Node::set_thread_safe);
+	ClassDB::bind_method(D_METHOD("notify_thread_safe", "what"), &Node::notify_thread_safe);
 	ClassDB::bind_method(D_METHOD("get_process_priority"), &Node::get_process_priority);
 	ClassDB::bind_method(D_METHOD("is_processing"), &Node::is_processing);
 	ClassDB::bind_method(D_METHOD("set_process_input", "enable"), &Node::set_process_input);
@@ -2852,6 +3093,14 @@ void Node::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "_import_path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL), "_set_import_path", "_get_import_path");
 
+	{
+		MethodInfo mi;
+
+		mi.arguments.push_back(PropertyInfo(Variant::STRING_NAME, "method"));
+
+		mi.name = "call_thread_safe";
+		ClassDB::bind_vararg_method(METHOD_FLAGS_DEFAULT, "call_thread_safe", &Node::_call_thread_safe_bind, mi, varray(), false);
+	}
 	{
 		MethodInfo mi;
 
@@ -2918,6 +3167,10 @@ void Node::_bind_methods() {
 	BIND_ENUM_CONSTANT(PROCESS_MODE_ALWAYS);
 	BIND_ENUM_CONSTANT(PROCESS_MODE_DISABLED);
 
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_INHERIT);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_MAIN_THREAD);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_SUB_THREAD);
+
 	BIND_ENUM_CONSTANT(DUPLICATE_SIGNALS);
 	BIND_ENUM_CONSTANT(DUPLICATE_GROUPS);
 	BIND_ENUM_CONSTANT(DUPLICATE_SCRIPTS);
@@ -2944,6 +3197,7 @@ void Node::_bind_methods() {
 	ADD_GROUP("Process", "process_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_mode", PROPERTY_HINT_ENUM, "Inherit,Pausable,When Paused,Always,Disabled"), "set_process_mode", "get_process_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_priority"), "set_process_priority", "get_process_priority");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_ENUM, "Inherit,Main Thread,Sub Thread"), "set_process_thread_group", "get_process_thread_group");
 
 	ADD_GROUP("Editor Description", "editor_");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "editor_description", PROPERTY_HINT_MULTILINE_TEXT), "set_editor_description", "get_editor_description");
@@ -2982,6 +3236,7 @@ Node::~Node() {
 	data.grouped.clear();
 	data.owned.clear();
 	data.children.clear();
+	data.children_by_name.clear();
 
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
@@ -53,6 +53,12 @@ public:
 		PROCESS_MODE_DISABLED, // never process
 	};
 
+	enum ProcessThreadGroup {
+		PROCESS_THREAD_GROUP_INHERIT, // same as parent node
+		PROCESS_THREAD_GROUP_MAIN_THREAD, // processed on the main thread
+		PROCESS_THREAD_GROUP_SUB_THREAD, // processed on a worker thread, in parallel with other groups
+	};
+
 	enum DuplicateFlags {
 		DUPLICATE_SIGNALS = 1,
 		DUPLICATE_GROUPS = 2,
@@ -98,12 +104,20 @@ private:
 
 		Node *parent = nullptr;
 		Node *owner = nullptr;
-		Vector<Node *> children;
+		// Removed children leave null holes, so the following ones don't have to be shifted
+		// on every removal. Use _update_children_cache() before accessing them by index.
+		mutable Vector<Node *> children;
+		mutable int children_holes = 0;
+		mutable int children_first_hole = -1;
+		int children_moved_from = -1; // Lowest index of the children not notified of their move yet.
+		HashMap<StringName, Node *> children_by_name;
+		int children_name_collisions = 0; // Children added without validation, sharing their name with an indexed sibling.
 		HashMap<StringName, Node *> owned_unique_nodes;
 		bool unique_name_in_owner = false;
 
 		int internal_children_front = 0;
 		int internal_children_back = 0;
+		InternalMode internal_mode = INTERNAL_MODE_DISABLED;
 		int pos = -1;
 		int depth = -1;
 		int blocked = 0; // Safeguard that throws an error when attempting to modify the tree in a harmful way while being traversed.
@@ -126,6 +140,9 @@ private:
 		ProcessMode process_mode = PROCESS_MODE_INHERIT;
 		Node *process_owner = nullptr;
 
+		ProcessThreadGroup process_thread_group = PROCESS_THREAD_GROUP_INHERIT;
+		Node *process_thread_group_owner = nullptr; // Node defining the sub-thread group this node belongs to, null if processed on the main thread.
+
 		int multiplayer_authority = 1; // Server by default.
 		Variant rpc_config;
 
@@ -160,6 +177,17 @@ private:
 	void _print_tree(const Node *p_node);
 
 	Node *_get_child_by_name(const StringName &p_name) const;
+	bool _has_child_name(const StringName &p_name, const Node *p_exclude) const;
+	void _add_child_name(Node *p_child);
+	void _remove_child_name(Node *p_child);
+
+	void _compact_children() const;
+	void _notify_children_moved();
+	_FORCE_INLINE_ void _update_children_cache() const {
+		if (unlikely(data.children_holes > 0)) {
+			_compact_children();
+		}
+	}
 
 	void _replace_connections_target(Node *p_new_target);
 
@@ -174,6 +202,12 @@ private:
 	void _propagate_after_exit_tree();
 	void _print_orphan_nodes();
 	void _propagate_process_owner(Node *p_owner, int p_pause_notification, int p_enabled_notification);
+	void _propagate_process_thread_group_owner(Node *p_owner);
+
+	// Thread group being processed by the calling thread, if any.
+	static thread_local Node *current_process_thread_group;
+
+	Variant _call_thread_safe_bind(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	void _propagate_groups_dirty();
 	Array _get_node_and_resource(const NodePath &p_path);
 
@@ -186,8 +220,8 @@ private:
 	Error _rpc_bind(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	Error _rpc_id_bind(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 
-	_FORCE_INLINE_ bool _is_internal_front() const { return data.parent && data.pos < data.parent->data.internal_children_front; }
-	_FORCE_INLINE_ bool _is_internal_back() const { return data.parent && data.pos >= data.parent->data.children.size() - data.parent->data.internal_children_back; }
+	_FORCE_INLINE_ bool _is_internal_front() const { return data.internal_mode == INTERNAL_MODE_FRONT; }
+	_FORCE_INLINE_ bool _is_internal_back() const { return data.internal_mode == INTERNAL_MODE_BACK; }
 
 	friend class SceneTree;
 
@@ -446,6 +480,13 @@ public:
 
 	void set_process_mode(ProcessMode p_mode);
 	ProcessMode get_process_mode() const;
+
+	void set_process_thread_group(ProcessThreadGroup p_mode);
+	ProcessThreadGroup get_process_thread_group() const;
+	bool is_accessible_from_caller_thread() const;
+
+	void set_thread_safe(const StringName &p_property, const Variant &p_value);
+	void notify_thread_safe(int p_notification);
 	bool can_process() const;
 	bool can_process_notification(int p_what) const;
 	bool is_enabled() const;
@@ -0,0 +1,331 @@
+/*************************************************************************/
+/*  scene_pool.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "scene_pool.h"
+
+#include "core/core_string_names.h"
+
+SafeNumeric<uint64_t> ScenePool::pooled_node_count;
+SafeNumeric<uint64_t> ScenePool::pooled_orphan_node_count;
+
+Variant ScenePool::_copy_value(const Variant &p_value) {
+	// Containers are shared by reference, a snapshot must not change when the node edits them in place.
+	switch (p_value.get_type()) {
+		case Variant::ARRAY:
+			return p_value.operator Array().duplicate(true);
+		case Variant::DICTIONARY:
+			return p_value.operator Dictionary().duplicate(true);
+		default:
+			return p_value;
+	}
+}
+
+uint32_t ScenePool::_count_nodes(const Node *p_node) {
+	uint32_t count = 1;
+	int child_count = p_node->get_child_count(true);
+	for (int i = 0; i < child_count; i++) {
+		count += _count_nodes(p_node->get_child(i, true));
+	}
+	return count;
+}
+
+void ScenePool::_prune_instances() {
+	// Instances freed by the user instead of being released are forgotten here.
+	LocalVector<ObjectID> freed;
+	for (const KeyValue<ObjectID, Instance> &E : instances) {
+		if (!E.value.pooled && !ObjectDB::get_instance(E.key)) {
+			freed.push_back(E.key);
+		}
+	}
+	for (uint32_t i = 0; i < freed.size(); i++) {
+		instances.erase(freed[i]);
+	}
+	prune_threshold = MAX((uint32_t)MIN_PRUNE_THRESHOLD, instances.size() * 2);
+}
+
+void ScenePool::_track_instance(Node *p_root) {
+	if (instances.size() >= prune_threshold) {
+		_prune_instances();
+	}
+
+	Ref<SceneState> state = scene->get_state();
+	int node_count = state->get_node_count();
+
+	if (!properties_valid) {
+		// Only the properties stored by the scene are reset, the others keep the values given
+		// by their class unless they are marked dirty.
+		for (int i = 0; i < node_count; i++) {
+			int property_count = state->get_node_property_count(i);
+			for (int j = 0; j < property_count; j++) {
+				StringName name = state->get_node_property_name(i, j);
+				if (name == CoreStringNames::get_singleton()->_script) {
+					continue;
+				}
+				Property prop;
+				prop.node = i;
+				prop.name = name;
+				properties.push_back(prop);
+			}
+		}
+		properties_valid = true;
+	}
+
+	LocalVector<Node *> nodes;
+	nodes.resize(node_count);
+	Instance instance;
+	instance.nodes.resize(node_count);
+	for (int i = 0; i < node_count; i++) {
+		nodes[i] = i == 0 ? p_root : p_root->get_node_or_null(state->get_node_path(i));
+		instance.nodes[i] = nodes[i] ? nodes[i]->get_instance_id() : ObjectID();
+	}
+	instance.values.resize(properties.size());
+	for (uint32_t i = 0; i < properties.size(); i++) {
+		Property &prop = properties[i];
+		if (nodes[prop.node]) {
+			instance.values[i] = _copy_value(nodes[prop.node]->get(prop.name, nullptr, &prop.cache));
+		}
+	}
+	instance.node_count = _count_nodes(p_root);
+
+	instances.insert(p_root->get_instance_id(), instance);
+}
+
+void ScenePool::_reset_instance(Instance &p_instance) {
+	// Dirty properties go first, stored ones are reset to the instantiated values in any case.
+	for (uint32_t i = 0; i < p_instance.dirty.size(); i++) {
+		const DirtyProperty &dirty = p_instance.dirty[i];
+		Object *node = ObjectDB::get_instance(dirty.node);
+		if (node) {
+			node->set(dirty.name, _copy_value(dirty.value));
+		}
+	}
+	p_instance.dirty.clear();
+
+	for (uint32_t i = 0; i < properties.size(); i++) {
+		Property &prop = properties[i];
+		Object *node = ObjectDB::get_instance(p_instance.nodes[prop.node]);
+		if (!node) {
+			continue; // Freed while in use.
+		}
+		// Only call setters for changed values, most of an instance is usually untouched.
+		if (node->get(prop.name, nullptr, &prop.cache) != p_instance.values[i]) {
+			node->set(prop.name, _copy_value(p_instance.values[i]), nullptr, &prop.cache);
+		}
+	}
+}
+
+void ScenePool::_park_instance(Instance &p_instance, Node *p_root) {
+	p_instance.parked = true;
+	p_instance.parked_process_mode = p_root->get_process_mode();
+	p_root->set_process_mode(Node::PROCESS_MODE_DISABLED);
+
+	bool valid = false;
+	Variant visible = p_root->get(SNAME("visible"), &valid);
+	p_instance.parked_visible = valid && visible.get_type() == Variant::BOOL && bool(visible);
+	if (p_instance.parked_visible) {
+		p_root->set(SNAME("visible"), false);
+	}
+}
+
+void ScenePool::_unpark_instance(Instance &p_instance, Node *p_root) {
+	p_instance.parked = false;
+	p_root->set_process_mode(p_instance.parked_process_mode);
+	if (p_instance.parked_visible) {
+		p_root->set(SNAME("visible"), true);
+	}
+}
+
+void ScenePool::_set_pooled(Instance &p_instance, bool p_pooled) {
+	if (p_instance.pooled == p_pooled) {
+		return;
+	}
+	p_instance.pooled = p_pooled;
+	if (p_pooled) {
+		pooled_node_count.add(p_instance.node_count);
+		if (!p_instance.parked) {
+			pooled_orphan_node_count.add(p_instance.node_count);
+		}
+	} else {
+		pooled_node_count.sub(p_instance.node_count);
+		if (!p_instance.parked) {
+			pooled_orphan_node_count.sub(p_instance.node_count);
+		}
+	}
+}
+
+void ScenePool::set_scene(const Ref<PackedScene> &p_scene) {
+	if (scene == p_scene) {
+		return;
+	}
+	clear();
+	scene = p_scene;
+}
+
+Ref<PackedScene> ScenePool::get_scene() const {
+	return scene;
+}
+
+void ScenePool::prewarm(int p_count) {
+	ERR_FAIL_COND_MSG(scene.is_null(), "No scene set to pool.");
+	ERR_FAIL_COND(p_count < 0);
+
+	Vector<Node *> nodes;
+	scene->instantiate_multiple(p_count, PackedScene::GEN_EDIT_STATE_DISABLED, nodes);
+	for (int i = 0; i < nodes.size(); i++) {
+		_track_instance(nodes[i]);
+		Instance *instance = &instances[nodes[i]->get_instance_id()];
+		_set_pooled(*instance, true);
+		available.push_back(instance);
+	}
+}
+
+Node *ScenePool::acquire(Node *p_parent) {
+	ERR_FAIL_COND_V_MSG(scene.is_null(), nullptr, "No scene set to pool.");
+
+	Node *node = nullptr;
+	while (!node && !available.is_empty()) {
+		Instance *instance = available[available.size() - 1];
+		available.resize(available.size() - 1);
+		_set_pooled(*instance, false);
+
+		ObjectID id = instance->nodes[0];
+		node = Object::cast_to<Node>(ObjectDB::get_instance(id));
+		if (!node) {
+			instances.erase(id); // Freed while pooled.
+		} else if (instance->parked) {
+			_unpark_instance(*instance, node);
+		}
+	}
+
+	if (!node) {
+		node = scene->instantiate();
+		ERR_FAIL_NULL_V(node, nullptr);
+		_track_instance(node);
+	}
+
+	if (p_parent && node->get_parent() != p_parent) {
+		// Parked instances are handed back in place when possible, moving them means exiting the tree.
+		if (node->get_parent()) {
+			node->get_parent()->remove_child(node);
+		}
+		p_parent->add_child(node);
+	}
+	return node;
+}
+
+void ScenePool::mark_dirty(Node *p_node, const StringName &p_property) {
+	ERR_FAIL_NULL(p_node);
+
+	// The node belongs to the closest instance root above it.
+	HashMap<ObjectID, Instance>::Iterator E;
+	for (Node *root = p_node; root && !E; root = root->get_parent()) {
+		E = instances.find(root->get_instance_id());
+	}
+	ERR_FAIL_COND_MSG(!E, "Node '" + p_node->get_name() + "' is not part of an instance acquired from this pool.");
+	ERR_FAIL_COND_MSG(E->value.pooled, "Node '" + p_node->get_name() + "' is part of an instance that was released to this pool.");
+
+	LocalVector<DirtyProperty> &dirty = E->value.dirty;
+	ObjectID id = p_node->get_instance_id();
+	for (uint32_t i = 0; i < dirty.size(); i++) {
+		if (dirty[i].node == id && dirty[i].name == p_property) {
+			return; // The first recorded value is the one to reset to.
+		}
+	}
+
+	bool valid = false;
+	Variant value = p_node->get(p_property, &valid);
+	ERR_FAIL_COND_MSG(!valid, "Node '" + p_node->get_name() + "' has no property '" + p_property + "'.");
+
+	DirtyProperty prop;
+	prop.node = id;
+	prop.name = p_property;
+	prop.value = _copy_value(value);
+	dirty.push_back(prop);
+}
+
+void ScenePool::release(Node *p_node) {
+	ERR_FAIL_NULL(p_node);
+	HashMap<ObjectID, Instance>::Iterator E = instances.find(p_node->get_instance_id());
+	ERR_FAIL_COND_MSG(!E, "Node '" + p_node->get_name() + "' was not acquired from this pool.");
+	ERR_FAIL_COND_MSG(E->value.pooled, "Node '" + p_node->get_name() + "' was already released to this pool.");
+
+	_reset_instance(E->value);
+
+	if (p_node->is_inside_tree()) {
+		// Parked in place, exiting and entering the tree again costs more than the reset.
+		_park_instance(E->value, p_node);
+	} else if (p_node->get_parent()) {
+		p_node->get_parent()->remove_child(p_node);
+	}
+
+	_set_pooled(E->value, true);
+	available.push_back(&E->value);
+}
+
+void ScenePool::clear() {
+	for (uint32_t i = 0; i < available.size(); i++) {
+		_set_pooled(*available[i], false);
+		Object *obj = ObjectDB::get_instance(available[i]->nodes[0]);
+		if (obj) {
+			memdelete(obj);
+		}
+	}
+	available.clear();
+
+	instances.clear();
+	prune_threshold = MIN_PRUNE_THRESHOLD;
+
+	properties.clear();
+	properties_valid = false;
+}
+
+int ScenePool::get_available_count() const {
+	return available.size();
+}
+
+void ScenePool::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_scene", "scene"), &ScenePool::set_scene);
+	ClassDB::bind_method(D_METHOD("get_scene"), &ScenePool::get_scene);
+	ClassDB::bind_method(D_METHOD("prewarm", "count"), &ScenePool::prewarm);
+	ClassDB::bind_method(D_METHOD("acquire", "parent"), &ScenePool::acquire, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("mark_dirty", "node", "property"), &ScenePool::mark_dirty);
+	ClassDB::bind_method(D_METHOD("release", "node"), &ScenePool::release);
+	ClassDB::bind_method(D_METHOD("clear"), &ScenePool::clear);
+	ClassDB::bind_method(D_METHOD("get_available_count"), &ScenePool::get_available_count);
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "scene", PROPERTY_HINT_RESOURCE_TYPE, "PackedScene"), "set_scene", "get_scene");
+}
+
+ScenePool::ScenePool() {
+}
+
+ScenePool::~ScenePool() {
+	clear();
+}
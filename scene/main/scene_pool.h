@@ -0,0 +1,118 @@
+/*************************************************************************/
+/*  scene_pool.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SCENE_POOL_H
+#define SCENE_POOL_H
+
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "scene/main/node.h"
+#include "scene/resources/packed_scene.h"
+
+// Keeps instances of a PackedScene for reuse instead of freeing them and instantiating the
+// scene again. Released instances are reset to the values the scene stores for their nodes,
+// and to the values of the properties marked dirty while they were in use. Instances released
+// inside the tree are parked where they are, disabled and hidden, so they don't exit and
+// enter it again.
+class ScenePool : public RefCounted {
+	GDCLASS(ScenePool, RefCounted);
+
+	enum {
+		MIN_PRUNE_THRESHOLD = 64,
+	};
+
+	struct Property {
+		uint32_t node = 0; // Index of the node in the scene state.
+		StringName name;
+		ObjectLookupCache cache;
+	};
+
+	struct DirtyProperty {
+		ObjectID node;
+		StringName name;
+		Variant value;
+	};
+
+	struct Instance {
+		LocalVector<ObjectID> nodes; // One per node of the scene state.
+		LocalVector<Variant> values; // One per stored property.
+		LocalVector<DirtyProperty> dirty;
+		uint32_t node_count = 0; // Nodes in the instance when it was created.
+		bool pooled = false;
+		bool parked = false; // Released inside the tree.
+		Node::ProcessMode parked_process_mode = Node::PROCESS_MODE_INHERIT;
+		bool parked_visible = false;
+	};
+
+	Ref<PackedScene> scene;
+	LocalVector<Property> properties;
+	bool properties_valid = false;
+
+	HashMap<ObjectID, Instance> instances; // Every instance created by this pool, keyed by root.
+	uint32_t prune_threshold = MIN_PRUNE_THRESHOLD;
+	LocalVector<Instance *> available; // Points into instances.
+
+	// Updated when instances enter and leave the pool. Nodes freed while pooled are only
+	// discounted when the pool finds out, on acquire() or clear().
+	static SafeNumeric<uint64_t> pooled_node_count;
+	static SafeNumeric<uint64_t> pooled_orphan_node_count;
+
+	static Variant _copy_value(const Variant &p_value);
+	static uint32_t _count_nodes(const Node *p_node);
+	void _prune_instances();
+	void _track_instance(Node *p_root);
+	void _reset_instance(Instance &p_instance);
+	void _park_instance(Instance &p_instance, Node *p_root);
+	void _unpark_instance(Instance &p_instance, Node *p_root);
+	void _set_pooled(Instance &p_instance, bool p_pooled);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static uint64_t get_pooled_node_count() { return pooled_node_count.get(); }
+	static uint64_t get_pooled_orphan_node_count() { return pooled_orphan_node_count.get(); }
+
+	void set_scene(const Ref<PackedScene> &p_scene);
+	Ref<PackedScene> get_scene() const;
+
+	void prewarm(int p_count);
+	Node *acquire(Node *p_parent = nullptr);
+	void mark_dirty(Node *p_node, const StringName &p_property);
+	void release(Node *p_node);
+	void clear();
+
+	int get_available_count() const;
+
+	ScenePool();
+	~ScenePool();
+};
+
+#endif // SCENE_POOL_H
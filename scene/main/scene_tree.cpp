@@ -38,13 +38,19 @@
 #include "core/io/marshalls.h"
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "node.h"
+#ifndef _3D_DISABLED
+#include "scene/3d/node_3d.h"
+#include "scene/3d/visual_instance_3d.h"
+#endif // _3D_DISABLED
 #include "scene/animation/tween.h"
 #include "scene/debugger/scene_debugger.h"
 #include "scene/main/multiplayer_api.h"
+#include "scene/main/scene_tree_instantiation.h"
 #include "scene/main/viewport.h"
 #include "scene/resources/environment.h"
 #include "scene/resources/font.h"
@@ -144,11 +150,20 @@ SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_nod
 		E = group_map.insert(p_group, Group());
 	}
 
-	ERR_FAIL_COND_V_MSG(E->value.nodes.has(p_node), &E->value, "Already in group: " + p_group + ".");
-	E->value.nodes.push_back(p_node);
-	//E->value.last_tree_version=0;
-	E->value.changed = true;
-	return &E->value;
+	// Node keeps track of its own groups, so it never adds itself twice.
+	Group &g = E->value;
+	if (!g.changed && !g.nodes.is_empty()) {
+		// Nodes usually enter the tree in order, so appending often keeps the group sorted
+		// and the next call doesn't need to sort it again.
+		const Node *last = g.nodes[g.nodes.size() - 1];
+		if (!p_node->is_inside_tree() || !last->is_inside_tree() || p_node->get_process_priority() < last->get_process_priority() || !p_node->is_greater_than(last)) {
+			g.changed = true;
+		}
+	} else {
+		g.changed = true;
+	}
+	g.nodes.push_back(p_node);
+	return &g;
 }
 
 void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
@@ -168,8 +183,32 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 	}
 }
 
+void SceneTree::_begin_server_batch() {
+#ifndef _3D_DISABLED
+	VisualInstance3D::_begin_server_batch();
+#endif // _3D_DISABLED
+}
+
+void SceneTree::_end_server_batch() {
+#ifndef _3D_DISABLED
+	VisualInstance3D::_end_server_batch();
+#endif // _3D_DISABLED
+}
+
 void SceneTree::flush_transform_notifications() {
 	SelfList<Node> *n = xform_change_list.first();
+	if (!n) {
+		return;
+	}
+
+#ifndef _3D_DISABLED
+	// Resolve all pending 3D global transforms in a single depth ordered pass, so notified
+	// nodes read cached values instead of walking up the hierarchy one node at a time.
+	Node3D::_update_global_transforms(xform_change_list);
+#endif // _3D_DISABLED
+
+	xform_propagation_pass.increment();
+	_begin_server_batch();
 	while (n) {
 		Node *node = n->self();
 		SelfList<Node> *nx = n->next();
@@ -177,6 +216,8 @@ void SceneTree::flush_transform_notifications() {
 		n = nx;
 		node->notification(NOTIFICATION_TRANSFORM_CHANGED);
 	}
+	_end_server_batch();
+	xform_propagation_pass.increment();
 }
 
 void SceneTree::_flush_ugc() {
@@ -252,37 +293,73 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 
 	_update_group_order(g);
 
+	// Iterate a shared snapshot. It's only copied if the group is modified while being called.
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
 
-	if (p_call_flags & GROUP_CALL_REVERSE) {
-		for (int i = node_count - 1; i >= 0; i--) {
-			if (call_lock && call_skip.has(nodes[i])) {
-				continue;
+	if ((p_call_flags & GROUP_CALL_PARALLEL) && !(p_call_flags & GROUP_CALL_DEFERRED) && node_count > 1 && WorkerThreadPool::get_singleton() && WorkerThreadPool::get_singleton()->get_thread_count() > 0) {
+		GroupCallParallel call;
+		call.function = &p_function;
+		call.args = p_args;
+		call.argcount = p_argcount;
+
+		LocalVector<Node *> nodes_to_call;
+		if (call_skip.is_empty()) {
+			call.nodes = nodes;
+		} else {
+			// Filter on this thread, the call must not touch the scene tree.
+			for (int i = 0; i < node_count; i++) {
+				if (!call_skip.has(nodes[i])) {
+					nodes_to_call.push_back(nodes[i]);
+				}
 			}
+			call.nodes = nodes_to_call.ptr();
+			node_count = nodes_to_call.size();
+		}
 
-			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
-				Callable::CallError ce;
-				nodes[i]->callp(p_function, p_args, p_argcount, ce);
-			} else {
+		if (node_count > 0) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SceneTree::_call_group_parallel, &call, node_count, -1, true);
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		}
+
+	} else if (p_call_flags & GROUP_CALL_DEFERRED) {
+		if (p_call_flags & GROUP_CALL_REVERSE) {
+			for (int i = node_count - 1; i >= 0; i--) {
+				if (call_lock && call_skip.has(nodes[i])) {
+					continue;
+				}
+				MessageQueue::get_singleton()->push_callp(nodes[i], p_function, p_args, p_argcount);
+			}
+		} else {
+			for (int i = 0; i < node_count; i++) {
+				if (call_lock && call_skip.has(nodes[i])) {
+					continue;
+				}
 				MessageQueue::get_singleton()->push_callp(nodes[i], p_function, p_args, p_argcount);
 			}
 		}
 
 	} else {
-		for (int i = 0; i < node_count; i++) {
-			if (call_lock && call_skip.has(nodes[i])) {
-				continue;
-			}
+		// Group members tend to share a class, so the method is resolved once and reused.
+		ObjectLookupCache cache;
+		Callable::CallError ce;
 
-			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
-				Callable::CallError ce;
-				nodes[i]->callp(p_function, p_args, p_argcount, ce);
-			} else {
-				MessageQueue::get_singleton()->push_callp(nodes[i], p_function, p_args, p_argcount);
+		if (p_call_flags & GROUP_CALL_REVERSE) {
+			for (int i = node_count - 1; i >= 0; i--) {
+				if (call_lock && call_skip.has(nodes[i])) {
+					continue;
+				}
+				nodes[i]->callp_cached(cache, p_function, p_args, p_argcount, ce);
+			}
+		} else {
+			for (int i = 0; i < node_count; i++) {
+				if (call_lock && call_skip.has(nodes[i])) {
+					continue;
+				}
+				nodes[i]->callp_cached(cache, p_function, p_args, p_argcount, ce);
 			}
 		}
 	}
@@ -293,6 +370,11 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 	}
 }
 
+void SceneTree::_call_group_parallel(uint32_t p_index, GroupCallParallel *p_call) {
+	Callable::CallError ce;
+	p_call->nodes[p_index]->callp_cached(p_call->cache, *p_call->function, p_call->args, p_call->argcount, ce);
+}
+
 void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_group, int p_notification) {
 	HashMap<StringName, Group>::Iterator E = group_map.find(p_group);
 	if (!E) {
@@ -305,8 +387,9 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 
 	_update_group_order(g);
 
+	// Iterate a shared snapshot. It's only copied if the group is modified while being called.
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -356,10 +439,14 @@ void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group
 
 	_update_group_order(g);
 
+	// Iterate a shared snapshot. It's only copied if the group is modified while being called.
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
+	StringName name = p_name;
+	ObjectLookupCache cache;
+
 	call_lock++;
 
 	if (p_call_flags & GROUP_CALL_REVERSE) {
@@ -369,9 +456,9 @@ void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group
 			}
 
 			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
-				nodes[i]->set(p_name, p_value);
+				nodes[i]->set(name, p_value, nullptr, &cache);
 			} else {
-				MessageQueue::get_singleton()->push_set(nodes[i], p_name, p_value);
+				MessageQueue::get_singleton()->push_set(nodes[i], name, p_value);
 			}
 		}
 
@@ -382,9 +469,9 @@ void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group
 			}
 
 			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
-				nodes[i]->set(p_name, p_value);
+				nodes[i]->set(name, p_value, nullptr, &cache);
 			} else {
-				MessageQueue::get_singleton()->push_set(nodes[i], p_name, p_value);
+				MessageQueue::get_singleton()->push_set(nodes[i], name, p_value);
 			}
 		}
 	}
@@ -476,6 +563,8 @@ bool SceneTree::process(double p_time) {
 
 	process_tweens(p_time, false);
 
+	process_instantiations();
+
 	flush_transform_notifications(); //additional transforms after timers update
 
 	_call_idle_callbacks();
@@ -542,6 +631,23 @@ void SceneTree::process_timers(float p_delta, bool p_physics_frame) {
 	}
 }
 
+void SceneTree::process_instantiations() {
+	List<Ref<SceneTreeInstantiation>>::Element *L = instantiations.back(); //last element
+
+	for (List<Ref<SceneTreeInstantiation>>::Element *E = instantiations.front(); E;) {
+		List<Ref<SceneTreeInstantiation>>::Element *N = E->next();
+		// Keep the job alive while it runs, as it can be dropped by a callback.
+		Ref<SceneTreeInstantiation> inst = E->get();
+		if (inst->step()) {
+			instantiations.erase(E);
+		}
+		if (E == L) {
+			break; //break on last, so if new instantiations were added during list traversal, ignore them.
+		}
+		E = N;
+	}
+}
+
 void SceneTree::process_tweens(float p_delta, bool p_physics) {
 	// This methods works similarly to how SceneTreeTimers are handled.
 	List<Ref<Tween>>::Element *L = tweens.back();
@@ -593,6 +699,12 @@ void SceneTree::finalize() {
 		timer->release_connections();
 	}
 	timers.clear();
+
+	// Cancel instantiations that are still in progress.
+	for (Ref<SceneTreeInstantiation> &inst : instantiations) {
+		inst->cancel();
+	}
+	instantiations.clear();
 }
 
 void SceneTree::quit(int p_exit_code) {
@@ -847,10 +959,54 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 
 	call_lock++;
 
+	bool main_thread_only = process_thread_group_count == 0 || !(p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+
+	if (!main_thread_only) {
+		// Move the nodes of each sub-thread group to their own list, keeping their order. Groups are
+		// processed in parallel first, then the remaining nodes are processed on the main thread.
+		for (uint32_t i = 0; i < process_thread_groups.size(); i++) {
+			process_thread_groups[i].nodes.clear();
+		}
+		process_thread_group_indices.clear();
+
+		Node **main_nodes = nodes_copy.ptrw();
+		nodes = main_nodes;
+
+		uint32_t group_count = 0;
+		int main_node_count = 0;
+		for (int i = 0; i < node_count; i++) {
+			Node *n = nodes[i];
+			Node *owner = n->data.process_thread_group_owner;
+			if (!owner) {
+				main_nodes[main_node_count++] = n;
+				continue;
+			}
+			if (call_lock && call_skip.has(n)) {
+				continue;
+			}
+
+			HashMap<Node *, uint32_t>::Iterator I = process_thread_group_indices.find(owner);
+			if (!I) {
+				if (group_count == process_thread_groups.size()) {
+					process_thread_groups.push_back(ProcessThreadGroup());
+				}
+				process_thread_groups[group_count].owner = owner;
+				I = process_thread_group_indices.insert(owner, group_count++);
+			}
+			process_thread_groups[I->value].nodes.push_back(n);
+		}
+		node_count = main_node_count;
+
+		if (group_count > 0) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SceneTree::_process_thread_group, p_notification, group_count, -1, true);
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		}
+	}
+
 	for (int i = 0; i < node_count; i++) {
 		Node *n = nodes[i];
 		if (call_lock && call_skip.has(n)) {
@@ -874,6 +1030,30 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 	}
 }
 
+void SceneTree::_process_thread_group(uint32_t p_index, int p_notification) {
+	const ProcessThreadGroup &group = process_thread_groups[p_index];
+
+	// Only nodes in this group can be accessed from here, see Node::is_accessible_from_caller_thread().
+	// The previous group is restored after, since a worker waiting on other tasks may run
+	// this one nested inside the processing of another group.
+	Node *prev_group = Node::current_process_thread_group;
+	Node::current_process_thread_group = group.owner;
+
+	for (uint32_t i = 0; i < group.nodes.size(); i++) {
+		Node *n = group.nodes[i];
+		if (!n->can_process()) {
+			continue;
+		}
+		if (!n->can_process_notification(p_notification)) {
+			continue;
+		}
+
+		n->notification(p_notification);
+	}
+
+	Node::current_process_thread_group = prev_group;
+}
+
 void SceneTree::_call_input_pause(const StringName &p_group, CallInputType p_call_type, const Ref<InputEvent> &p_input, Viewport *p_viewport) {
 	HashMap<StringName, Group>::Iterator E = group_map.find(p_group);
 	if (!E) {
@@ -891,7 +1071,7 @@ void SceneTree::_call_input_pause(const StringName &p_group, CallInputType p_cal
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 
 	call_lock++;
 
@@ -978,7 +1158,7 @@ TypedArray<Node> SceneTree::_get_nodes_in_group(const StringName &p_group) {
 
 	ret.resize(nc);
 
-	Node **ptr = E->value.nodes.ptrw();
+	Node *const *ptr = E->value.nodes.ptr();
 	for (int i = 0; i < nc; i++) {
 		ret[i] = ptr[i];
 	}
@@ -1016,7 +1196,7 @@ void SceneTree::get_nodes_in_group(const StringName &p_group, List<Node *> *p_li
 	if (nc == 0) {
 		return;
 	}
-	Node **ptr = E->value.nodes.ptrw();
+	Node *const *ptr = E->value.nodes.ptr();
 	for (int i = 0; i < nc; i++) {
 		p_list->push_back(ptr[i]);
 	}
@@ -1136,6 +1316,15 @@ Ref<Tween> SceneTree::create_tween() {
 	return tween;
 }
 
+Ref<SceneTreeInstantiation> SceneTree::create_instantiation(const Ref<PackedScene> &p_scene, Node *p_parent, double p_budget_msec) {
+	Ref<SceneTreeInstantiation> inst;
+	inst.instantiate();
+	Error err = inst->start(p_scene, p_parent, p_budget_msec);
+	ERR_FAIL_COND_V(err != OK, Ref<SceneTreeInstantiation>());
+	instantiations.push_back(inst);
+	return inst;
+}
+
 TypedArray<Tween> SceneTree::get_processed_tweens() {
 	TypedArray<Tween> ret;
 	ret.resize(tweens.size());
@@ -1225,6 +1414,7 @@ void SceneTree::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("create_timer", "time_sec", "process_always", "process_in_physics", "ignore_time_scale"), &SceneTree::create_timer, DEFVAL(true), DEFVAL(false), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("create_tween"), &SceneTree::create_tween);
+	ClassDB::bind_method(D_METHOD("create_instantiation", "scene", "parent", "budget_msec"), &SceneTree::create_instantiation, DEFVAL(Variant()), DEFVAL(2.0));
 	ClassDB::bind_method(D_METHOD("get_processed_tweens"), &SceneTree::get_processed_tweens);
 
 	ClassDB::bind_method(D_METHOD("get_node_count"), &SceneTree::get_node_count);
@@ -1297,6 +1487,7 @@ void SceneTree::_bind_methods() {
 	BIND_ENUM_CONSTANT(GROUP_CALL_REVERSE);
 	BIND_ENUM_CONSTANT(GROUP_CALL_DEFERRED);
 	BIND_ENUM_CONSTANT(GROUP_CALL_UNIQUE);
+	BIND_ENUM_CONSTANT(GROUP_CALL_PARALLEL);
 }
 
 SceneTree *SceneTree::singleton = nullptr;
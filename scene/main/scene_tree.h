@@ -33,6 +33,7 @@
 
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/self_list.h"
 #include "scene/resources/mesh.h"
 
@@ -45,6 +46,7 @@ class Material;
 class Mesh;
 class MultiplayerAPI;
 class SceneDebugger;
+class SceneTreeInstantiation;
 class Tween;
 class Viewport;
 
@@ -91,6 +93,14 @@ private:
 		bool changed = false;
 	};
 
+	struct GroupCallParallel {
+		Node *const *nodes = nullptr;
+		const StringName *function = nullptr;
+		const Variant **args = nullptr;
+		int argcount = 0;
+		ObjectLookupCache cache; // Shared by all threads.
+	};
+
 	Window *root = nullptr;
 
 	uint64_t tree_version = 1;
@@ -137,6 +147,15 @@ private:
 	int call_lock = 0;
 	HashSet<Node *> call_skip; // Skip erased nodes.
 
+	// Nodes using Node::PROCESS_THREAD_GROUP_SUB_THREAD are processed in parallel, one task per group.
+	struct ProcessThreadGroup {
+		Node *owner = nullptr;
+		LocalVector<Node *> nodes;
+	};
+	int process_thread_group_count = 0; // Sub-thread groups inside the tree.
+	LocalVector<ProcessThreadGroup> process_thread_groups;
+	HashMap<Node *, uint32_t> process_thread_group_indices;
+
 	List<ObjectID> delete_queue;
 
 	HashMap<UGCall, Vector<Variant>, UGCall> unique_group_calls;
@@ -166,6 +185,7 @@ private:
 
 	List<Ref<SceneTreeTimer>> timers;
 	List<Ref<Tween>> tweens;
+	List<Ref<SceneTreeInstantiation>> instantiations;
 
 	///network///
 
@@ -182,12 +202,19 @@ private:
 	void node_renamed(Node *p_node);
 	void process_timers(float p_delta, bool p_physics_frame);
 	void process_tweens(float p_delta, bool p_physics_frame);
+	void process_instantiations();
 
 	Group *add_to_group(const StringName &p_group, Node *p_node);
 	void remove_from_group(const StringName &p_group, Node *p_node);
 	void make_group_changed(const StringName &p_group);
 
+	// Server calls made by nodes notified in between are sent in bulk.
+	void _begin_server_batch();
+	void _end_server_batch();
+
 	void _notify_group_pause(const StringName &p_group, int p_notification);
+	void _process_thread_group(uint32_t p_index, int p_notification);
+	void _call_group_parallel(uint32_t p_index, GroupCallParallel *p_call);
 	void _call_group_flags(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	void _call_group(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 
@@ -198,6 +225,8 @@ private:
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
+	// Incremented whenever nodes may leave xform_change_list, invalidating the dirty subtrees recorded by Node3D.
+	SafeNumeric<uint64_t> xform_propagation_pass{ 1 };
 
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
@@ -239,6 +268,7 @@ public:
 		GROUP_CALL_REVERSE = 1,
 		GROUP_CALL_DEFERRED = 2,
 		GROUP_CALL_UNIQUE = 4,
+		GROUP_CALL_PARALLEL = 8,
 	};
 
 	_FORCE_INLINE_ Window *get_root() const { return root; }
@@ -364,6 +394,7 @@ public:
 
 	Ref<SceneTreeTimer> create_timer(double p_delay_sec, bool p_process_always = true, bool p_process_in_physics = false, bool p_ignore_time_scale = false);
 	Ref<Tween> create_tween();
+	Ref<SceneTreeInstantiation> create_instantiation(const Ref<PackedScene> &p_scene, Node *p_parent = nullptr, double p_budget_msec = 2.0);
 	TypedArray<Tween> get_processed_tweens();
 
 	//used by Main::start, don't use otherwise
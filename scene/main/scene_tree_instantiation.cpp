@@ -0,0 +1,161 @@
+/*************************************************************************/
+/*  scene_tree_instantiation.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "scene_tree_instantiation.h"
+
+#include "core/os/os.h"
+#include "scene/main/node.h"
+
+void SceneTreeInstantiation::_free_nodes() {
+	// Every constructed node is either below the root or in the stray list.
+	if (state.next_node > 0 && state.nodes[0]) {
+		memdelete(state.nodes[0]);
+	}
+	while (state.stray_instances.size()) {
+		memdelete(state.stray_instances.front()->get());
+		state.stray_instances.pop_front();
+	}
+	state.nodes.clear();
+	state.next_node = 0;
+}
+
+Error SceneTreeInstantiation::start(const Ref<PackedScene> &p_scene, Node *p_parent, double p_budget_msec) {
+	ERR_FAIL_COND_V(p_scene.is_null(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_budget_msec < 0, ERR_INVALID_PARAMETER);
+
+	scene = p_scene;
+	scene_state = p_scene->get_state();
+	ERR_FAIL_COND_V(scene_state.is_null(), ERR_UNCONFIGURED);
+
+	if (p_parent) {
+		parent = p_parent->get_instance_id();
+		has_parent = true;
+	}
+	budget_usec = uint64_t(p_budget_msec * 1000.0);
+
+	return scene_state->instantiate_begin(state, SceneState::GEN_EDIT_STATE_DISABLED);
+}
+
+bool SceneTreeInstantiation::step() {
+	if (completed) {
+		return true;
+	}
+
+	uint64_t until = OS::get_singleton()->get_ticks_usec() + budget_usec;
+
+	// At least one node is constructed per step, so a budget too small for any node still makes progress.
+	int node_count = scene_state->get_node_count();
+	while (state.next_node < node_count) {
+		if (scene_state->instantiate_next(state) != OK) {
+			_free_nodes();
+			completed = true;
+			emit_signal(SNAME("completed"), (Object *)nullptr);
+			return true;
+		}
+		if (OS::get_singleton()->get_ticks_usec() >= until) {
+			return false;
+		}
+	}
+
+	if (!constructed) {
+		constructed = true;
+		if (OS::get_singleton()->get_ticks_usec() >= until) {
+			// Inserting the scene runs all the enter tree and ready callbacks, so it gets a step of its own.
+			return false;
+		}
+	}
+
+	Node *root = scene_state->instantiate_end(state);
+	state.nodes.clear();
+	state.stray_instances.clear();
+	if (root) {
+		scene->_finish_instance(root, PackedScene::GEN_EDIT_STATE_DISABLED);
+
+		if (has_parent) {
+			Node *parent_node = Object::cast_to<Node>(ObjectDB::get_instance(parent));
+			if (parent_node) {
+				parent_node->add_child(root);
+			} else {
+				// The parent was freed while the scene was being constructed.
+				memdelete(root);
+				root = nullptr;
+			}
+		}
+	}
+
+	if (root) {
+		node = root->get_instance_id();
+	}
+	completed = true;
+	emit_signal(SNAME("completed"), root);
+	return true;
+}
+
+double SceneTreeInstantiation::get_progress() const {
+	if (completed) {
+		return 1.0;
+	}
+	if (scene_state.is_null()) {
+		return 0.0;
+	}
+	// The final step, which inserts the scene, counts as one more node.
+	return double(state.next_node) / double(scene_state->get_node_count() + 1);
+}
+
+bool SceneTreeInstantiation::is_completed() const {
+	return completed;
+}
+
+Node *SceneTreeInstantiation::get_node() const {
+	return Object::cast_to<Node>(ObjectDB::get_instance(node));
+}
+
+void SceneTreeInstantiation::cancel() {
+	if (completed) {
+		return;
+	}
+	_free_nodes();
+	completed = true;
+}
+
+void SceneTreeInstantiation::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_progress"), &SceneTreeInstantiation::get_progress);
+	ClassDB::bind_method(D_METHOD("is_completed"), &SceneTreeInstantiation::is_completed);
+	ClassDB::bind_method(D_METHOD("get_node"), &SceneTreeInstantiation::get_node);
+	ClassDB::bind_method(D_METHOD("cancel"), &SceneTreeInstantiation::cancel);
+
+	ADD_SIGNAL(MethodInfo("completed", PropertyInfo(Variant::OBJECT, "node", PROPERTY_HINT_RESOURCE_TYPE, "Node")));
+}
+
+SceneTreeInstantiation::~SceneTreeInstantiation() {
+	if (!completed) {
+		_free_nodes();
+	}
+}
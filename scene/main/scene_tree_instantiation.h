@@ -0,0 +1,70 @@
+/*************************************************************************/
+/*  scene_tree_instantiation.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SCENE_TREE_INSTANTIATION_H
+#define SCENE_TREE_INSTANTIATION_H
+
+#include "core/object/ref_counted.h"
+#include "scene/resources/packed_scene.h"
+
+class SceneTreeInstantiation : public RefCounted {
+	GDCLASS(SceneTreeInstantiation, RefCounted);
+
+	Ref<PackedScene> scene;
+	Ref<SceneState> scene_state;
+	SceneState::InstantiateState state;
+
+	ObjectID parent;
+	bool has_parent = false;
+	uint64_t budget_usec = 0;
+
+	ObjectID node;
+	bool constructed = false;
+	bool completed = false;
+
+	void _free_nodes();
+
+protected:
+	static void _bind_methods();
+
+public:
+	Error start(const Ref<PackedScene> &p_scene, Node *p_parent, double p_budget_msec);
+	bool step();
+
+	double get_progress() const;
+	bool is_completed() const;
+	Node *get_node() const;
+	void cancel();
+
+	SceneTreeInstantiation() {}
+	~SceneTreeInstantiation();
+};
+
+#endif // SCENE_TREE_INSTANTIATION_H
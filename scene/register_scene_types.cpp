@@ -134,7 +134,9 @@
 #include "scene/main/missing_node.h"
 #include "scene/main/multiplayer_api.h"
 #include "scene/main/resource_preloader.h"
+#include "scene/main/scene_pool.h"
 #include "scene/main/scene_tree.h"
+#include "scene/main/scene_tree_instantiation.h"
 #include "scene/main/timer.h"
 #include "scene/main/viewport.h"
 #include "scene/main/window.h"
@@ -337,6 +339,7 @@ void register_scene_types() {
 	GDREGISTER_CLASS(CanvasLayer);
 	GDREGISTER_CLASS(CanvasModulate);
 	GDREGISTER_CLASS(ResourcePreloader);
+	GDREGISTER_CLASS(ScenePool);
 	GDREGISTER_CLASS(Window);
 
 	/* REGISTER GUI */
@@ -947,6 +950,7 @@ void register_scene_types() {
 
 	GDREGISTER_CLASS(SceneTree);
 	GDREGISTER_ABSTRACT_CLASS(SceneTreeTimer); // sorry, you can't create it
+	GDREGISTER_ABSTRACT_CLASS(SceneTreeInstantiation);
 
 #ifndef DISABLE_DEPRECATED
 	// Dropped in 4.0, near approximation.
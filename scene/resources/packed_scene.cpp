@@ -70,338 +70,378 @@ static Array _sanitize_node_pinned_properties(Node *p_node) {
 	return pinned;
 }
 
-Node *SceneState::instantiate(GenEditState p_edit_state) const {
-	// nodes where instancing failed (because something is missing)
-	List<Node *> stray_instances;
-
-#define NODE_FROM_ID(p_name, p_id)                      \
-	Node *p_name;                                       \
-	if (p_id & FLAG_ID_IS_PATH) {                       \
-		NodePath np = node_paths[p_id & FLAG_MASK];     \
-		p_name = ret_nodes[0]->get_node_or_null(np);    \
-	} else {                                            \
-		ERR_FAIL_INDEX_V(p_id &FLAG_MASK, nc, nullptr); \
-		p_name = ret_nodes[p_id & FLAG_MASK];           \
+void SceneState::_update_instantiate_plan() const {
+	MutexLock lock(instantiate_plan_mutex);
+	if (instantiate_plan_valid.is_set()) {
+		return;
 	}
 
 	int nc = nodes.size();
-	ERR_FAIL_COND_V(nc == 0, nullptr);
-
-	const StringName *snames = nullptr;
-	int sname_count = names.size();
-	if (sname_count) {
-		snames = &names[0];
+	instantiate_plan.property_offsets.resize(nc);
+	uint32_t property_count = 0;
+	for (int i = 0; i < nc; i++) {
+		instantiate_plan.property_offsets[i] = property_count;
+		property_count += nodes[i].properties.size();
 	}
+	// Caches validate the class and name they were filled for, so stale entries are only misses.
+	instantiate_plan.property_caches.clear();
+	instantiate_plan.property_caches.resize(property_count);
 
-	const Variant *props = nullptr;
-	int prop_count = variants.size();
-	if (prop_count) {
-		props = &variants[0];
+	instantiate_plan_valid.set();
+}
+
+#define NODE_FROM_ID(p_name, p_id, m_retval)                 \
+	Node *p_name;                                            \
+	if (p_id & FLAG_ID_IS_PATH) {                            \
+		NodePath np = node_paths[p_id & FLAG_MASK];          \
+		p_name = ret_nodes[0]->get_node_or_null(np);         \
+	} else {                                                 \
+		ERR_FAIL_INDEX_V(p_id &FLAG_MASK, nc, m_retval);     \
+		p_name = ret_nodes[p_id & FLAG_MASK];                \
 	}
 
-	//Vector<Variant> properties;
+Error SceneState::instantiate_begin(InstantiateState &r_state, GenEditState p_edit_state) const {
+	ERR_FAIL_COND_V(nodes.is_empty(), ERR_UNCONFIGURED);
 
-	const NodeData *nd = &nodes[0];
+	if (!instantiate_plan_valid.is_set()) {
+		_update_instantiate_plan();
+	}
+	ERR_FAIL_COND_V(instantiate_plan.property_offsets.size() != (uint32_t)nodes.size(), ERR_BUG);
 
-	Node **ret_nodes = (Node **)alloca(sizeof(Node *) * nc);
+	r_state.edit_state = p_edit_state;
+	r_state.next_node = 0;
+	r_state.nodes.clear();
+	r_state.nodes.resize(nodes.size());
+	r_state.stray_instances.clear();
+	r_state.resources_local_to_scene.clear();
+	r_state.deferred_node_paths.clear();
+	r_state.gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.is_empty();
+	return OK;
+}
 
-	bool gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.is_empty();
+Error SceneState::instantiate_next(InstantiateState &r_state) const {
+	int nc = nodes.size();
+	ERR_FAIL_COND_V(r_state.nodes.size() != (uint32_t)nc, ERR_INVALID_PARAMETER);
+	ERR_FAIL_INDEX_V(r_state.next_node, nc, ERR_INVALID_PARAMETER);
 
-	HashMap<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
+	const StringName *snames = names.ptr();
+	int sname_count = names.size();
+	const Variant *props = variants.ptr();
+	int prop_count = variants.size();
+	ObjectLookupCache *property_caches = instantiate_plan.property_caches.ptr();
 
-	LocalVector<DeferredNodePathProperties> deferred_node_paths;
+	GenEditState edit_state = r_state.edit_state;
+	Node **ret_nodes = r_state.nodes.ptr();
+	List<Node *> &stray_instances = r_state.stray_instances;
+	HashMap<Ref<Resource>, Ref<Resource>> &resources_local_to_scene = r_state.resources_local_to_scene;
+	LocalVector<DeferredNodePathProperties> &deferred_node_paths = r_state.deferred_node_paths;
 
-	for (int i = 0; i < nc; i++) {
-		const NodeData &n = nd[i];
+	int i = r_state.next_node++;
+	const NodeData &n = nodes[i];
 
-		Node *parent = nullptr;
-		String old_parent_path;
+	Node *parent = nullptr;
+	String old_parent_path;
 
-		if (i > 0) {
-			ERR_FAIL_COND_V_MSG(n.parent == -1, nullptr, vformat("Invalid scene: node %s does not specify its parent node.", snames[n.name]));
-			NODE_FROM_ID(nparent, n.parent);
+	if (i > 0) {
+		ERR_FAIL_COND_V_MSG(n.parent == -1, FAILED, vformat("Invalid scene: node %s does not specify its parent node.", snames[n.name]));
+		NODE_FROM_ID(nparent, n.parent, FAILED);
 #ifdef DEBUG_ENABLED
-			if (!nparent && (n.parent & FLAG_ID_IS_PATH)) {
-				WARN_PRINT(String("Parent path '" + String(node_paths[n.parent & FLAG_MASK]) + "' for node '" + String(snames[n.name]) + "' has vanished when instancing: '" + get_path() + "'.").ascii().get_data());
-				old_parent_path = String(node_paths[n.parent & FLAG_MASK]).trim_prefix("./").replace("/", "@");
-				nparent = ret_nodes[0];
-			}
+		if (!nparent && (n.parent & FLAG_ID_IS_PATH)) {
+			WARN_PRINT(String("Parent path '" + String(node_paths[n.parent & FLAG_MASK]) + "' for node '" + String(snames[n.name]) + "' has vanished when instancing: '" + get_path() + "'.").ascii().get_data());
+			old_parent_path = String(node_paths[n.parent & FLAG_MASK]).trim_prefix("./").replace("/", "@");
+			nparent = ret_nodes[0];
+		}
 #endif
-			parent = nparent;
-		} else {
-			// i == 0 is root node.
-			ERR_FAIL_COND_V_MSG(n.parent != -1, nullptr, vformat("Invalid scene: root node %s cannot specify a parent node.", snames[n.name]));
-			ERR_FAIL_COND_V_MSG(n.type == TYPE_INSTANCED && base_scene_idx < 0, nullptr, vformat("Invalid scene: root node %s in an instance, but there's no base scene.", snames[n.name]));
+		parent = nparent;
+	} else {
+		// i == 0 is root node.
+		ERR_FAIL_COND_V_MSG(n.parent != -1, FAILED, vformat("Invalid scene: root node %s cannot specify a parent node.", snames[n.name]));
+		ERR_FAIL_COND_V_MSG(n.type == TYPE_INSTANCED && base_scene_idx < 0, FAILED, vformat("Invalid scene: root node %s in an instance, but there's no base scene.", snames[n.name]));
+	}
+
+	Node *node = nullptr;
+	MissingNode *missing_node = nullptr;
+
+	if (i == 0 && base_scene_idx >= 0) {
+		//scene inheritance on root node
+		Ref<PackedScene> sdata = props[base_scene_idx];
+		ERR_FAIL_COND_V(!sdata.is_valid(), FAILED);
+		node = sdata->instantiate(edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE); //only main gets main edit state
+		ERR_FAIL_COND_V(!node, FAILED);
+		if (edit_state != GEN_EDIT_STATE_DISABLED) {
+			node->set_scene_inherited_state(sdata->get_state());
 		}
 
-		Node *node = nullptr;
-		MissingNode *missing_node = nullptr;
-
-		if (i == 0 && base_scene_idx >= 0) {
-			//scene inheritance on root node
-			Ref<PackedScene> sdata = props[base_scene_idx];
-			ERR_FAIL_COND_V(!sdata.is_valid(), nullptr);
-			node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE); //only main gets main edit state
-			ERR_FAIL_COND_V(!node, nullptr);
-			if (p_edit_state != GEN_EDIT_STATE_DISABLED) {
-				node->set_scene_inherited_state(sdata->get_state());
-			}
-
-		} else if (n.instance >= 0) {
-			//instance a scene into this node
-			if (n.instance & FLAG_INSTANCE_IS_PLACEHOLDER) {
-				String path = props[n.instance & FLAG_MASK];
-				if (disable_placeholders) {
-					Ref<PackedScene> sdata = ResourceLoader::load(path, "PackedScene");
-					ERR_FAIL_COND_V(!sdata.is_valid(), nullptr);
-					node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
-					ERR_FAIL_COND_V(!node, nullptr);
-				} else {
-					InstancePlaceholder *ip = memnew(InstancePlaceholder);
-					ip->set_instance_path(path);
-					node = ip;
-				}
-				node->set_scene_instance_load_placeholder(true);
+	} else if (n.instance >= 0) {
+		//instance a scene into this node
+		if (n.instance & FLAG_INSTANCE_IS_PLACEHOLDER) {
+			String path = props[n.instance & FLAG_MASK];
+			if (disable_placeholders) {
+				Ref<PackedScene> sdata = ResourceLoader::load(path, "PackedScene");
+				ERR_FAIL_COND_V(!sdata.is_valid(), FAILED);
+				node = sdata->instantiate(edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
+				ERR_FAIL_COND_V(!node, FAILED);
 			} else {
-				Ref<PackedScene> sdata = props[n.instance & FLAG_MASK];
-				ERR_FAIL_COND_V(!sdata.is_valid(), nullptr);
-				node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
-				ERR_FAIL_COND_V(!node, nullptr);
+				InstancePlaceholder *ip = memnew(InstancePlaceholder);
+				ip->set_instance_path(path);
+				node = ip;
 			}
+			node->set_scene_instance_load_placeholder(true);
+		} else {
+			Ref<PackedScene> sdata = props[n.instance & FLAG_MASK];
+			ERR_FAIL_COND_V(!sdata.is_valid(), FAILED);
+			node = sdata->instantiate(edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
+			ERR_FAIL_COND_V(!node, FAILED);
+		}
 
-		} else if (n.type == TYPE_INSTANCED) {
-			//get the node from somewhere, it likely already exists from another instance
-			if (parent) {
-				node = parent->_get_child_by_name(snames[n.name]);
+	} else if (n.type == TYPE_INSTANCED) {
+		//get the node from somewhere, it likely already exists from another instance
+		if (parent) {
+			node = parent->_get_child_by_name(snames[n.name]);
 #ifdef DEBUG_ENABLED
-				if (!node) {
-					WARN_PRINT(String("Node '" + String(ret_nodes[0]->get_path_to(parent)) + "/" + String(snames[n.name]) + "' was modified from inside an instance, but it has vanished.").ascii().get_data());
-				}
-#endif
+			if (!node) {
+				WARN_PRINT(String("Node '" + String(ret_nodes[0]->get_path_to(parent)) + "/" + String(snames[n.name]) + "' was modified from inside an instance, but it has vanished.").ascii().get_data());
 			}
-		} else {
-			//node belongs to this scene and must be created
-			Object *obj = ClassDB::instantiate(snames[n.type]);
+#endif
+		}
+	} else {
+		//node belongs to this scene and must be created
+		Object *obj = ClassDB::instantiate(snames[n.type]);
 
-			node = Object::cast_to<Node>(obj);
+		node = Object::cast_to<Node>(obj);
 
-			if (!node) {
-				if (obj) {
-					memdelete(obj);
-					obj = nullptr;
-				}
+		if (!node) {
+			if (obj) {
+				memdelete(obj);
+				obj = nullptr;
+			}
 
-				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
-					missing_node = memnew(MissingNode);
-					missing_node->set_original_class(snames[n.type]);
-					missing_node->set_recording_properties(true);
-					node = missing_node;
-					obj = missing_node;
-				} else {
-					WARN_PRINT(vformat("Node %s of type %s cannot be created. A placeholder will be created instead.", snames[n.name], snames[n.type]).ascii().get_data());
-					if (n.parent >= 0 && n.parent < nc && ret_nodes[n.parent]) {
-						if (Object::cast_to<Control>(ret_nodes[n.parent])) {
-							obj = memnew(Control);
-						} else if (Object::cast_to<Node2D>(ret_nodes[n.parent])) {
-							obj = memnew(Node2D);
+			if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+				missing_node = memnew(MissingNode);
+				missing_node->set_original_class(snames[n.type]);
+				missing_node->set_recording_properties(true);
+				node = missing_node;
+				obj = missing_node;
+			} else {
+				WARN_PRINT(vformat("Node %s of type %s cannot be created. A placeholder will be created instead.", snames[n.name], snames[n.type]).ascii().get_data());
+				if (n.parent >= 0 && n.parent < nc && ret_nodes[n.parent]) {
+					if (Object::cast_to<Control>(ret_nodes[n.parent])) {
+						obj = memnew(Control);
+					} else if (Object::cast_to<Node2D>(ret_nodes[n.parent])) {
+						obj = memnew(Node2D);
 #ifndef _3D_DISABLED
-						} else if (Object::cast_to<Node3D>(ret_nodes[n.parent])) {
-							obj = memnew(Node3D);
+					} else if (Object::cast_to<Node3D>(ret_nodes[n.parent])) {
+						obj = memnew(Node3D);
 #endif // _3D_DISABLED
-						}
-					}
-
-					if (!obj) {
-						obj = memnew(Node);
 					}
+				}
 
-					node = Object::cast_to<Node>(obj);
+				if (!obj) {
+					obj = memnew(Node);
 				}
+
+				node = Object::cast_to<Node>(obj);
 			}
 		}
+	}
 
-		if (node) {
-			// may not have found the node (part of instantiated scene and removed)
-			// if found all is good, otherwise ignore
-
-			//properties
-			int nprop_count = n.properties.size();
-			if (nprop_count) {
-				const NodeData::Property *nprops = &n.properties[0];
-
-				Dictionary missing_resource_properties;
-
-				for (int j = 0; j < nprop_count; j++) {
-					bool valid;
-
-					ERR_FAIL_INDEX_V(nprops[j].value, prop_count, nullptr);
-
-					if (nprops[j].name & FLAG_PATH_PROPERTY_IS_NODE) {
-						uint32_t name_idx = nprops[j].name & (FLAG_PATH_PROPERTY_IS_NODE - 1);
-						ERR_FAIL_UNSIGNED_INDEX_V(name_idx, (uint32_t)sname_count, nullptr);
-						if (Engine::get_singleton()->is_editor_hint()) {
-							// If editor, just set the metadata and be it
-							node->set(META_POINTER_PROPERTY_BASE + String(snames[name_idx]), props[nprops[j].value]);
-						} else {
-							// Do an actual deferred sed of the property path.
-							DeferredNodePathProperties dnp;
-							dnp.path = props[nprops[j].value];
-							dnp.base = node;
-							dnp.property = snames[name_idx];
-							deferred_node_paths.push_back(dnp);
-						}
-						continue;
-					}
+	if (node) {
+		// may not have found the node (part of instantiated scene and removed)
+		// if found all is good, otherwise ignore
 
-					ERR_FAIL_INDEX_V(nprops[j].name, sname_count, nullptr);
+		//properties
+		int nprop_count = n.properties.size();
+		if (nprop_count) {
+			const NodeData::Property *nprops = &n.properties[0];
+			ObjectLookupCache *nprop_caches = &property_caches[instantiate_plan.property_offsets[i]];
 
-					if (snames[nprops[j].name] == CoreStringNames::get_singleton()->_script) {
-						//work around to avoid old script variables from disappearing, should be the proper fix to:
-						//https://github.com/godotengine/godot/issues/2958
+			Dictionary missing_resource_properties;
 
-						//store old state
-						List<Pair<StringName, Variant>> old_state;
-						if (node->get_script_instance()) {
-							node->get_script_instance()->get_property_state(old_state);
-						}
+			for (int j = 0; j < nprop_count; j++) {
+				bool valid;
 
-						node->set(snames[nprops[j].name], props[nprops[j].value], &valid);
+				ERR_FAIL_INDEX_V(nprops[j].value, prop_count, FAILED);
 
-						//restore old state for new script, if exists
-						for (const Pair<StringName, Variant> &E : old_state) {
-							node->set(E.first, E.second);
-						}
+				if (nprops[j].name & FLAG_PATH_PROPERTY_IS_NODE) {
+					uint32_t name_idx = nprops[j].name & (FLAG_PATH_PROPERTY_IS_NODE - 1);
+					ERR_FAIL_UNSIGNED_INDEX_V(name_idx, (uint32_t)sname_count, FAILED);
+					if (Engine::get_singleton()->is_editor_hint()) {
+						// If editor, just set the metadata and be it
+						node->set(META_POINTER_PROPERTY_BASE + String(snames[name_idx]), props[nprops[j].value]);
 					} else {
-						Variant value = props[nprops[j].value];
-
-						if (value.get_type() == Variant::OBJECT) {
-							//handle resources that are local to scene by duplicating them if needed
-							Ref<Resource> res = value;
-							if (res.is_valid()) {
-								if (res->is_local_to_scene()) {
-									// In a situation where a local-to-scene resource is used in a child node of a non-editable instance,
-									// we need to avoid the parent scene from overriding the resource potentially also used in the root
-									// of the instantiated scene. That would to the instance having two different instances of the resource.
-									// Since at this point it's too late to propagate the resource instance in the parent scene to all the relevant
-									// nodes in the instance (and that would require very complex bookkepping), what we do instead is
-									// tampering the resource object already there with the values from the node in the parent scene and
-									// then tell this node to reference that resource.
-									if (n.instance >= 0) {
-										Ref<Resource> node_res = node->get(snames[nprops[j].name]);
-										if (node_res.is_valid()) {
-											node_res->copy_from(res);
-											node_res->configure_for_local_scene(node, resources_local_to_scene);
-											value = node_res;
-										}
+						// Do an actual deferred sed of the property path.
+						DeferredNodePathProperties dnp;
+						dnp.path = props[nprops[j].value];
+						dnp.base = node;
+						dnp.property = snames[name_idx];
+						deferred_node_paths.push_back(dnp);
+					}
+					continue;
+				}
+
+				ERR_FAIL_INDEX_V(nprops[j].name, sname_count, FAILED);
+
+				if (snames[nprops[j].name] == CoreStringNames::get_singleton()->_script) {
+					//work around to avoid old script variables from disappearing, should be the proper fix to:
+					//https://github.com/godotengine/godot/issues/2958
+
+					//store old state
+					List<Pair<StringName, Variant>> old_state;
+					if (node->get_script_instance()) {
+						node->get_script_instance()->get_property_state(old_state);
+					}
+
+					node->set(snames[nprops[j].name], props[nprops[j].value], &valid);
+
+					//restore old state for new script, if exists
+					for (const Pair<StringName, Variant> &E : old_state) {
+						node->set(E.first, E.second);
+					}
+				} else {
+					Variant value = props[nprops[j].value];
+
+					if (value.get_type() == Variant::OBJECT) {
+						//handle resources that are local to scene by duplicating them if needed
+						Ref<Resource> res = value;
+						if (res.is_valid()) {
+							if (res->is_local_to_scene()) {
+								// In a situation where a local-to-scene resource is used in a child node of a non-editable instance,
+								// we need to avoid the parent scene from overriding the resource potentially also used in the root
+								// of the instantiated scene. That would to the instance having two different instances of the resource.
+								// Since at this point it's too late to propagate the resource instance in the parent scene to all the relevant
+								// nodes in the instance (and that would require very complex bookkepping), what we do instead is
+								// tampering the resource object already there with the values from the node in the parent scene and
+								// then tell this node to reference that resource.
+								if (n.instance >= 0) {
+									Ref<Resource> node_res = node->get(snames[nprops[j].name]);
+									if (node_res.is_valid()) {
+										node_res->copy_from(res);
+										node_res->configure_for_local_scene(node, resources_local_to_scene);
+										value = node_res;
+									}
+								} else {
+									HashMap<Ref<Resource>, Ref<Resource>>::Iterator E = resources_local_to_scene.find(res);
+									Node *base = i == 0 ? node : ret_nodes[0];
+									if (E) {
+										value = E->value;
 									} else {
-										HashMap<Ref<Resource>, Ref<Resource>>::Iterator E = resources_local_to_scene.find(res);
-										Node *base = i == 0 ? node : ret_nodes[0];
-										if (E) {
-											value = E->value;
+										if (edit_state == GEN_EDIT_STATE_MAIN) {
+											//for the main scene, use the resource as is
+											res->configure_for_local_scene(base, resources_local_to_scene);
+											resources_local_to_scene[res] = res;
 										} else {
-											if (p_edit_state == GEN_EDIT_STATE_MAIN) {
-												//for the main scene, use the resource as is
-												res->configure_for_local_scene(base, resources_local_to_scene);
-												resources_local_to_scene[res] = res;
-											} else {
-												//for instances, a copy must be made
-												Ref<Resource> local_dupe = res->duplicate_for_local_scene(base, resources_local_to_scene);
-												resources_local_to_scene[res] = local_dupe;
-												value = local_dupe;
-											}
+											//for instances, a copy must be made
+											Ref<Resource> local_dupe = res->duplicate_for_local_scene(base, resources_local_to_scene);
+											resources_local_to_scene[res] = local_dupe;
+											value = local_dupe;
 										}
 									}
-									//must make a copy, because this res is local to scene
 								}
+								//must make a copy, because this res is local to scene
 							}
-						} else if (p_edit_state == GEN_EDIT_STATE_INSTANCE) {
-							value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
 						}
+					} else if (edit_state == GEN_EDIT_STATE_INSTANCE) {
+						value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
+					}
 
-						bool set_valid = true;
-						if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled() && value.get_type() == Variant::OBJECT) {
-							Ref<MissingResource> mr = value;
-							if (mr.is_valid()) {
-								missing_resource_properties[snames[nprops[j].name]] = mr;
-								set_valid = false;
-							}
+					bool set_valid = true;
+					if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled() && value.get_type() == Variant::OBJECT) {
+						Ref<MissingResource> mr = value;
+						if (mr.is_valid()) {
+							missing_resource_properties[snames[nprops[j].name]] = mr;
+							set_valid = false;
 						}
+					}
 
-						if (set_valid) {
-							node->set(snames[nprops[j].name], value, &valid);
-						}
+					if (set_valid) {
+						node->set(snames[nprops[j].name], value, &valid, &nprop_caches[j]);
 					}
 				}
-				if (!missing_resource_properties.is_empty()) {
-					node->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
-				}
 			}
+			if (!missing_resource_properties.is_empty()) {
+				node->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+			}
+		}
 
-			//name
+		//name
 
-			//groups
-			for (int j = 0; j < n.groups.size(); j++) {
-				ERR_FAIL_INDEX_V(n.groups[j], sname_count, nullptr);
-				node->add_to_group(snames[n.groups[j]], true);
-			}
+		//groups
+		for (int j = 0; j < n.groups.size(); j++) {
+			ERR_FAIL_INDEX_V(n.groups[j], sname_count, FAILED);
+			node->add_to_group(snames[n.groups[j]], true);
+		}
 
-			if (n.instance >= 0 || n.type != TYPE_INSTANCED || i == 0) {
-				//if node was not part of instance, must set its name, parenthood and ownership
-				if (i > 0) {
-					if (parent) {
-						parent->_add_child_nocheck(node, snames[n.name]);
-						if (n.index >= 0 && n.index < parent->get_child_count() - 1) {
-							parent->move_child(node, n.index);
-						}
-					} else {
-						//it may be possible that an instantiated scene has changed
-						//and the node has nowhere to go anymore
-						stray_instances.push_back(node); //can't be added, go to stray list
+		if (n.instance >= 0 || n.type != TYPE_INSTANCED || i == 0) {
+			//if node was not part of instance, must set its name, parenthood and ownership
+			if (i > 0) {
+				if (parent) {
+					parent->_add_child_nocheck(node, snames[n.name]);
+					if (n.index >= 0 && n.index < parent->get_child_count() - 1) {
+						parent->move_child(node, n.index);
 					}
 				} else {
-					if (Engine::get_singleton()->is_editor_hint()) {
-						//validate name if using editor, to avoid broken
-						node->set_name(snames[n.name]);
-					} else {
-						node->_set_name_nocheck(snames[n.name]);
-					}
+					//it may be possible that an instantiated scene has changed
+					//and the node has nowhere to go anymore
+					stray_instances.push_back(node); //can't be added, go to stray list
+				}
+			} else {
+				if (Engine::get_singleton()->is_editor_hint()) {
+					//validate name if using editor, to avoid broken
+					node->set_name(snames[n.name]);
+				} else {
+					node->_set_name_nocheck(snames[n.name]);
 				}
 			}
+		}
 
-			if (!old_parent_path.is_empty()) {
-				node->_set_name_nocheck(old_parent_path + "@" + node->get_name());
-			}
+		if (!old_parent_path.is_empty()) {
+			node->_set_name_nocheck(old_parent_path + "@" + node->get_name());
+		}
 
-			if (n.owner >= 0) {
-				NODE_FROM_ID(owner, n.owner);
-				if (owner) {
-					node->_set_owner_nocheck(owner);
-					if (node->data.unique_name_in_owner) {
-						node->_acquire_unique_name_in_owner();
-					}
+		if (n.owner >= 0) {
+			NODE_FROM_ID(owner, n.owner, FAILED);
+			if (owner) {
+				node->_set_owner_nocheck(owner);
+				if (node->data.unique_name_in_owner) {
+					node->_acquire_unique_name_in_owner();
 				}
 			}
-
-			// we only want to deal with pinned flag if instancing as pure main (no instance, no inheriting)
-			if (p_edit_state == GEN_EDIT_STATE_MAIN) {
-				_sanitize_node_pinned_properties(node);
-			} else {
-				node->remove_meta("_edit_pinned_properties_");
-			}
 		}
 
-		if (missing_node) {
-			missing_node->set_recording_properties(false);
+		// we only want to deal with pinned flag if instancing as pure main (no instance, no inheriting)
+		if (edit_state == GEN_EDIT_STATE_MAIN) {
+			_sanitize_node_pinned_properties(node);
+		} else {
+			node->remove_meta("_edit_pinned_properties_");
 		}
+	}
 
-		ret_nodes[i] = node;
+	if (missing_node) {
+		missing_node->set_recording_properties(false);
+	}
 
-		if (node && gen_node_path_cache && ret_nodes[0]) {
-			NodePath n2 = ret_nodes[0]->get_path_to(node);
-			node_path_cache[n2] = i;
-		}
+	ret_nodes[i] = node;
+
+	if (node && r_state.gen_node_path_cache && ret_nodes[0]) {
+		NodePath n2 = ret_nodes[0]->get_path_to(node);
+		node_path_cache[n2] = i;
 	}
 
+	return OK;
+}
+
+Node *SceneState::instantiate_end(InstantiateState &r_state) const {
+	int nc = nodes.size();
+	ERR_FAIL_COND_V(r_state.nodes.size() != (uint32_t)nc || r_state.next_node != nc, nullptr);
+
+	const StringName *snames = names.ptr();
+	const Variant *props = variants.ptr();
+
+	Node **ret_nodes = r_state.nodes.ptr();
+	List<Node *> &stray_instances = r_state.stray_instances;
+	HashMap<Ref<Resource>, Ref<Resource>> &resources_local_to_scene = r_state.resources_local_to_scene;
+	LocalVector<DeferredNodePathProperties> &deferred_node_paths = r_state.deferred_node_paths;
+
 	for (uint32_t i = 0; i < deferred_node_paths.size(); i++) {
 		const DeferredNodePathProperties &dnp = deferred_node_paths[i];
 		Node *other = dnp.base->get_node_or_null(dnp.path);
@@ -424,8 +464,8 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 		//ERR_FAIL_INDEX_V( c.from, nc, nullptr );
 		//ERR_FAIL_INDEX_V( c.to, nc, nullptr );
 
-		NODE_FROM_ID(cfrom, c.from);
-		NODE_FROM_ID(cto, c.to);
+		NODE_FROM_ID(cfrom, c.from, nullptr);
+		NODE_FROM_ID(cto, c.to, nullptr);
 
 		if (!cfrom || !cto) {
 			continue;
@@ -471,6 +511,21 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	return ret_nodes[0];
 }
 
+Node *SceneState::instantiate(GenEditState p_edit_state) const {
+	InstantiateState state;
+	if (instantiate_begin(state, p_edit_state) != OK) {
+		return nullptr;
+	}
+	while (state.next_node < nodes.size()) {
+		if (instantiate_next(state) != OK) {
+			return nullptr;
+		}
+	}
+	return instantiate_end(state);
+}
+
+#undef NODE_FROM_ID
+
 static int _nm_get_string(const String &p_string, HashMap<StringName, int> &name_map) {
 	if (name_map.has(p_string)) {
 		return name_map[p_string];
@@ -994,7 +1049,26 @@ String SceneState::get_path() const {
 	return path;
 }
 
+void SceneState::instantiate_multiple(int p_count, GenEditState p_edit_state, Vector<Node *> &r_nodes) const {
+	ERR_FAIL_COND(p_count < 0);
+	ERR_FAIL_COND(nodes.is_empty());
+
+	int from = r_nodes.size();
+	r_nodes.resize(from + p_count);
+	Node **w = r_nodes.ptrw();
+	int created = 0;
+	for (int i = 0; i < p_count; i++) {
+		Node *node = instantiate(p_edit_state);
+		if (!node) {
+			break; // Errors are the same for every copy, no need to repeat them.
+		}
+		w[from + created++] = node;
+	}
+	r_nodes.resize(from + created);
+}
+
 void SceneState::clear() {
+	_invalidate_instantiate_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1191,6 +1265,7 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 		variants.clear();
 	}
 
+	_invalidate_instantiate_plan();
 	nodes.resize(node_count);
 	if (node_count) {
 		const int *r = snodes.ptr();
@@ -1615,6 +1690,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.index = p_index;
 
 	nodes.push_back(nd);
+	_invalidate_instantiate_plan();
 
 	return nodes.size() - 1;
 }
@@ -1631,6 +1707,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 	}
 	prop.value = p_value;
 	nodes.write[p_node].properties.push_back(prop);
+	_invalidate_instantiate_plan();
 }
 
 void SceneState::add_node_group(int p_node, int p_group) {
@@ -1737,6 +1814,18 @@ bool PackedScene::can_instantiate() const {
 	return state->can_instantiate();
 }
 
+void PackedScene::_finish_instance(Node *p_node, GenEditState p_edit_state) const {
+	if (p_edit_state != GEN_EDIT_STATE_DISABLED) {
+		p_node->set_scene_instance_state(state);
+	}
+
+	if (!is_built_in()) {
+		p_node->set_scene_file_path(get_path());
+	}
+
+	p_node->notification(Node::NOTIFICATION_SCENE_INSTANTIATED);
+}
+
 Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 #ifndef TOOLS_ENABLED
 	ERR_FAIL_COND_V_MSG(p_edit_state != GEN_EDIT_STATE_DISABLED, nullptr, "Edit state is only for editors, does not work without tools compiled.");
@@ -1747,17 +1836,33 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 		return nullptr;
 	}
 
-	if (p_edit_state != GEN_EDIT_STATE_DISABLED) {
-		s->set_scene_instance_state(state);
-	}
+	_finish_instance(s, p_edit_state);
 
-	if (!is_built_in()) {
-		s->set_scene_file_path(get_path());
+	return s;
+}
+
+void PackedScene::instantiate_multiple(int p_count, GenEditState p_edit_state, Vector<Node *> &r_nodes) const {
+#ifndef TOOLS_ENABLED
+	ERR_FAIL_COND_MSG(p_edit_state != GEN_EDIT_STATE_DISABLED, "Edit state is only for editors, does not work without tools compiled.");
+#endif
+
+	int from = r_nodes.size();
+	state->instantiate_multiple(p_count, (SceneState::GenEditState)p_edit_state, r_nodes);
+	for (int i = from; i < r_nodes.size(); i++) {
+		_finish_instance(r_nodes[i], p_edit_state);
 	}
+}
 
-	s->notification(Node::NOTIFICATION_SCENE_INSTANTIATED);
+TypedArray<Node> PackedScene::_instantiate_multiple(int p_count, GenEditState p_edit_state) const {
+	Vector<Node *> nodes;
+	instantiate_multiple(p_count, p_edit_state, nodes);
 
-	return s;
+	TypedArray<Node> ret;
+	ret.resize(nodes.size());
+	for (int i = 0; i < nodes.size(); i++) {
+		ret[i] = nodes[i];
+	}
+	return ret;
 }
 
 void PackedScene::replace_state(Ref<SceneState> p_by) {
@@ -1791,6 +1896,7 @@ void PackedScene::reset_state() {
 void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instantiate", "edit_state"), &PackedScene::instantiate, DEFVAL(GEN_EDIT_STATE_DISABLED));
+	ClassDB::bind_method(D_METHOD("instantiate_multiple", "count", "edit_state"), &PackedScene::_instantiate_multiple, DEFVAL(GEN_EDIT_STATE_DISABLED));
 	ClassDB::bind_method(D_METHOD("can_instantiate"), &PackedScene::can_instantiate);
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene", "scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
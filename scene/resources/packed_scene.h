@@ -32,6 +32,7 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/templates/local_vector.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -89,6 +90,20 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Resolved on first instantiation and reused by every instance. Each stored property gets
+	// its own lookup cache, so setters are called directly instead of being found by name.
+	struct InstantiatePlan {
+		LocalVector<uint32_t> property_offsets; // First cache of each node.
+		LocalVector<ObjectLookupCache> property_caches;
+	};
+
+	mutable InstantiatePlan instantiate_plan;
+	mutable SafeFlag instantiate_plan_valid;
+	mutable Mutex instantiate_plan_mutex;
+
+	void _update_instantiate_plan() const;
+	_FORCE_INLINE_ void _invalidate_instantiate_plan() { instantiate_plan_valid.clear(); }
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 
@@ -144,8 +159,24 @@ public:
 
 	void clear();
 
+	// Instantiation can also be done one node at a time, to spread it over several frames.
+	struct InstantiateState {
+		GenEditState edit_state = GEN_EDIT_STATE_DISABLED;
+		int next_node = 0;
+		LocalVector<Node *> nodes;
+		List<Node *> stray_instances; // Nodes where instancing failed (because something is missing).
+		HashMap<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
+		LocalVector<DeferredNodePathProperties> deferred_node_paths;
+		bool gen_node_path_cache = false;
+	};
+
+	Error instantiate_begin(InstantiateState &r_state, GenEditState p_edit_state) const;
+	Error instantiate_next(InstantiateState &r_state) const;
+	Node *instantiate_end(InstantiateState &r_state) const;
+
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state) const;
+	void instantiate_multiple(int p_count, GenEditState p_edit_state, Vector<Node *> &r_nodes) const;
 
 	Ref<SceneState> get_base_scene_state() const;
 
@@ -225,12 +256,20 @@ public:
 		GEN_EDIT_STATE_MAIN_INHERITED,
 	};
 
+private:
+	friend class SceneTreeInstantiation;
+
+	void _finish_instance(Node *p_node, GenEditState p_edit_state) const;
+	TypedArray<Node> _instantiate_multiple(int p_count, GenEditState p_edit_state) const;
+
+public:
 	Error pack(Node *p_scene);
 
 	void clear();
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
+	void instantiate_multiple(int p_count, GenEditState p_edit_state, Vector<Node *> &r_nodes) const;
 
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
@@ -30,6 +30,7 @@
 
 #include "mesh_storage.h"
 #include "../../rendering_server_globals.h"
+#include "core/math/math_batch.h"
 
 using namespace RendererRD;
 
@@ -1445,35 +1446,24 @@ void MeshStorage::_multimesh_mark_all_dirty(MultiMesh *multimesh, bool p_data, b
 
 void MeshStorage::_multimesh_re_create_aabb(MultiMesh *multimesh, const float *p_data, int p_instances) {
 	ERR_FAIL_COND(multimesh->mesh.is_null());
-	AABB aabb;
 	AABB mesh_aabb = mesh_get_aabb(multimesh->mesh);
+	if (multimesh->xform_format == RS::MULTIMESH_TRANSFORM_3D) {
+		multimesh->aabb = MathBatch::xform_aabb_merged_3x4(mesh_aabb, p_data, multimesh->stride_cache, p_instances);
+		return;
+	}
+
+	AABB aabb;
 	for (int i = 0; i < p_instances; i++) {
 		const float *data = p_data + multimesh->stride_cache * i;
 		Transform3D t;
 
-		if (multimesh->xform_format == RS::MULTIMESH_TRANSFORM_3D) {
-			t.basis.rows[0][0] = data[0];
-			t.basis.rows[0][1] = data[1];
-			t.basis.rows[0][2] = data[2];
-			t.origin.x = data[3];
-			t.basis.rows[1][0] = data[4];
-			t.basis.rows[1][1] = data[5];
-			t.basis.rows[1][2] = data[6];
-			t.origin.y = data[7];
-			t.basis.rows[2][0] = data[8];
-			t.basis.rows[2][1] = data[9];
-			t.basis.rows[2][2] = data[10];
-			t.origin.z = data[11];
-
-		} else {
-			t.basis.rows[0].x = data[0];
-			t.basis.rows[1].x = data[1];
-			t.origin.x = data[3];
+		t.basis.rows[0].x = data[0];
+		t.basis.rows[1].x = data[1];
+		t.origin.x = data[3];
 
-			t.basis.rows[0].y = data[4];
-			t.basis.rows[1].y = data[5];
-			t.origin.y = data[7];
-		}
+		t.basis.rows[0].y = data[4];
+		t.basis.rows[1].y = data[5];
+		t.origin.y = data[7];
 
 		if (i == 0) {
 			aabb = t.xform(mesh_aabb);
@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
+#include "core/templates/parallel.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
 
@@ -732,40 +733,37 @@ void RendererSceneCull::instance_set_base(RID p_instance, RID p_base) {
 	_instance_queue_update(instance, true, true);
 }
 
-void RendererSceneCull::instance_set_scenario(RID p_instance, RID p_scenario) {
-	Instance *instance = instance_owner.get_or_null(p_instance);
-	ERR_FAIL_COND(!instance);
-
-	if (instance->scenario) {
-		instance->scenario->instances.remove(&instance->scenario_item);
+void RendererSceneCull::_instance_set_scenario(Instance *p_instance, Scenario *p_scenario) {
+	if (p_instance->scenario) {
+		p_instance->scenario->instances.remove(&p_instance->scenario_item);
 
-		if (instance->indexer_id.is_valid()) {
-			_unpair_instance(instance);
+		if (p_instance->indexer_id.is_valid()) {
+			_unpair_instance(p_instance);
 		}
 
-		switch (instance->base_type) {
+		switch (p_instance->base_type) {
 			case RS::INSTANCE_LIGHT: {
-				InstanceLightData *light = static_cast<InstanceLightData *>(instance->base_data);
+				InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 #ifdef DEBUG_ENABLED
 				if (light->geometries.size()) {
 					ERR_PRINT("BUG, indexing did not unpair geometries from light.");
 				}
 #endif
 				if (light->D) {
-					instance->scenario->directional_lights.erase(light->D);
+					p_instance->scenario->directional_lights.erase(light->D);
 					light->D = nullptr;
 				}
 			} break;
 			case RS::INSTANCE_REFLECTION_PROBE: {
-				InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(instance->base_data);
+				InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(p_instance->base_data);
 				scene_render->reflection_probe_release_atlas_index(reflection_probe->instance);
 
 			} break;
 			case RS::INSTANCE_PARTICLES_COLLISION: {
-				heightfield_particle_colliders_update_list.erase(instance);
+				heightfield_particle_colliders_update_list.erase(p_instance);
 			} break;
 			case RS::INSTANCE_VOXEL_GI: {
-				InstanceVoxelGIData *voxel_gi = static_cast<InstanceVoxelGIData *>(instance->base_data);
+				InstanceVoxelGIData *voxel_gi = static_cast<InstanceVoxelGIData *>(p_instance->base_data);
 
 #ifdef DEBUG_ENABLED
 				if (voxel_gi->geometries.size()) {
@@ -783,47 +781,73 @@ void RendererSceneCull::instance_set_scenario(RID p_instance, RID p_scenario) {
 				}
 			} break;
 			case RS::INSTANCE_OCCLUDER: {
-				if (instance->visible) {
-					RendererSceneOcclusionCull::get_singleton()->scenario_remove_instance(instance->scenario->self, p_instance);
+				if (p_instance->visible) {
+					RendererSceneOcclusionCull::get_singleton()->scenario_remove_instance(p_instance->scenario->self, p_instance->self);
 				}
 			} break;
 			default: {
 			}
 		}
 
-		instance->scenario = nullptr;
+		p_instance->scenario = nullptr;
 	}
 
-	if (p_scenario.is_valid()) {
-		Scenario *scenario = scenario_owner.get_or_null(p_scenario);
-		ERR_FAIL_COND(!scenario);
-
-		instance->scenario = scenario;
+	if (p_scenario) {
+		p_instance->scenario = p_scenario;
 
-		scenario->instances.add(&instance->scenario_item);
+		p_scenario->instances.add(&p_instance->scenario_item);
 
-		switch (instance->base_type) {
+		switch (p_instance->base_type) {
 			case RS::INSTANCE_LIGHT: {
-				InstanceLightData *light = static_cast<InstanceLightData *>(instance->base_data);
+				InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
-				if (RSG::light_storage->light_get_type(instance->base) == RS::LIGHT_DIRECTIONAL) {
-					light->D = scenario->directional_lights.push_back(instance);
+				if (RSG::light_storage->light_get_type(p_instance->base) == RS::LIGHT_DIRECTIONAL) {
+					light->D = p_scenario->directional_lights.push_back(p_instance);
 				}
 			} break;
 			case RS::INSTANCE_VOXEL_GI: {
-				InstanceVoxelGIData *voxel_gi = static_cast<InstanceVoxelGIData *>(instance->base_data);
+				InstanceVoxelGIData *voxel_gi = static_cast<InstanceVoxelGIData *>(p_instance->base_data);
 				if (!voxel_gi->update_element.in_list()) {
 					voxel_gi_update_list.add(&voxel_gi->update_element);
 				}
 			} break;
 			case RS::INSTANCE_OCCLUDER: {
-				RendererSceneOcclusionCull::get_singleton()->scenario_set_instance(scenario->self, p_instance, instance->base, instance->transform, instance->visible);
+				RendererSceneOcclusionCull::get_singleton()->scenario_set_instance(p_scenario->self, p_instance->self, p_instance->base, p_instance->transform, p_instance->visible);
 			} break;
 			default: {
 			}
 		}
 
-		_instance_queue_update(instance, true, true);
+		_instance_queue_update(p_instance, true, true);
+	}
+}
+
+void RendererSceneCull::instance_set_scenario(RID p_instance, RID p_scenario) {
+	Instance *instance = instance_owner.get_or_null(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	Scenario *scenario = nullptr;
+	if (p_scenario.is_valid()) {
+		scenario = scenario_owner.get_or_null(p_scenario);
+		ERR_FAIL_COND(!scenario);
+	}
+
+	_instance_set_scenario(instance, scenario);
+}
+
+void RendererSceneCull::instances_set_scenario(const Vector<RID> &p_instances, RID p_scenario) {
+	Scenario *scenario = nullptr;
+	if (p_scenario.is_valid()) {
+		scenario = scenario_owner.get_or_null(p_scenario);
+		ERR_FAIL_COND(!scenario);
+	}
+
+	const RID *instances = p_instances.ptr();
+	for (int i = 0; i < p_instances.size(); i++) {
+		Instance *instance = instance_owner.get_or_null(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		_instance_set_scenario(instance, scenario);
 	}
 }
 
@@ -856,11 +880,8 @@ void RendererSceneCull::instance_geometry_set_transparency(RID p_instance, float
 	}
 }
 
-void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D &p_transform) {
-	Instance *instance = instance_owner.get_or_null(p_instance);
-	ERR_FAIL_COND(!instance);
-
-	if (instance->transform == p_transform) {
+void RendererSceneCull::_instance_set_transform(Instance *p_instance, const Transform3D &p_transform) {
+	if (p_instance->transform == p_transform) {
 		return; //must be checked to avoid worst evil
 	}
 
@@ -877,8 +898,29 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 	}
 
 #endif
-	instance->transform = p_transform;
-	_instance_queue_update(instance, true);
+	p_instance->transform = p_transform;
+	_instance_queue_update(p_instance, true);
+}
+
+void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D &p_transform) {
+	Instance *instance = instance_owner.get_or_null(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	_instance_set_transform(instance, p_transform);
+}
+
+void RendererSceneCull::instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	// Instances are only queued here, their bounds are all updated in the same pass when the scene is next updated.
+	const RID *instances = p_instances.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_instances.size(); i++) {
+		Instance *instance = instance_owner.get_or_null(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		_instance_set_transform(instance, transforms[i]);
+	}
 }
 
 void RendererSceneCull::instance_attach_object_instance_id(RID p_instance, ObjectID p_id) {
@@ -2541,14 +2583,6 @@ void RendererSceneCull::render_camera(const Ref<RenderSceneBuffers> &p_render_bu
 #endif
 }
 
-void RendererSceneCull::_visibility_cull_threaded(uint32_t p_thread, VisibilityCullData *cull_data) {
-	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
-	uint32_t bin_from = p_thread * cull_data->cull_count / total_threads;
-	uint32_t bin_to = (p_thread + 1 == total_threads) ? cull_data->cull_count : ((p_thread + 1) * cull_data->cull_count / total_threads);
-
-	_visibility_cull(*cull_data, cull_data->cull_offset + bin_from, cull_data->cull_offset + bin_to);
-}
-
 void RendererSceneCull::_visibility_cull(const VisibilityCullData &cull_data, uint64_t p_from, uint64_t p_to) {
 	Scenario *scenario = cull_data.scenario;
 	for (unsigned int i = p_from; i < p_to; i++) {
@@ -2944,12 +2978,11 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 				continue;
 			}
 
-			if (visibility_cull_data.cull_count > thread_cull_threshold) {
-				WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_visibility_cull_threaded, &visibility_cull_data, WorkerThreadPool::get_singleton()->get_thread_count(), -1, true, SNAME("VisibilityCullInstances"));
-				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
-			} else {
-				_visibility_cull(visibility_cull_data, visibility_cull_data.cull_offset, visibility_cull_data.cull_offset + visibility_cull_data.cull_count);
-			}
+			// Bins below the threshold are processed in a single chunk, on this thread.
+			Parallel::for_range(visibility_cull_data.cull_offset, visibility_cull_data.cull_offset + visibility_cull_data.cull_count, [&](uint32_t p_from, uint32_t p_to) {
+				_visibility_cull(visibility_cull_data, p_from, p_to);
+			},
+					thread_cull_threshold);
 		}
 	}
 
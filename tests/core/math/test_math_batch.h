@@ -0,0 +1,241 @@
+/*************************************************************************/
+/*  test_math_batch.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MATH_BATCH_H
+#define TEST_MATH_BATCH_H
+
+#include "core/math/math_batch.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMathBatch {
+
+static Vector3 random_vector(RandomPCG &p_rng) {
+	return Vector3(p_rng.random(-10.0, 10.0), p_rng.random(-10.0, 10.0), p_rng.random(-10.0, 10.0));
+}
+
+static Transform3D random_transform(RandomPCG &p_rng) {
+	Basis basis(random_vector(p_rng).normalized(), p_rng.random(-Math_PI, Math_PI));
+	return Transform3D(basis.scaled(Vector3(1.5, 0.5, 2.0)), random_vector(p_rng));
+}
+
+// Sizes that are not a multiple of the SIMD width exercise the scalar tails.
+static const uint32_t test_counts[] = { 0, 1, 3, 4, 7, 33 };
+
+TEST_CASE("[MathBatch] Transform points") {
+	RandomPCG rng(1);
+	const Transform3D transform = random_transform(rng);
+
+	for (uint32_t count : test_counts) {
+		LocalVector<Vector3> points;
+		LocalVector<Vector3> result;
+		points.resize(count);
+		result.resize(count);
+		for (uint32_t i = 0; i < count; i++) {
+			points[i] = random_vector(rng);
+		}
+
+		MathBatch::xform_points(transform, points.ptr(), result.ptr(), count);
+		for (uint32_t i = 0; i < count; i++) {
+			CHECK_MESSAGE(result[i].is_equal_approx(transform.xform(points[i])), "Transformed point should match the scalar result.");
+		}
+
+		MathBatch::xform_points(transform, points.ptr(), points.ptr(), count);
+		for (uint32_t i = 0; i < count; i++) {
+			CHECK_MESSAGE(points[i].is_equal_approx(result[i]), "Transforming points in place should match.");
+		}
+	}
+}
+
+TEST_CASE("[MathBatch] Transform AABBs") {
+	RandomPCG rng(2);
+	const Transform3D transform = random_transform(rng);
+
+	for (uint32_t count : test_counts) {
+		LocalVector<AABB> aabbs;
+		LocalVector<AABB> result;
+		aabbs.resize(count);
+		result.resize(count);
+		for (uint32_t i = 0; i < count; i++) {
+			aabbs[i] = AABB(random_vector(rng), random_vector(rng).abs());
+		}
+
+		MathBatch::xform_aabbs(transform, aabbs.ptr(), result.ptr(), count);
+		for (uint32_t i = 0; i < count; i++) {
+			CHECK_MESSAGE(result[i].is_equal_approx(transform.xform(aabbs[i])), "Transformed AABB should match the scalar result.");
+		}
+
+		MathBatch::xform_aabbs(transform, aabbs.ptr(), aabbs.ptr(), count);
+		for (uint32_t i = 0; i < count; i++) {
+			CHECK_MESSAGE(aabbs[i].is_equal_approx(result[i]), "Transforming AABBs in place should match.");
+		}
+	}
+}
+
+TEST_CASE("[MathBatch] Multiply transforms") {
+	RandomPCG rng(3);
+	const Transform3D parent = random_transform(rng);
+
+	for (uint32_t count : test_counts) {
+		LocalVector<Transform3D> transforms;
+		LocalVector<Transform3D> result;
+		transforms.resize(count);
+		result.resize(count);
+		for (uint32_t i = 0; i < count; i++) {
+			transforms[i] = random_transform(rng);
+		}
+
+		MathBatch::multiply_transforms(parent, transforms.ptr(), result.ptr(), count);
+		for (uint32_t i = 0; i < count; i++) {
+			CHECK_MESSAGE(result[i].is_equal_approx(parent * transforms[i]), "Multiplied transform should match the scalar result.");
+		}
+
+		MathBatch::multiply_transforms(parent, transforms.ptr(), transforms.ptr(), count);
+		for (uint32_t i = 0; i < count; i++) {
+			CHECK_MESSAGE(transforms[i].is_equal_approx(result[i]), "Multiplying transforms in place should match.");
+		}
+	}
+}
+
+TEST_CASE("[MathBatch] Multiply transforms into 3x4 rows and merge AABBs") {
+	struct Instance {
+		Transform3D transform;
+		Color color;
+	};
+
+	RandomPCG rng(4);
+	const Transform3D parent = random_transform(rng);
+	const AABB aabb(Vector3(-1, -2, -3), Vector3(2, 3, 4));
+	const uint32_t stride = 20;
+
+	for (uint32_t count : test_counts) {
+		LocalVector<Instance> instances;
+		LocalVector<float> buffer;
+		instances.resize(count);
+		buffer.resize(count * stride + 1);
+		for (uint32_t i = 0; i < count; i++) {
+			instances[i].transform = random_transform(rng);
+		}
+
+		MathBatch::multiply_transforms_to_3x4(parent, count ? &instances[0].transform : nullptr, sizeof(Instance), buffer.ptr(), stride, count);
+
+		AABB expected;
+		for (uint32_t i = 0; i < count; i++) {
+			const Transform3D t = parent * instances[i].transform;
+			const float *m = buffer.ptr() + i * stride;
+			const Transform3D stored(m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10], m[3], m[7], m[11]);
+			CHECK_MESSAGE(stored.is_equal_approx(t), "Stored 3x4 rows should match the scalar result.");
+
+			if (i == 0) {
+				expected = t.xform(aabb);
+			} else {
+				expected.merge_with(t.xform(aabb));
+			}
+		}
+
+		const AABB merged = MathBatch::xform_aabb_merged_3x4(aabb, buffer.ptr(), stride, count);
+		CHECK_MESSAGE(merged.is_equal_approx(expected), "Merged AABB should match the scalar result.");
+	}
+}
+
+TEST_CASE_BENCHMARK("[MathBatch][Benchmark] Batch operations") {
+	const uint32_t count = 100000;
+	const int iterations = 20;
+	RandomPCG rng(5);
+	const Transform3D transform = random_transform(rng);
+
+	LocalVector<Vector3> points;
+	LocalVector<AABB> aabbs;
+	LocalVector<Transform3D> transforms;
+	points.resize(count);
+	aabbs.resize(count);
+	transforms.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		points[i] = random_vector(rng);
+		aabbs[i] = AABB(random_vector(rng), random_vector(rng).abs());
+		transforms[i] = random_transform(rng);
+	}
+
+	LocalVector<Vector3> points_out;
+	LocalVector<AABB> aabbs_out;
+	LocalVector<Transform3D> transforms_out;
+	points_out.resize(count);
+	aabbs_out.resize(count);
+	transforms_out.resize(count);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int k = 0; k < iterations; k++) {
+		for (uint32_t i = 0; i < count; i++) {
+			points_out[i] = transform.xform(points[i]);
+		}
+	}
+	print_line(vformat("Transform3D::xform(Vector3): %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int k = 0; k < iterations; k++) {
+		MathBatch::xform_points(transform, points.ptr(), points_out.ptr(), count);
+	}
+	print_line(vformat("MathBatch::xform_points: %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int k = 0; k < iterations; k++) {
+		for (uint32_t i = 0; i < count; i++) {
+			aabbs_out[i] = transform.xform(aabbs[i]);
+		}
+	}
+	print_line(vformat("Transform3D::xform(AABB): %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int k = 0; k < iterations; k++) {
+		MathBatch::xform_aabbs(transform, aabbs.ptr(), aabbs_out.ptr(), count);
+	}
+	print_line(vformat("MathBatch::xform_aabbs: %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int k = 0; k < iterations; k++) {
+		for (uint32_t i = 0; i < count; i++) {
+			transforms_out[i] = transform * transforms[i];
+		}
+	}
+	print_line(vformat("Transform3D::operator*: %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int k = 0; k < iterations; k++) {
+		MathBatch::multiply_transforms(transform, transforms.ptr(), transforms_out.ptr(), count);
+	}
+	print_line(vformat("MathBatch::multiply_transforms: %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+}
+
+} // namespace TestMathBatch
+
+#endif // TEST_MATH_BATCH_H
@@ -0,0 +1,157 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+static LocalVector<int> received;
+
+static void record_call(int p_value) {
+	received.push_back(p_value);
+}
+
+static void push_twice(int p_value) {
+	received.push_back(p_value);
+	if (p_value < 10) {
+		MessageQueue::get_singleton()->push_callable(callable_mp_static(push_twice), p_value + 1);
+	}
+}
+
+struct ProducerData {
+	int thread_index = 0;
+	int count = 0;
+};
+
+static void producer_thread(void *p_userdata) {
+	ProducerData *data = (ProducerData *)p_userdata;
+	for (int i = 0; i < data->count; i++) {
+		MessageQueue::get_singleton()->push_callable(callable_mp_static(record_call), data->thread_index * data->count + i);
+	}
+}
+
+// Creates a message queue for tests that don't run with a SceneTree.
+class ScopedMessageQueue {
+	MessageQueue *queue = nullptr;
+
+public:
+	ScopedMessageQueue() {
+		if (!MessageQueue::get_singleton()) {
+			queue = memnew(MessageQueue);
+		}
+		received.clear();
+	}
+
+	~ScopedMessageQueue() {
+		if (queue) {
+			memdelete(queue);
+		}
+		received.clear();
+	}
+};
+
+TEST_CASE("[MessageQueue] Deferred calls are processed in order and don't run out of space") {
+	ScopedMessageQueue scoped;
+
+	// Large enough to span many pages.
+	const int count = 100000;
+	for (int i = 0; i < count; i++) {
+		CHECK_EQ(MessageQueue::get_singleton()->push_callable(callable_mp_static(record_call), i), OK);
+	}
+	MessageQueue::get_singleton()->flush();
+
+	REQUIRE(received.size() == (uint32_t)count);
+	bool in_order = true;
+	for (int i = 0; i < count; i++) {
+		if (received[i] != i) {
+			in_order = false;
+			break;
+		}
+	}
+	CHECK_MESSAGE(in_order, "Deferred calls should be processed in the order they were pushed.");
+	CHECK(MessageQueue::get_singleton()->get_max_buffer_usage() > 0);
+}
+
+TEST_CASE("[MessageQueue] Calls deferred while flushing are processed in the same flush") {
+	ScopedMessageQueue scoped;
+
+	MessageQueue::get_singleton()->push_callable(callable_mp_static(push_twice), 0);
+	MessageQueue::get_singleton()->flush();
+
+	REQUIRE(received.size() == 11);
+	for (int i = 0; i <= 10; i++) {
+		CHECK(received[i] == i);
+	}
+}
+
+TEST_CASE("[MessageQueue] Calls deferred from several threads keep per-thread order") {
+	ScopedMessageQueue scoped;
+
+	const int thread_count = 4;
+	const int count = 10000;
+	Thread threads[thread_count];
+	ProducerData data[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		data[i].thread_index = i;
+		data[i].count = count;
+		threads[i].start(producer_thread, &data[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+	MessageQueue::get_singleton()->flush();
+
+	REQUIRE(received.size() == (uint32_t)(thread_count * count));
+	int last_seen[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		last_seen[i] = -1;
+	}
+	bool in_order = true;
+	for (uint32_t i = 0; i < received.size(); i++) {
+		int thread_index = received[i] / count;
+		int value = received[i] % count;
+		if (value != last_seen[thread_index] + 1) {
+			in_order = false;
+		}
+		last_seen[thread_index] = value;
+	}
+	CHECK_MESSAGE(in_order, "Deferred calls from a given thread should be processed in the order they were pushed.");
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -35,6 +35,8 @@
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 
 #include "tests/test_macros.h"
 
@@ -281,6 +283,178 @@ TEST_CASE("[Object] Absent name getter") {
 			actual_value == Variant(),
 			"The returned value should equal nil variant.");
 }
+
+TEST_CASE("[Object] Cached method and property lookups") {
+	GDREGISTER_CLASS(_TestDerivedObject);
+	_TestDerivedObject derived_object;
+	Object object;
+
+	SUBCASE("Properties") {
+		ObjectLookupCache cache;
+		bool valid = false;
+		for (int i = 0; i < 3; i++) {
+			derived_object.set("property", i, &valid, &cache);
+			CHECK(valid);
+			CHECK(derived_object.get("property", &valid, &cache) == Variant(i));
+			CHECK(valid);
+		}
+
+		// Same call site used with an object of another class.
+		object.set("property", 5, &valid, &cache);
+		CHECK_FALSE(valid);
+		derived_object.set("property", 6, &valid, &cache);
+		CHECK(valid);
+		CHECK(derived_object.get_property() == 6);
+	}
+
+	SUBCASE("Methods") {
+		ObjectLookupCache cache;
+		Variant value = 42;
+		const Variant *args[1] = { &value };
+		Callable::CallError ce;
+		for (int i = 0; i < 3; i++) {
+			derived_object.callp_cached(cache, "set_property", args, 1, ce);
+			CHECK(ce.error == Callable::CallError::CALL_OK);
+			CHECK(derived_object.callp_cached(cache, "get_property", nullptr, 0, ce) == Variant(42));
+			CHECK(ce.error == Callable::CallError::CALL_OK);
+		}
+
+		object.callp_cached(cache, "set_property", args, 1, ce);
+		CHECK(ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+	}
+
+	SUBCASE("Invalidated when ClassDB changes") {
+		ObjectLookupCache cache;
+		Callable::CallError ce;
+		CHECK(derived_object.callp_cached(cache, "get_class", nullptr, 0, ce) == Variant("_TestDerivedObject"));
+		uint32_t version = ClassDB::get_lookup_version();
+		ClassDB::add_property(_TestDerivedObject::get_class_static(), PropertyInfo(Variant::INT, "property_copy"), "set_property", "get_property");
+		CHECK(ClassDB::get_lookup_version() != version);
+		CHECK(derived_object.callp_cached(cache, "get_class", nullptr, 0, ce) == Variant("_TestDerivedObject"));
+	}
+}
+
+TEST_CASE("[Object] Signal emission to native methods") {
+	GDREGISTER_CLASS(_TestDerivedObject);
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("changed", PropertyInfo(Variant::INT, "value")));
+	_TestDerivedObject derived_object;
+	derived_object.set_property(0);
+	emitter.connect("changed", Callable(&derived_object, "set_property"));
+
+	SUBCASE("Argument of the expected type") {
+		emitter.emit_signal("changed", 42);
+		CHECK_MESSAGE(
+				derived_object.get_property() == 42,
+				"The connected method should have been called with the emitted value.");
+	}
+
+	SUBCASE("Argument requiring conversion") {
+		emitter.emit_signal("changed", 7.0);
+		CHECK_MESSAGE(
+				derived_object.get_property() == 7,
+				"The emitted value should have been converted to the argument type of the method.");
+	}
+
+	SUBCASE("Bound arguments") {
+		emitter.disconnect("changed", Callable(&derived_object, "set_property"));
+		emitter.add_user_signal(MethodInfo("pinged"));
+		emitter.connect("pinged", Callable(&derived_object, "set_property").bind(13));
+		emitter.emit_signal("pinged");
+		CHECK(derived_object.get_property() == 13);
+	}
+}
+
+TEST_CASE_BENCHMARK("[Object][Benchmark] Signal emission to native methods") {
+	GDREGISTER_CLASS(_TestDerivedObject);
+	const int emit_count = 1000000;
+
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("changed", PropertyInfo(Variant::INT, "value")));
+	_TestDerivedObject derived_object;
+	emitter.connect("changed", Callable(&derived_object, "set_property"));
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < emit_count; i++) {
+		emitter.emit_signal("changed", i);
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(derived_object.get_property() == emit_count - 1);
+
+	print_line(vformat("Emitted %d signals in %d usec (%.1f nsec per emission).", emit_count, elapsed, elapsed * 1000.0 / emit_count));
+}
+
+TEST_CASE("[Object] ObjectDB slot reuse") {
+	Object *object = memnew(Object);
+	ObjectID old_id = object->get_instance_id();
+	CHECK(ObjectDB::get_instance(old_id) == object);
+
+	int object_count = ObjectDB::get_object_count();
+	uint64_t reuse_count = ObjectDB::get_slot_reuse_count();
+	memdelete(object);
+	CHECK(ObjectDB::get_object_count() == object_count - 1);
+	CHECK(ObjectDB::get_instance(old_id) == nullptr);
+
+	// The slot freed last by this thread is used for the next object, with a new validator.
+	object = memnew(Object);
+	ObjectID new_id = object->get_instance_id();
+	CHECK((uint64_t(new_id) & OBJECTDB_SLOT_MAX_COUNT_MASK) == (uint64_t(old_id) & OBJECTDB_SLOT_MAX_COUNT_MASK));
+	CHECK(new_id != old_id);
+	CHECK(ObjectDB::get_slot_reuse_count() == reuse_count + 1);
+	CHECK(ObjectDB::get_instance(old_id) == nullptr);
+	CHECK(ObjectDB::get_instance(new_id) == object);
+	memdelete(object);
+}
+
+static void _create_and_free_objects(void *p_userdata) {
+	const ObjectID *shared_id = (const ObjectID *)p_userdata;
+	for (int i = 0; i < 10000; i++) {
+		Object *object = memnew(Object);
+		if (ObjectDB::get_instance(object->get_instance_id()) != object) {
+			ERR_PRINT("Object lookup failed.");
+		}
+		ObjectDB::get_instance(*shared_id);
+		memdelete(object);
+	}
+}
+
+TEST_CASE("[Object] ObjectDB from several threads") {
+	Object shared;
+	ObjectID shared_id = shared.get_instance_id();
+	int object_count = ObjectDB::get_object_count();
+	uint32_t slot_count = ObjectDB::get_slot_count();
+
+	const int thread_count = 4;
+	Thread threads[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].start(_create_and_free_objects, &shared_id);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	CHECK(ObjectDB::get_object_count() == object_count);
+	CHECK(ObjectDB::get_instance(shared_id) == &shared);
+	// Each thread only takes the slots it needs from the shared free list.
+	CHECK(ObjectDB::get_slot_count() <= slot_count + thread_count * OBJECTDB_THREAD_CACHE_SIZE);
+}
+
+TEST_CASE_BENCHMARK("[Object][Benchmark] ObjectDB lookups") {
+	const int lookup_count = 10000000;
+
+	Object object;
+	ObjectID id = object.get_instance_id();
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int found = 0;
+	for (int i = 0; i < lookup_count; i++) {
+		found += ObjectDB::get_instance(id) != nullptr;
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(found == lookup_count);
+
+	print_line(vformat("Looked up %d object IDs in %d usec (%.1f nsec per lookup).", lookup_count, elapsed, elapsed * 1000.0 / lookup_count));
+}
 } // namespace TestObject
 
 #endif // TEST_OBJECT_H
@@ -0,0 +1,117 @@
+/*************************************************************************/
+/*  test_frame_arena.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FRAME_ARENA_H
+#define TEST_FRAME_ARENA_H
+
+#include "core/os/frame_arena.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameArena {
+
+static void free_from_thread(void *p_ptr) {
+	ERR_PRINT_OFF;
+	FrameArena::free(p_ptr); // Rejected, the thread's own arena is untouched.
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[FrameArena] Containers") {
+	FrameArena::end_frame();
+
+	FrameLocalVector<int> vector;
+	for (int i = 0; i < 1000; i++) {
+		vector.push_back(i);
+	}
+	FrameHashMap<int, String> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(i, itos(i));
+	}
+
+	CHECK(vector.size() == 1000);
+	CHECK(vector[999] == 999);
+	CHECK(map.size() == 100);
+	CHECK(map[42] == "42");
+
+	map.erase(42);
+	CHECK_FALSE(map.has(42));
+}
+
+TEST_CASE("[FrameArena] Reset at the end of the frame") {
+	FrameArena::end_frame();
+
+	void *first = FrameArena::alloc(100);
+	void *second = FrameArena::alloc(100);
+	CHECK(((uintptr_t)first & 15) == 0);
+	CHECK(((uintptr_t)second & 15) == 0);
+	CHECK(second > first);
+
+	SUBCASE("Growing the last allocation is done in place") {
+		CHECK(FrameArena::realloc(second, 1000) == second);
+		FrameArena::free(second);
+		FrameArena::free(first);
+
+		// The memory is reused once the frame ends.
+		FrameArena::end_frame();
+		void *next_frame = FrameArena::alloc(100);
+		CHECK(next_frame == first);
+		FrameArena::free(next_frame);
+	}
+
+	SUBCASE("Memory leaked past its frame doesn't block the reset") {
+		FrameArena::free(second);
+		ERR_PRINT_OFF;
+		FrameArena::end_frame(); // The first allocation is reported and reclaimed anyway.
+		ERR_PRINT_ON;
+		void *next_frame = FrameArena::alloc(100);
+		CHECK(next_frame == first);
+		FrameArena::free(next_frame);
+	}
+
+	SUBCASE("Memory is only freed by the thread that allocated it") {
+		Thread thread;
+		thread.start(free_from_thread, second);
+		thread.wait_to_finish();
+
+		// Still allocated here, and freed normally.
+		CHECK(FrameArena::realloc(second, 1000) == second);
+		FrameArena::free(second);
+		FrameArena::free(first);
+		FrameArena::end_frame();
+		void *next_frame = FrameArena::alloc(100);
+		CHECK(next_frame == first);
+		FrameArena::free(next_frame);
+	}
+}
+
+} // namespace TestFrameArena
+
+#endif // TEST_FRAME_ARENA_H
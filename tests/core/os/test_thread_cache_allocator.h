@@ -0,0 +1,163 @@
+/*************************************************************************/
+/*  test_thread_cache_allocator.h                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_THREAD_CACHE_ALLOCATOR_H
+#define TEST_THREAD_CACHE_ALLOCATOR_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/os/thread_cache_allocator.h"
+
+#include "tests/test_macros.h"
+
+#include <stdlib.h>
+
+namespace TestThreadCacheAllocator {
+
+TEST_CASE("[ThreadCacheAllocator] Allocating and freeing") {
+	SUBCASE("Blocks are reused after being freed") {
+		void *block = ThreadCacheAllocator::alloc(40);
+		REQUIRE(block != nullptr);
+		CHECK(((uintptr_t)block & 15) == 0);
+		ThreadCacheAllocator::free(block, 40);
+		// Sizes in the same class share blocks.
+		CHECK(ThreadCacheAllocator::alloc(48) == block);
+		ThreadCacheAllocator::free(block, 48);
+	}
+
+	SUBCASE("Reallocating keeps the contents") {
+		uint8_t *block = (uint8_t *)ThreadCacheAllocator::alloc(20);
+		for (int i = 0; i < 20; i++) {
+			block[i] = i;
+		}
+		CHECK(ThreadCacheAllocator::realloc(block, 20, 30) == block);
+
+		block = (uint8_t *)ThreadCacheAllocator::realloc(block, 30, 600);
+		for (int i = 0; i < 20; i++) {
+			CHECK(block[i] == i);
+		}
+		block = (uint8_t *)ThreadCacheAllocator::realloc(block, 600, 4000);
+		for (int i = 0; i < 20; i++) {
+			CHECK(block[i] == i);
+		}
+		ThreadCacheAllocator::free(block, 4000);
+	}
+
+	SUBCASE("Blocks of all sizes don't overlap") {
+		const int count = 1000;
+		uint8_t *blocks[count];
+		for (int i = 0; i < count; i++) {
+			int size = 1 + i % ThreadCacheAllocator::MAX_SMALL_SIZE;
+			blocks[i] = (uint8_t *)ThreadCacheAllocator::alloc(size);
+			memset(blocks[i], i & 0xFF, size);
+		}
+		bool intact = true;
+		for (int i = 0; i < count; i++) {
+			int size = 1 + i % ThreadCacheAllocator::MAX_SMALL_SIZE;
+			intact = intact && blocks[i][0] == (i & 0xFF) && blocks[i][size - 1] == (i & 0xFF);
+			ThreadCacheAllocator::free(blocks[i], size);
+		}
+		CHECK(intact);
+	}
+}
+
+// Allocation pattern similar to the engine's: mostly small blocks of mixed sizes (list elements, strings, arrays),
+// kept alive for a while and freed in a different order than they were allocated.
+struct AllocationWorkload {
+	bool use_malloc = false;
+	int iterations = 0;
+	int live_count = 0;
+};
+
+static void _run_workload(void *p_userdata) {
+	const AllocationWorkload *workload = (const AllocationWorkload *)p_userdata;
+	RandomPCG rng(Thread::get_caller_id());
+
+	void **blocks = (void **)calloc(workload->live_count, sizeof(void *));
+	uint32_t *sizes = (uint32_t *)calloc(workload->live_count, sizeof(uint32_t));
+	for (int i = 0; i < workload->iterations; i++) {
+		int index = rng.rand() % workload->live_count;
+		if (blocks[index]) {
+			if (workload->use_malloc) {
+				free(blocks[index]);
+			} else {
+				ThreadCacheAllocator::free(blocks[index], sizes[index]);
+			}
+		}
+		// Mostly small sizes, with an occasional large one.
+		uint32_t size = (rng.rand() % 8) ? 16 + rng.rand() % 112 : 128 + rng.rand() % 2048;
+		blocks[index] = workload->use_malloc ? malloc(size) : ThreadCacheAllocator::alloc(size);
+		sizes[index] = size;
+		*(uint8_t *)blocks[index] = 1;
+	}
+	for (int i = 0; i < workload->live_count; i++) {
+		if (blocks[i]) {
+			if (workload->use_malloc) {
+				free(blocks[i]);
+			} else {
+				ThreadCacheAllocator::free(blocks[i], sizes[i]);
+			}
+		}
+	}
+	free(blocks);
+	free(sizes);
+}
+
+TEST_CASE_BENCHMARK("[ThreadCacheAllocator][Benchmark] Compared to malloc") {
+	AllocationWorkload workload;
+	workload.iterations = 2000000;
+	workload.live_count = 4096;
+
+	for (int thread_count = 1; thread_count <= OS::get_singleton()->get_processor_count(); thread_count *= 2) {
+		for (int pass = 0; pass < 2; pass++) {
+			workload.use_malloc = pass == 0;
+
+			Vector<Thread *> threads;
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < thread_count; i++) {
+				Thread *thread = memnew(Thread);
+				thread->start(_run_workload, &workload);
+				threads.push_back(thread);
+			}
+			for (int i = 0; i < thread_count; i++) {
+				threads[i]->wait_to_finish();
+				memdelete(threads[i]);
+			}
+			uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+			print_line(vformat("%s, %d threads: %d allocations each in %d usec (%.1f nsec per allocation).", workload.use_malloc ? "malloc" : "ThreadCacheAllocator", thread_count, workload.iterations, elapsed, elapsed * 1000.0 / workload.iterations));
+		}
+	}
+}
+
+} // namespace TestThreadCacheAllocator
+
+#endif // TEST_THREAD_CACHE_ALLOCATOR_H
@@ -31,6 +31,7 @@
 #ifndef TEST_STRING_H
 #define TEST_STRING_H
 
+#include "core/os/os.h"
 #include "core/string/ustring.h"
 
 #include "tests/test_macros.h"
@@ -1740,6 +1741,63 @@ TEST_CASE("[Stress][String] Empty via `is_empty()`") {
 		}
 	}
 }
+
+TEST_CASE("[String] Concatenating shared strings") {
+	String base = "Hello";
+	String copy = base;
+
+	String sum = copy + " World";
+	CHECK(sum == "Hello World");
+	CHECK(base == "Hello");
+
+	copy += "!";
+	CHECK(copy == "Hello!");
+	CHECK(base == "Hello");
+	CHECK(base.ptr() != copy.ptr());
+
+	copy = base;
+	copy.resize(3);
+	copy[2] = 0;
+	CHECK(copy == "He");
+	CHECK(base == "Hello");
+}
+
+TEST_CASE_BENCHMARK("[String][Benchmark] Building strings") {
+	const int count = 1000000;
+
+	String prefix = "node_";
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int length = 0;
+	for (int i = 0; i < count; i++) {
+		String name = prefix + "child";
+		name += "/";
+		length += name.length();
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(length == count * 11);
+	print_line(vformat("Built %d short strings in %d usec (%.1f nsec per string).", count, elapsed, elapsed * 1000.0 / count));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	String text;
+	for (int i = 0; i < count; i++) {
+		text += "line of dialogue\n";
+	}
+	elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("Appended %d times in %d usec (%.1f nsec per append).", count, elapsed, elapsed * 1000.0 / count));
+
+#ifdef DEBUG_ENABLED
+	// Memory usage is only tracked in debug builds.
+	const int string_count = 10000;
+	Vector<String> strings;
+	strings.resize(string_count);
+	uint64_t usage = Memory::get_mem_usage();
+	for (int i = 0; i < string_count; i++) {
+		strings.write[i] = prefix + itos(i);
+	}
+	uint64_t used = Memory::get_mem_usage() - usage;
+	print_line(vformat("%d short strings use %d bytes (%.1f bytes per string).", string_count, used, double(used) / string_count));
+#endif
+}
 } // namespace TestString
 
 #endif // TEST_STRING_H
@@ -0,0 +1,142 @@
+/*************************************************************************/
+/*  test_string_name.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	StringName from_cstring = "test_string_name_interning";
+	StringName from_string = String("test_string_name_interning");
+	StringName from_static = SNAME("test_string_name_interning");
+
+	CHECK(from_cstring == from_string);
+	CHECK(from_cstring == from_static);
+	CHECK(from_cstring.data_unique_pointer() == from_string.data_unique_pointer());
+	CHECK(StringName::search("test_string_name_interning") == from_cstring);
+	CHECK(StringName::search(String("test_string_name_interning")) == from_cstring);
+	CHECK(StringName::search(U"test_string_name_interning") == from_cstring);
+	CHECK(StringName::search("test_string_name_missing") == StringName());
+}
+
+TEST_CASE("[StringName] Freed once unreferenced") {
+	{
+		StringName name = "test_string_name_unreferenced";
+		CHECK(StringName::search("test_string_name_unreferenced") == name);
+	}
+	CHECK(StringName::search("test_string_name_unreferenced") == StringName());
+
+	// Adding it again creates a new valid name.
+	StringName name = String("test_string_name_unreferenced");
+	CHECK(name == "test_string_name_unreferenced");
+	CHECK(StringName::search("test_string_name_unreferenced") == name);
+}
+
+static void _intern_names(void *p_userdata) {
+	const StringName *shared = (const StringName *)p_userdata;
+	for (int i = 0; i < 20000; i++) {
+		// Names shared by all the threads, created and freed concurrently.
+		StringName name = vformat("test_string_name_thread_%d", i % 64);
+		StringName copy = String(name);
+		if (name != copy) {
+			ERR_PRINT("StringName interning mismatch.");
+		}
+		StringName existing = String(*shared);
+		if (existing != *shared) {
+			ERR_PRINT("StringName lookup mismatch.");
+		}
+	}
+}
+
+TEST_CASE("[StringName] Interning from several threads") {
+	StringName shared = "test_string_name_thread_shared";
+
+	const int thread_count = 4;
+	Thread threads[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].start(_intern_names, &shared);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	CHECK(StringName::search("test_string_name_thread_shared") == shared);
+	CHECK(StringName::search("test_string_name_thread_0") == StringName());
+}
+
+struct StringNameBenchmark {
+	Vector<String> names;
+	int iterations = 0;
+};
+
+static void _lookup_names(void *p_userdata) {
+	const StringNameBenchmark *benchmark = (const StringNameBenchmark *)p_userdata;
+	for (int i = 0; i < benchmark->iterations; i++) {
+		StringName name = benchmark->names[i % benchmark->names.size()];
+	}
+}
+
+TEST_CASE_BENCHMARK("[StringName][Benchmark] Interning existing names from several threads") {
+	StringNameBenchmark benchmark;
+	benchmark.iterations = 1000000;
+	Vector<StringName> keep_alive;
+	for (int i = 0; i < 1024; i++) {
+		benchmark.names.push_back(vformat("benchmark_string_name_%d", i));
+		keep_alive.push_back(benchmark.names[i]);
+	}
+
+	for (int thread_count = 1; thread_count <= OS::get_singleton()->get_processor_count(); thread_count *= 2) {
+		Vector<Thread *> threads;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			Thread *thread = memnew(Thread);
+			thread->start(_lookup_names, &benchmark);
+			threads.push_back(thread);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i]->wait_to_finish();
+			memdelete(threads[i]);
+		}
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_line(vformat("%d threads interned %d names each in %d usec (%.1f nsec per name).", thread_count, benchmark.iterations, elapsed, elapsed * 1000.0 / benchmark.iterations));
+	}
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -424,6 +424,48 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+
+class CommandQueueBenchmark {
+public:
+	CommandQueueMT command_queue = CommandQueueMT(true);
+	SafeFlag exit;
+	uint64_t sum = 0;
+
+	void add(uint32_t p_value) {
+		sum += p_value;
+	}
+
+	static void reader_thread_loop(void *p_benchmark) {
+		CommandQueueBenchmark *benchmark = static_cast<CommandQueueBenchmark *>(p_benchmark);
+		while (!benchmark->exit.is_set()) {
+			benchmark->command_queue.wait_and_flush();
+		}
+		benchmark->command_queue.flush_all();
+	}
+};
+
+TEST_CASE_BENCHMARK("[CommandQueue][Benchmark] Commands per second") {
+	const uint32_t command_count = 10000000;
+	CommandQueueBenchmark benchmark;
+	Thread reader_thread;
+	reader_thread.start(&CommandQueueBenchmark::reader_thread_loop, &benchmark);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < command_count; i++) {
+		benchmark.command_queue.push(&benchmark, &CommandQueueBenchmark::add, i);
+	}
+	uint64_t push_time = OS::get_singleton()->get_ticks_usec() - begin;
+	benchmark.command_queue.push_and_sync(&benchmark, &CommandQueueBenchmark::add, 0u);
+	uint64_t total_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	benchmark.exit.set();
+	benchmark.command_queue.push(&benchmark, &CommandQueueBenchmark::add, 0u);
+	reader_thread.wait_to_finish();
+
+	CHECK(benchmark.sum == uint64_t(command_count) * (command_count - 1) / 2);
+	print_line(vformat("Pushed %d commands in %d usec (%.1f million per second), executed in %d usec (%.1f million per second).", command_count, push_time, command_count / double(push_time), total_time, command_count / double(total_time)));
+}
+
 } // namespace TestCommandQueue
 
 #endif // !defined(NO_THREADS)
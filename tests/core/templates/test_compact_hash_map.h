@@ -0,0 +1,188 @@
+/*************************************************************************/
+/*  test_compact_hash_map.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_COMPACT_HASH_MAP_H
+#define TEST_COMPACT_HASH_MAP_H
+
+#include "core/os/os.h"
+#include "core/templates/compact_hash_map.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCompactHashMap {
+
+TEST_CASE("[CompactHashMap] Insert, overwrite and erase") {
+	CompactHashMap<int, int> map;
+	CompactHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+
+	map.insert(42, 1234);
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+
+	map.remove(map.find(42));
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+	CHECK(map.is_empty());
+	CHECK_FALSE(map.erase(42));
+}
+
+TEST_CASE("[CompactHashMap] Keeps insertion order across erasures") {
+	CompactHashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i * 2);
+	}
+	// Enough erasures to trigger compaction.
+	for (int i = 0; i < 1000; i++) {
+		if (i % 3 != 0) {
+			CHECK(map.erase(i));
+		}
+	}
+	map.insert(1, 2);
+
+	int expected = 0;
+	for (const KeyValue<int, int> &E : map) {
+		if (expected == 1002) {
+			CHECK(E.key == 1);
+			break;
+		}
+		CHECK(E.key == expected);
+		CHECK(E.value == expected * 2);
+		expected += 3;
+	}
+	CHECK(map.size() == 335);
+	CHECK(map.get_by_index(1)->key == 3);
+	CHECK(map.get_by_index(334)->key == 1);
+}
+
+TEST_CASE("[CompactHashMap] Element pointers survive inserts") {
+	CompactHashMap<int, int> map;
+	map[0] = 1;
+	int *value = map.getptr(0);
+	for (int i = 1; i < 10000; i++) {
+		map[i] = i;
+	}
+	CHECK(value == map.getptr(0));
+	CHECK(*value == 1);
+}
+
+TEST_CASE("[CompactHashMap] Copy") {
+	CompactHashMap<String, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(itos(i), i);
+	}
+	map.erase("50");
+
+	CompactHashMap<String, int> copy = map;
+	CHECK(copy.size() == 99);
+	CompactHashMap<String, int>::ConstIterator a = map.begin();
+	CompactHashMap<String, int>::ConstIterator b = copy.begin();
+	for (; a && b; ++a, ++b) {
+		CHECK(a->key == b->key);
+		CHECK(a->value == b->value);
+	}
+	CHECK(!a);
+	CHECK(!b);
+	CHECK(copy["99"] == 99);
+}
+
+// Adds the time spent inserting, looking up, iterating and duplicating to r_usec.
+template <class TMap>
+static void _benchmark_map(const Vector<Variant> &p_keys, uint64_t *r_usec) {
+	const int count = p_keys.size();
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	TMap map;
+	for (int i = 0; i < count; i++) {
+		map[p_keys[i]] = i;
+	}
+	uint64_t end = OS::get_singleton()->get_ticks_usec();
+	r_usec[0] += end - begin;
+
+	begin = end;
+	int64_t sum = 0;
+	for (int i = 0; i < count; i++) {
+		sum += int64_t(map[p_keys[(i * 7919) % count]]);
+	}
+	end = OS::get_singleton()->get_ticks_usec();
+	r_usec[1] += end - begin;
+
+	begin = end;
+	for (const KeyValue<Variant, Variant> &E : map) {
+		sum += int64_t(E.value);
+	}
+	end = OS::get_singleton()->get_ticks_usec();
+	r_usec[2] += end - begin;
+
+	begin = end;
+	TMap copy = map;
+	end = OS::get_singleton()->get_ticks_usec();
+	r_usec[3] += end - begin;
+
+	CHECK(copy.size() == map.size());
+	CHECK(sum >= 0);
+}
+
+template <class TMap>
+static void _print_benchmark(const char *p_name, const Vector<Variant> &p_keys, int p_repeat) {
+	uint64_t usec[4] = {};
+	for (int i = 0; i < p_repeat; i++) {
+		_benchmark_map<TMap>(p_keys, usec);
+	}
+	print_line(vformat("%s, %d keys x%d: insert %d usec, lookup %d usec, iterate %d usec, duplicate %d usec.", p_name, p_keys.size(), p_repeat, usec[0], usec[1], usec[2], usec[3]));
+}
+
+TEST_CASE_BENCHMARK("[CompactHashMap][Benchmark] Compared to HashMap") {
+	typedef HashMap<Variant, Variant, VariantHasher, VariantComparator> VariantHashMap;
+	typedef CompactHashMap<Variant, Variant, VariantHasher, VariantComparator> VariantCompactHashMap;
+
+	for (int count = 16; count <= 1000000; count *= 250) {
+		Vector<Variant> int_keys;
+		Vector<Variant> string_keys;
+		for (int i = 0; i < count; i++) {
+			int_keys.push_back(i * 31);
+			string_keys.push_back(vformat("key_%d", i));
+		}
+		// Small maps are repeated so their time can be measured.
+		const int repeat = MAX(1, 1000000 / count);
+		_print_benchmark<VariantHashMap>("HashMap, int keys", int_keys, repeat);
+		_print_benchmark<VariantCompactHashMap>("CompactHashMap, int keys", int_keys, repeat);
+		_print_benchmark<VariantHashMap>("HashMap, String keys", string_keys, repeat);
+		_print_benchmark<VariantCompactHashMap>("CompactHashMap, String keys", string_keys, repeat);
+	}
+}
+
+} // namespace TestCompactHashMap
+
+#endif // TEST_COMPACT_HASH_MAP_H
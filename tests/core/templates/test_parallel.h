@@ -0,0 +1,224 @@
+/*************************************************************************/
+/*  test_parallel.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PARALLEL_H
+#define TEST_PARALLEL_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/parallel.h"
+
+#include "tests/test_macros.h"
+
+namespace TestParallel {
+
+// Big enough to be split in several chunks.
+static const uint32_t ELEMENT_COUNT = 100003;
+
+static bool equal(const LocalVector<int> &p_a, const LocalVector<int> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static LocalVector<int> random_ints(uint32_t p_count, int p_range) {
+	RandomPCG rng(42);
+	LocalVector<int> values;
+	values.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		values[i] = int(rng.rand(p_range)) - p_range / 2;
+	}
+	return values;
+}
+
+TEST_CASE("[Parallel] for_range covers every element once") {
+	LocalVector<uint32_t> hits;
+	hits.resize(ELEMENT_COUNT);
+	for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+		hits[i] = 0;
+	}
+
+	Parallel::for_range(0, ELEMENT_COUNT, [&](uint32_t p_from, uint32_t p_to) {
+		for (uint32_t i = p_from; i < p_to; i++) {
+			hits[i]++;
+		}
+	});
+
+	bool all_once = true;
+	for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+		all_once = all_once && hits[i] == 1;
+	}
+	CHECK(all_once);
+}
+
+TEST_CASE("[Parallel] Sort") {
+	LocalVector<int> values = random_ints(ELEMENT_COUNT, 1000000);
+	LocalVector<int> expected = values;
+	SortArray<int> sorter;
+	sorter.sort(expected.ptr(), expected.size());
+
+	Parallel::sort(values.ptr(), values.size());
+	CHECK(equal(values, expected));
+
+	// Also small arrays, sorted on the calling thread.
+	int small[5] = { 3, -1, 2, 5, 0 };
+	Parallel::sort(small, 5);
+	CHECK(small[0] == -1);
+	CHECK(small[4] == 5);
+}
+
+struct KeyOrder {
+	uint32_t key;
+	uint32_t order;
+};
+
+struct KeyOrderRadixKey {
+	_FORCE_INLINE_ uint32_t operator()(const KeyOrder &p_value) const { return p_value.key; }
+};
+
+TEST_CASE("[Parallel] Radix sort is stable") {
+	RandomPCG rng(7);
+	LocalVector<KeyOrder> values;
+	values.resize(ELEMENT_COUNT);
+	for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+		values[i].key = rng.rand(1000) * 65537; // Few distinct keys, spread over several digits.
+		values[i].order = i;
+	}
+
+	Parallel::radix_sort(values.ptr(), values.size(), KeyOrderRadixKey());
+
+	bool sorted = true;
+	for (uint32_t i = 1; i < ELEMENT_COUNT; i++) {
+		const KeyOrder &a = values[i - 1];
+		const KeyOrder &b = values[i];
+		sorted = sorted && (a.key < b.key || (a.key == b.key && a.order < b.order));
+	}
+	CHECK(sorted);
+
+	LocalVector<uint64_t> keys;
+	keys.resize(ELEMENT_COUNT);
+	for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+		keys[i] = (uint64_t(rng.rand()) << 32) | rng.rand();
+	}
+	Parallel::radix_sort(keys.ptr(), keys.size());
+	sorted = true;
+	for (uint32_t i = 1; i < ELEMENT_COUNT; i++) {
+		sorted = sorted && keys[i - 1] <= keys[i];
+	}
+	CHECK(sorted);
+}
+
+TEST_CASE("[Parallel] Reduce and prefix sum") {
+	LocalVector<int> values = random_ints(ELEMENT_COUNT, 1000);
+	int64_t expected = 0;
+	for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+		expected += values[i];
+	}
+
+	int64_t sum = Parallel::reduce(
+			ELEMENT_COUNT, int64_t(0), [&](uint32_t p_index) { return int64_t(values[p_index]); }, [](int64_t p_a, int64_t p_b) { return p_a + p_b; });
+	CHECK(sum == expected);
+
+	int max = Parallel::reduce(
+			ELEMENT_COUNT, values[0], [&](uint32_t p_index) { return values[p_index]; }, [](int p_a, int p_b) { return MAX(p_a, p_b); });
+	CHECK(max <= 499);
+	CHECK(max >= 490);
+
+	LocalVector<int> sums;
+	sums.resize(ELEMENT_COUNT);
+	Parallel::prefix_sum(values.ptr(), sums.ptr(), ELEMENT_COUNT);
+	int running = 0;
+	bool matches = true;
+	for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+		running += values[i];
+		matches = matches && sums[i] == running;
+	}
+	CHECK(matches);
+
+	// In place.
+	Parallel::prefix_sum(values.ptr(), values.ptr(), ELEMENT_COUNT);
+	CHECK(equal(values, sums));
+}
+
+TEST_CASE("[Parallel] Partition is stable") {
+	LocalVector<int> values;
+	values.resize(ELEMENT_COUNT);
+	for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+		values[i] = i;
+	}
+
+	uint32_t count = Parallel::partition(values.ptr(), values.size(), [](int p_value) { return p_value % 3 == 0; });
+	CHECK(count == (ELEMENT_COUNT + 2) / 3);
+
+	bool partitioned = true;
+	for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+		partitioned = partitioned && ((values[i] % 3 == 0) == (i < count));
+		if (i > 0 && i != count) {
+			partitioned = partitioned && values[i - 1] < values[i];
+		}
+	}
+	CHECK(partitioned);
+}
+
+TEST_CASE_BENCHMARK("[Parallel][Benchmark] Sorting") {
+	const uint32_t count = 4000000;
+	RandomPCG rng(1);
+	LocalVector<uint32_t> source;
+	source.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		source[i] = rng.rand();
+	}
+
+	LocalVector<uint32_t> values = source;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	SortArray<uint32_t> sorter;
+	sorter.sort(values.ptr(), count);
+	print_line(vformat("SortArray: %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+
+	values = source;
+	begin = OS::get_singleton()->get_ticks_usec();
+	Parallel::sort(values.ptr(), count);
+	print_line(vformat("Parallel::sort: %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+
+	values = source;
+	begin = OS::get_singleton()->get_ticks_usec();
+	Parallel::radix_sort(values.ptr(), count);
+	print_line(vformat("Parallel::radix_sort: %d usec.", OS::get_singleton()->get_ticks_usec() - begin));
+}
+
+} // namespace TestParallel
+
+#endif // TEST_PARALLEL_H
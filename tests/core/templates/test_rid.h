@@ -31,7 +31,10 @@
 #ifndef TEST_RID_H
 #define TEST_RID_H
 
+#include "core/os/os.h"
+#include "core/os/thread.h"
 #include "core/templates/rid.h"
+#include "core/templates/rid_owner.h"
 
 #include "tests/test_macros.h"
 
@@ -96,6 +99,137 @@ TEST_CASE("[RID] 'get_local_index'") {
 	CHECK(RID::from_uint64(4'294'967'295).get_local_index() == 4'294'967'295);
 	CHECK(RID::from_uint64(4'294'967'297).get_local_index() == 1);
 }
+
+TEST_CASE("[RID_Owner] Allocate, initialize and free") {
+	RID_Owner<int, true> owner;
+	RID allocated = owner.allocate_rid();
+	CHECK(owner.owns(allocated));
+	ERR_PRINT_OFF;
+	CHECK(owner.get_or_null(allocated) == nullptr);
+	ERR_PRINT_ON;
+
+	owner.initialize_rid(allocated, 42);
+	REQUIRE(owner.get_or_null(allocated) != nullptr);
+	CHECK(*owner.get_or_null(allocated) == 42);
+
+	RID made = owner.make_rid(7);
+	CHECK(*owner.get_or_null(made) == 7);
+	CHECK(owner.get_rid_count() == 2);
+
+	owner.free(allocated);
+	CHECK(owner.get_or_null(allocated) == nullptr);
+	CHECK_FALSE(owner.owns(allocated));
+	CHECK(owner.get_or_null(RID()) == nullptr);
+
+	// The freed slot is reused with a new validator.
+	RID reused = owner.make_rid(8);
+	CHECK(reused.get_local_index() == allocated.get_local_index());
+	CHECK(owner.get_or_null(allocated) == nullptr);
+	CHECK(*owner.get_or_null(reused) == 8);
+
+	owner.free(made);
+	owner.free(reused);
+	CHECK(owner.get_rid_count() == 0);
+}
+
+struct RIDOwnerThreadData {
+	RID_Owner<uint64_t, true> owner;
+	LocalVector<RID> rids;
+	SafeNumeric<uint32_t> errors;
+	SafeFlag stop;
+	uint32_t lookups = 0;
+
+	RIDOwnerThreadData(uint32_t p_target_chunk_byte_size = 65536) :
+			owner(p_target_chunk_byte_size) {}
+};
+
+static void _rid_owner_lookup_thread(void *p_data) {
+	RIDOwnerThreadData *data = static_cast<RIDOwnerThreadData *>(p_data);
+	uint32_t found = 0;
+	for (uint32_t i = 0; i < data->lookups || !data->stop.is_set(); i++) {
+		RID rid = data->rids[i % data->rids.size()];
+		uint64_t *value = data->owner.get_or_null(rid);
+		if (!value || *value != rid.get_id()) {
+			data->errors.increment();
+		}
+		found++;
+	}
+	CHECK(found > 0);
+}
+
+TEST_CASE("[RID_Owner] Lock-free lookups while allocating from another thread") {
+	// Small chunks, so the chunk tables are replaced several times while being read.
+	RIDOwnerThreadData data(256);
+	data.lookups = 100000;
+	for (int i = 0; i < 64; i++) {
+		RID rid = data.owner.allocate_rid();
+		data.owner.initialize_rid(rid, rid.get_id());
+		data.rids.push_back(rid);
+	}
+
+	Thread threads[4];
+	for (int i = 0; i < 4; i++) {
+		threads[i].start(_rid_owner_lookup_thread, &data);
+	}
+
+	LocalVector<RID> extra;
+	for (int i = 0; i < 100000; i++) {
+		RID rid = data.owner.allocate_rid();
+		data.owner.initialize_rid(rid, rid.get_id());
+		extra.push_back(rid);
+		if (i % 3 == 0) {
+			data.owner.free(extra[extra.size() / 2]);
+			extra.remove_at_unordered(extra.size() / 2);
+		}
+	}
+	data.stop.set();
+
+	for (int i = 0; i < 4; i++) {
+		threads[i].wait_to_finish();
+	}
+	CHECK(data.errors.get() == 0);
+
+	for (uint32_t i = 0; i < extra.size(); i++) {
+		data.owner.free(extra[i]);
+	}
+	for (uint32_t i = 0; i < data.rids.size(); i++) {
+		data.owner.free(data.rids[i]);
+	}
+}
+
+TEST_CASE_BENCHMARK("[RID_Owner][Benchmark] Lookups from several threads") {
+	RIDOwnerThreadData data;
+	data.lookups = 10000000;
+	for (int i = 0; i < 4096; i++) {
+		RID rid = data.owner.allocate_rid();
+		data.owner.initialize_rid(rid, rid.get_id());
+		data.rids.push_back(rid);
+	}
+	data.stop.set();
+
+	for (int thread_count = 1; thread_count <= OS::get_singleton()->get_processor_count(); thread_count *= 2) {
+		Vector<Thread *> threads;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			Thread *thread = memnew(Thread);
+			thread->start(_rid_owner_lookup_thread, &data);
+			threads.push_back(thread);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i]->wait_to_finish();
+			memdelete(threads[i]);
+		}
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_line(vformat("%d threads did %d lookups each in %d usec (%.1f million lookups per second in total).", thread_count, data.lookups, elapsed, double(thread_count) * data.lookups / elapsed));
+	}
+	CHECK(data.errors.get() == 0);
+
+	for (uint32_t i = 0; i < data.rids.size(); i++) {
+		data.owner.free(data.rids[i]);
+	}
+}
+
 } // namespace TestRID
 
 #endif // TEST_RID_H
@@ -153,6 +153,103 @@ TEST_CASE("[WorkerThreadPool] Process 256 elements on native task group low prio
 	CHECK(callable_group_counter.get() == count - 1);
 }
 
+struct DependencyOrder {
+	SafeNumeric<uint32_t> step;
+	uint32_t first_step = 0;
+	uint32_t second_step = 0;
+	uint32_t last_step = 0;
+};
+
+static void dependency_first(void *p_arg) {
+	DependencyOrder *order = (DependencyOrder *)p_arg;
+	OS::get_singleton()->delay_usec(1000);
+	order->first_step = order->step.increment();
+}
+
+static void dependency_second(void *p_arg) {
+	DependencyOrder *order = (DependencyOrder *)p_arg;
+	order->second_step = order->step.increment();
+}
+
+static void dependency_last(void *p_arg) {
+	DependencyOrder *order = (DependencyOrder *)p_arg;
+	order->last_step = order->step.increment();
+}
+
+TEST_CASE("[WorkerThreadPool] Tasks start after their dependencies") {
+	DependencyOrder order;
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+	WorkerThreadPool::TaskID first = pool->add_native_task(dependency_first, &order, true);
+	Vector<WorkerThreadPool::TaskID> after_first;
+	after_first.push_back(first);
+	WorkerThreadPool::TaskID second = pool->add_native_task_after(after_first, dependency_second, &order, true);
+	Vector<WorkerThreadPool::TaskID> after_both;
+	after_both.push_back(first);
+	after_both.push_back(second);
+	WorkerThreadPool::TaskID last = pool->add_native_task_after(after_both, dependency_last, &order, false);
+
+	pool->wait_for_task_completion(last);
+	pool->wait_for_task_completion(second);
+	pool->wait_for_task_completion(first);
+
+	CHECK(order.first_step == 1);
+	CHECK(order.second_step == 2);
+	CHECK(order.last_step == 3);
+
+	// Dependencies that were already waited for count as completed.
+	WorkerThreadPool::TaskID again = pool->add_native_task_after(after_both, dependency_last, &order, true);
+	pool->wait_for_task_completion(again);
+	CHECK(order.last_step == 4);
+}
+
+static void nested_group_element(void *p_arg, uint32_t p_index) {
+	SafeNumeric<uint32_t> *counter = (SafeNumeric<uint32_t> *)p_arg;
+	counter->increment();
+}
+
+static void nested_group_task(void *p_arg) {
+	// Waiting from a pool thread must process pending work instead of blocking it.
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(nested_group_element, p_arg, 64, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+}
+
+TEST_CASE("[WorkerThreadPool] Wait for groups from inside tasks") {
+	const int count = 64;
+	SafeNumeric<uint32_t> counter;
+	WorkerThreadPool::TaskID tasks[count];
+	for (int i = 0; i < count; i++) {
+		tasks[i] = WorkerThreadPool::get_singleton()->add_native_task(nested_group_task, &counter, true);
+	}
+	for (int i = 0; i < count; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(tasks[i]);
+	}
+
+	CHECK(counter.get() == count * 64);
+}
+
+static void benchmark_group_element(void *p_arg, uint32_t p_index) {
+	float *values = (float *)p_arg;
+	values[p_index] = Math::sqrt(values[p_index] + p_index);
+}
+
+TEST_CASE_BENCHMARK("[WorkerThreadPool][Benchmark] Small group tasks") {
+	const int elements = 4096;
+	const int iterations = 2000;
+	Vector<float> values;
+	values.resize(elements);
+	values.fill(1.0);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(benchmark_group_element, values.ptrw(), elements, -1, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	print_line(vformat("%d groups of %d elements in %d usec (%.1f usec per group).", iterations, elements, elapsed, double(elapsed) / iterations));
+}
+
 } // namespace TestWorkerThreadPool
 
 #endif // TEST_WORKER_THREAD_POOL_H
@@ -518,6 +518,30 @@ TEST_CASE("[Dictionary] Order and find") {
 	CHECK_EQ(d.find_key("does not exist"), Variant());
 }
 
+TEST_CASE("[Dictionary] Order after erasing") {
+	Dictionary d;
+	for (int i = 0; i < 100; i++) {
+		d[i] = i;
+	}
+	for (int i = 0; i < 100; i++) {
+		if (i % 10 != 0) {
+			d.erase(i);
+		}
+	}
+	d[5] = 5;
+
+	Array keys;
+	for (int i = 0; i < 100; i += 10) {
+		keys.append(i);
+	}
+	keys.append(5);
+
+	CHECK_EQ(d.keys(), keys);
+	CHECK_EQ(d.get_key_at_index(10), Variant(5));
+	CHECK_EQ(d.get_value_at_index(1), Variant(10));
+	CHECK_EQ(d.get_key_at_index(11), Variant());
+}
+
 } // namespace TestDictionary
 
 #endif // TEST_DICTIONARY_H
@@ -0,0 +1,415 @@
+/*************************************************************************/
+/*  test_node.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NODE_H
+#define TEST_NODE_H
+
+#include "core/os/os.h"
+#include "core/templates/local_vector.h"
+#include "scene/main/node.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNode {
+
+// Keeps the index it was last told about, like CanvasItem does for its draw index.
+class _TestIndexNode : public Node {
+	GDCLASS(_TestIndexNode, Node);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_ENTER_TREE || p_what == NOTIFICATION_MOVED_IN_PARENT) {
+			notified_index = get_index();
+		}
+	}
+
+public:
+	int notified_index = -1;
+};
+
+// Records how and when it was processed, optionally trying cross-group access on the way.
+class _TestThreadGroupNode : public Node {
+	GDCLASS(_TestThreadGroupNode, Node);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what != NOTIFICATION_PROCESS) {
+			return;
+		}
+
+		process_order = counter->increment();
+		self_accessible = is_accessible_from_caller_thread();
+		if (probe) {
+			probe_accessible = probe->is_accessible_from_caller_thread();
+		}
+		if (try_cross_group_access) {
+			Node *child = memnew(Node);
+			add_child(child);
+			add_child_rejected = child->get_parent() == nullptr;
+			memdelete(child);
+
+			// Applied right away within the group, deferred to the main thread otherwise.
+			set_thread_safe("editor_description", "Set");
+			self_set_immediately = get_editor_description() == "Set";
+			probe->set_thread_safe("editor_description", "Set");
+			probe_set_immediately = probe->get_editor_description() == "Set";
+		}
+		if (free_self) {
+			queue_delete();
+		}
+	}
+
+public:
+	SafeNumeric<uint32_t> *counter = nullptr;
+	Node *probe = nullptr;
+	bool try_cross_group_access = false;
+	bool free_self = false;
+
+	uint32_t process_order = 0;
+	bool self_accessible = false;
+	bool probe_accessible = false;
+	bool add_child_rejected = false;
+	bool self_set_immediately = false;
+	bool probe_set_immediately = false;
+};
+
+TEST_CASE("[Node] Child lookup and removal") {
+	Node *parent = memnew(Node);
+	Vector<Node *> children;
+	for (int i = 0; i < 10; i++) {
+		Node *child = memnew(Node);
+		child->set_name(vformat("Child%d", i));
+		parent->add_child(child);
+		children.push_back(child);
+	}
+
+	parent->remove_child(children[2]);
+	memdelete(children[5]); // Removes itself from the parent.
+	parent->remove_child(children[7]);
+
+	CHECK(parent->get_child_count() == 7);
+	CHECK(parent->get_child(2) == children[3]);
+	CHECK(parent->get_child(-1) == children[9]);
+	CHECK(children[8]->get_index() == 5);
+	CHECK(parent->get_node_or_null(NodePath("Child6")) == children[6]);
+	CHECK(parent->get_node_or_null(NodePath("Child5")) == nullptr);
+	CHECK(children[2]->get_parent() == nullptr);
+	CHECK(children[2]->get_index() == -1);
+
+	SUBCASE("Names stay unique") {
+		children[2]->set_name("Child3");
+		parent->add_child(children[2], true);
+		CHECK(children[2]->get_name() != StringName("Child3"));
+		CHECK(parent->get_node_or_null(NodePath("Child3")) == children[3]);
+		CHECK(parent->get_node_or_null(NodePath(children[2]->get_name())) == children[2]);
+
+		children[3]->set_name("Renamed");
+		CHECK(parent->get_node_or_null(NodePath("Child3")) == nullptr);
+		CHECK(parent->get_node_or_null(NodePath("Renamed")) == children[3]);
+	}
+
+	SUBCASE("Moving and internal children") {
+		Node *internal_front = memnew(Node);
+		Node *internal_back = memnew(Node);
+		parent->add_child(internal_front, false, Node::INTERNAL_MODE_FRONT);
+		parent->add_child(internal_back, false, Node::INTERNAL_MODE_BACK);
+		parent->remove_child(children[0]);
+		parent->move_child(children[9], 0);
+
+		CHECK(parent->get_child_count(false) == 6);
+		CHECK(parent->get_child_count(true) == 8);
+		CHECK(parent->get_child(0, true) == internal_front);
+		CHECK(parent->get_child(-1, true) == internal_back);
+		CHECK(parent->get_child(0) == children[9]);
+		CHECK(parent->get_child(1) == children[1]);
+		CHECK(children[9]->get_index() == 0);
+		CHECK(internal_back->get_index(true) == 7);
+
+		memdelete(children[0]);
+	}
+
+	memdelete(children[2]);
+	memdelete(children[7]);
+	memdelete(parent);
+}
+
+TEST_CASE("[SceneTree][Node] Sibling indices after removing children") {
+	Node *parent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(parent);
+
+	Vector<_TestIndexNode *> children;
+	for (int i = 0; i < 5; i++) {
+		_TestIndexNode *child = memnew(_TestIndexNode);
+		parent->add_child(child);
+		children.push_back(child);
+	}
+
+	// Remove from the front and the middle, then add a new child at the end.
+	memdelete(children[0]);
+	children.remove_at(0);
+	parent->remove_child(children[1]);
+	_TestIndexNode *removed = children[1];
+	children.remove_at(1);
+
+	_TestIndexNode *added = memnew(_TestIndexNode);
+	parent->add_child(added);
+	children.push_back(added);
+
+	// Getters see the new indices, but don't send notifications themselves.
+	CHECK(parent->get_child_count() == 4);
+	for (int i = 0; i < children.size(); i++) {
+		CHECK(parent->get_child(i) == children[i]);
+		CHECK(children[i]->get_index() == i);
+	}
+	CHECK(children[0]->notified_index == 1);
+	CHECK(children[2]->notified_index == 4);
+
+	// Moved children are notified at idle time.
+	MessageQueue::get_singleton()->flush();
+	for (int i = 0; i < children.size(); i++) {
+		CHECK_MESSAGE(children[i]->notified_index == i, "Every child should be notified of its new index, so draw order follows child order.");
+	}
+
+	memdelete(removed);
+	memdelete(parent);
+}
+
+TEST_CASE("[SceneTree][Node] Group order and calls") {
+	SceneTree *tree = SceneTree::get_singleton();
+	Node *parent = memnew(Node);
+	tree->get_root()->add_child(parent);
+
+	Vector<Node *> children;
+	for (int i = 0; i < 8; i++) {
+		Node *child = memnew(Node);
+		parent->add_child(child);
+		children.push_back(child);
+	}
+	// Join in reverse, the group must still be returned in tree order.
+	for (int i = children.size() - 1; i >= 0; i--) {
+		children[i]->add_to_group("test_group");
+	}
+
+	List<Node *> nodes;
+	tree->get_nodes_in_group("test_group", &nodes);
+	CHECK(nodes.size() == 8);
+	int index = 0;
+	for (Node *E : nodes) {
+		CHECK(E == children[index++]);
+	}
+	CHECK(tree->get_first_node_in_group("test_group") == children[0]);
+
+	SUBCASE("Calls reach every member") {
+		tree->call_group("test_group", "set_meta", "called", true);
+		tree->call_group_flags(SceneTree::GROUP_CALL_PARALLEL, "test_group", "set_meta", "called_parallel", true);
+		tree->set_group("test_group", "editor_description", "Set");
+		for (int i = 0; i < children.size(); i++) {
+			CHECK(bool(children[i]->get_meta("called", false)));
+			CHECK(bool(children[i]->get_meta("called_parallel", false)));
+			CHECK(children[i]->get_editor_description() == "Set");
+		}
+	}
+
+	SUBCASE("Removed members are not called") {
+		children[5]->remove_from_group("test_group");
+		memdelete(children[6]);
+		children.remove_at(6);
+		tree->call_group("test_group", "set_meta", "called", true);
+		CHECK_FALSE(bool(children[5]->get_meta("called", false)));
+		CHECK(tree->get_first_node_in_group("test_group") == children[0]);
+		nodes.clear();
+		tree->get_nodes_in_group("test_group", &nodes);
+		CHECK(nodes.size() == 6);
+	}
+
+	memdelete(parent);
+}
+
+TEST_CASE("[SceneTree][Node] Thread group processing order") {
+	SceneTree *tree = SceneTree::get_singleton();
+	SafeNumeric<uint32_t> counter;
+
+	Node *root = memnew(Node);
+	LocalVector<_TestThreadGroupNode *> groups[2];
+	for (int g = 0; g < 2; g++) {
+		_TestThreadGroupNode *owner = memnew(_TestThreadGroupNode);
+		owner->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+		root->add_child(owner);
+		groups[g].push_back(owner);
+		for (int i = 0; i < 4; i++) {
+			_TestThreadGroupNode *child = memnew(_TestThreadGroupNode);
+			owner->add_child(child);
+			groups[g].push_back(child);
+		}
+	}
+	LocalVector<_TestThreadGroupNode *> main_nodes;
+	for (int i = 0; i < 3; i++) {
+		_TestThreadGroupNode *node = memnew(_TestThreadGroupNode);
+		root->add_child(node);
+		main_nodes.push_back(node);
+	}
+	// A node can opt out of its parent's group. It comes first in tree order.
+	_TestThreadGroupNode *main_in_group = memnew(_TestThreadGroupNode);
+	main_in_group->set_process_thread_group(Node::PROCESS_THREAD_GROUP_MAIN_THREAD);
+	groups[0][0]->add_child(main_in_group);
+	main_nodes.insert(0, main_in_group);
+
+	for (int g = 0; g < 2; g++) {
+		for (uint32_t i = 0; i < groups[g].size(); i++) {
+			_TestThreadGroupNode *node = groups[g][i];
+			node->counter = &counter;
+			node->probe = groups[1 - g][0];
+			node->set_process(true);
+		}
+	}
+	for (uint32_t i = 0; i < main_nodes.size(); i++) {
+		_TestThreadGroupNode *node = main_nodes[i];
+		node->counter = &counter;
+		node->probe = groups[0][0];
+		node->set_process(true);
+	}
+
+	tree->get_root()->add_child(root);
+	tree->process(0.016);
+
+	uint32_t last_group_order = 0;
+	for (int g = 0; g < 2; g++) {
+		for (uint32_t i = 0; i < groups[g].size(); i++) {
+			_TestThreadGroupNode *node = groups[g][i];
+			CHECK(node->process_order > 0);
+			if (i > 0) {
+				CHECK_MESSAGE(node->process_order > groups[g][i - 1]->process_order, "Nodes within a group should be processed in tree order.");
+			}
+			CHECK(node->self_accessible);
+			CHECK_FALSE_MESSAGE(node->probe_accessible, "Nodes of another group should not be accessible.");
+			last_group_order = MAX(last_group_order, node->process_order);
+		}
+	}
+	for (uint32_t i = 0; i < main_nodes.size(); i++) {
+		_TestThreadGroupNode *node = main_nodes[i];
+		CHECK_MESSAGE(node->process_order > last_group_order, "Main thread nodes should be processed after every group.");
+		if (i > 0) {
+			CHECK(node->process_order > main_nodes[i - 1]->process_order);
+		}
+		CHECK(node->self_accessible);
+		CHECK_MESSAGE(node->probe_accessible, "Every node should be accessible from the main thread once groups are done.");
+	}
+
+	memdelete(root);
+}
+
+TEST_CASE("[SceneTree][Node] Thread group cross-group access") {
+	SceneTree *tree = SceneTree::get_singleton();
+	SafeNumeric<uint32_t> counter;
+
+	Node *root = memnew(Node);
+	_TestThreadGroupNode *group_a = memnew(_TestThreadGroupNode);
+	group_a->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	root->add_child(group_a);
+	_TestThreadGroupNode *freed = memnew(_TestThreadGroupNode);
+	group_a->add_child(freed);
+
+	_TestThreadGroupNode *group_b = memnew(_TestThreadGroupNode);
+	group_b->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	root->add_child(group_b);
+
+	group_a->counter = &counter;
+	group_a->probe = group_b;
+	group_a->try_cross_group_access = true;
+	freed->counter = &counter;
+	freed->free_self = true;
+	group_b->counter = &counter;
+	group_a->set_process(true);
+	freed->set_process(true);
+	group_b->set_process(true);
+
+	tree->get_root()->add_child(root);
+	const ObjectID freed_id = freed->get_instance_id();
+
+	ERR_PRINT_OFF;
+	tree->process(0.016);
+	ERR_PRINT_ON;
+
+	CHECK_MESSAGE(group_a->add_child_rejected, "Adding children should fail while processing a thread group.");
+	CHECK(group_a->get_child_count() == 0);
+	CHECK_MESSAGE(group_a->self_set_immediately, "Nodes of the same group should be set directly.");
+	CHECK_FALSE_MESSAGE(group_a->probe_set_immediately, "Nodes of another group should be set on the main thread.");
+	CHECK_MESSAGE(group_b->get_editor_description() == "Set", "Deferred sets should be applied once processing is done.");
+	CHECK_MESSAGE(ObjectDB::get_instance(freed_id) == nullptr, "queue_free() should be forwarded to the main thread.");
+
+	// Outside of processing, the main thread can access and change everything again.
+	CHECK(group_b->is_accessible_from_caller_thread());
+	Node *child = memnew(Node);
+	group_a->add_child(child);
+	CHECK(child->get_parent() == group_a);
+
+	memdelete(root);
+}
+
+TEST_CASE_BENCHMARK("[Node][Benchmark] Removing and finding children") {
+	const int child_count = 20000;
+
+	Node *parent = memnew(Node);
+	Vector<Node *> children;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < child_count; i++) {
+		Node *child = memnew(Node);
+		child->set_name(vformat("Child%d", i));
+		parent->add_child(child);
+		children.push_back(child);
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("Added %d children in %d usec.", child_count, elapsed));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < child_count; i++) {
+		CHECK(parent->get_node_or_null(NodePath(vformat("Child%d", i))) == children[i]);
+	}
+	elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("Found %d children by name in %d usec.", child_count, elapsed));
+
+	// Removing from the front is the worst case when following children are shifted.
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < child_count; i += 2) {
+		memdelete(children[i]);
+	}
+	CHECK(parent->get_child_count() == child_count / 2);
+	CHECK(parent->get_child(0) == children[1]);
+	elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("Removed %d children in %d usec.", child_count / 2, elapsed));
+
+	memdelete(parent);
+}
+
+} // namespace TestNode
+
+#endif // TEST_NODE_H
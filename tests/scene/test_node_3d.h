@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  test_node_3d.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NODE_3D_H
+#define TEST_NODE_3D_H
+
+#include "scene/3d/node_3d.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNode3D {
+
+// Counts transform notifications and records the global position seen by the last one.
+class _TestNotifiedNode3D : public Node3D {
+	GDCLASS(_TestNotifiedNode3D, Node3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			notified_count++;
+			notified_position = get_global_position();
+		}
+	}
+
+public:
+	int notified_count = 0;
+	Vector3 notified_position;
+
+	_TestNotifiedNode3D() {
+		set_notify_transform(true);
+	}
+};
+
+TEST_CASE("[SceneTree][Node3D] Global transform updates") {
+	Node3D *parent = memnew(Node3D);
+	Node3D *child = memnew(Node3D);
+	Node3D *grandchild = memnew(Node3D);
+	Node3D *top_level = memnew(Node3D);
+	parent->add_child(child);
+	child->add_child(grandchild);
+	child->add_child(top_level);
+	top_level->set_as_top_level(true);
+	grandchild->set_notify_transform(true);
+	SceneTree::get_singleton()->get_root()->add_child(parent);
+
+	parent->set_position(Vector3(1, 0, 0));
+	child->set_position(Vector3(0, 1, 0));
+	grandchild->set_position(Vector3(0, 0, 1));
+	top_level->set_position(Vector3(0, 0, 2));
+	SceneTree::get_singleton()->flush_transform_notifications();
+
+	CHECK(grandchild->get_global_position().is_equal_approx(Vector3(1, 1, 1)));
+	CHECK(top_level->get_global_position().is_equal_approx(Vector3(0, 0, 2)));
+
+	SUBCASE("Repeated changes before a flush") {
+		parent->set_position(Vector3(2, 0, 0));
+		parent->set_position(Vector3(3, 0, 0));
+		child->set_position(Vector3(0, 2, 0));
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		CHECK(grandchild->get_global_position().is_equal_approx(Vector3(3, 2, 1)));
+		CHECK(top_level->get_global_position().is_equal_approx(Vector3(0, 0, 2)));
+	}
+
+	SUBCASE("Changes after reading an intermediate global transform") {
+		parent->set_position(Vector3(2, 0, 0));
+		CHECK(child->get_global_position().is_equal_approx(Vector3(2, 1, 0)));
+		parent->set_position(Vector3(4, 0, 0));
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		CHECK(grandchild->get_global_position().is_equal_approx(Vector3(4, 1, 1)));
+	}
+
+	memdelete(parent);
+}
+
+TEST_CASE("[SceneTree][Node3D] Transform notifications") {
+	SceneTree *tree = SceneTree::get_singleton();
+	Node3D *parent = memnew(Node3D);
+	_TestNotifiedNode3D *child = memnew(_TestNotifiedNode3D);
+	Node3D *silent = memnew(Node3D); // Not notified, but its child is.
+	_TestNotifiedNode3D *grandchild = memnew(_TestNotifiedNode3D);
+	parent->add_child(child);
+	parent->add_child(silent);
+	child->add_child(grandchild);
+	silent->add_child(memnew(_TestNotifiedNode3D));
+	_TestNotifiedNode3D *silent_child = Object::cast_to<_TestNotifiedNode3D>(silent->get_child(0));
+	child->set_position(Vector3(0, 1, 0));
+	grandchild->set_position(Vector3(0, 0, 1));
+	tree->get_root()->add_child(parent);
+	tree->flush_transform_notifications();
+
+	child->notified_count = 0;
+	grandchild->notified_count = 0;
+	silent_child->notified_count = 0;
+
+	SUBCASE("Parent moved twice in one frame") {
+		parent->set_position(Vector3(1, 0, 0));
+		parent->set_position(Vector3(2, 0, 0));
+		tree->flush_transform_notifications();
+
+		CHECK(child->notified_count == 1);
+		CHECK(grandchild->notified_count == 1);
+		CHECK(silent_child->notified_count == 1);
+		CHECK(child->notified_position.is_equal_approx(Vector3(2, 1, 0)));
+		CHECK(grandchild->notified_position.is_equal_approx(Vector3(2, 1, 1)));
+		CHECK(silent_child->notified_position.is_equal_approx(Vector3(2, 0, 0)));
+	}
+
+	SUBCASE("Child moved after its parent") {
+		parent->set_position(Vector3(1, 0, 0));
+		child->set_position(Vector3(0, 3, 0));
+		tree->flush_transform_notifications();
+
+		CHECK(child->notified_count == 1);
+		CHECK(grandchild->notified_count == 1);
+		CHECK(silent_child->notified_count == 1);
+		CHECK(child->notified_position.is_equal_approx(Vector3(1, 3, 0)));
+		CHECK(grandchild->notified_position.is_equal_approx(Vector3(1, 3, 1)));
+	}
+
+	SUBCASE("Notifications enabled while the subtree is already dirty") {
+		_TestNotifiedNode3D *late = memnew(_TestNotifiedNode3D);
+		late->set_notify_transform(false);
+		grandchild->add_child(late);
+		tree->flush_transform_notifications();
+
+		parent->set_position(Vector3(1, 0, 0));
+		late->set_notify_transform(true);
+		parent->set_position(Vector3(2, 0, 0));
+		tree->flush_transform_notifications();
+
+		CHECK(late->notified_count == 1);
+		CHECK(late->notified_position.is_equal_approx(Vector3(2, 1, 1)));
+		CHECK(grandchild->notified_count == 1);
+	}
+
+	// Nothing is notified again without another change.
+	int count = child->notified_count;
+	tree->flush_transform_notifications();
+	CHECK(child->notified_count == count);
+
+	memdelete(parent);
+}
+
+} // namespace TestNode3D
+
+#endif // TEST_NODE_3D_H
@@ -0,0 +1,309 @@
+/*************************************************************************/
+/*  test_packed_scene.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PACKED_SCENE_H
+#define TEST_PACKED_SCENE_H
+
+#include "scene/main/scene_pool.h"
+#include "scene/main/scene_tree_instantiation.h"
+#include "scene/main/window.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPackedScene {
+
+TEST_CASE("[PackedScene] Instantiating copies") {
+	Node *scene = memnew(Node);
+	scene->set_name("Root");
+	scene->set_process_priority(3);
+	Node *child = memnew(Node);
+	child->set_name("Child");
+	child->set_editor_description("Packed");
+	scene->add_child(child);
+	child->set_owner(scene);
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(scene) == OK);
+	memdelete(scene);
+
+	Vector<Node *> nodes;
+	packed_scene->instantiate_multiple(3, PackedScene::GEN_EDIT_STATE_DISABLED, nodes);
+	nodes.push_back(packed_scene->instantiate());
+	REQUIRE(nodes.size() == 4);
+
+	for (int i = 0; i < nodes.size(); i++) {
+		CHECK(nodes[i]->get_name() == StringName("Root"));
+		CHECK(nodes[i]->get_process_priority() == 3);
+		Node *copy_child = nodes[i]->get_node_or_null(NodePath("Child"));
+		REQUIRE(copy_child);
+		CHECK(copy_child->get_owner() == nodes[i]);
+		CHECK(copy_child->get_editor_description() == "Packed");
+		memdelete(nodes[i]);
+	}
+}
+
+TEST_CASE("[PackedScene] Pooling instances") {
+	Node *scene = memnew(Node);
+	scene->set_name("Root");
+	Node *child = memnew(Node);
+	child->set_name("Child");
+	scene->add_child(child);
+	child->set_owner(scene);
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(scene) == OK);
+	memdelete(scene);
+
+	Ref<ScenePool> pool;
+	pool.instantiate();
+	pool->set_scene(packed_scene);
+	pool->prewarm(2);
+	CHECK(pool->get_available_count() == 2);
+	CHECK(ScenePool::get_pooled_node_count() == 4);
+
+	Node *a = pool->acquire();
+	Node *b = pool->acquire();
+	Node *c = pool->acquire(); // Instantiated, the pool is empty.
+	REQUIRE(a);
+	REQUIRE(b);
+	REQUIRE(c);
+	CHECK(pool->get_available_count() == 0);
+	CHECK(ScenePool::get_pooled_node_count() == 0);
+
+	Node *parent = memnew(Node);
+	parent->add_child(a);
+	// Properties the scene doesn't store are only reset when marked dirty.
+	pool->mark_dirty(a, "process_priority");
+	pool->mark_dirty(a->get_node(NodePath("Child")), "editor_description");
+	a->set_process_priority(5);
+	a->get_node(NodePath("Child"))->set_editor_description("Changed");
+
+	pool->release(a);
+	CHECK(a->get_parent() == nullptr);
+	CHECK(a->get_process_priority() == 0);
+	CHECK(a->get_node(NodePath("Child"))->get_editor_description().is_empty());
+	CHECK(pool->get_available_count() == 1);
+	CHECK(ScenePool::get_pooled_node_count() == 2);
+
+	ERR_PRINT_OFF;
+	pool->release(a); // Already released.
+	pool->release(parent); // Not from this pool.
+	pool->mark_dirty(a, "process_priority"); // Released.
+	ERR_PRINT_ON;
+	CHECK(pool->get_available_count() == 1);
+
+	CHECK(pool->acquire() == a);
+
+	memdelete(b); // Freed instead of released.
+	pool->release(c);
+	pool->clear();
+	CHECK(pool->get_available_count() == 0);
+	CHECK(ScenePool::get_pooled_node_count() == 0);
+
+	memdelete(a);
+	memdelete(parent);
+}
+
+TEST_CASE("[PackedScene] Pooled instances freed or edited in place") {
+	Node *scene = memnew(Node);
+	scene->set_name("Root");
+	Array items;
+	items.push_back(1);
+	scene->set_meta("items", items);
+	Node *child = memnew(Node);
+	child->set_name("Child");
+	scene->add_child(child);
+	child->set_owner(scene);
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(scene) == OK);
+	memdelete(scene);
+
+	Ref<ScenePool> pool;
+	pool.instantiate();
+	pool->set_scene(packed_scene);
+
+	SUBCASE("Containers edited in place are reset") {
+		Node *a = pool->acquire();
+		REQUIRE(a);
+		for (int i = 0; i < 2; i++) {
+			Array a_items = a->get_meta("items");
+			a_items.push_back(2); // Shared with the node.
+			CHECK(Array(a->get_meta("items")).size() == 2);
+
+			pool->release(a);
+			CHECK(Array(a->get_meta("items")).size() == 1);
+			CHECK(pool->acquire() == a);
+		}
+		memdelete(a);
+	}
+
+	SUBCASE("Instances freed while pooled are skipped") {
+		Node *a = pool->acquire();
+		REQUIRE(a);
+		pool->release(a);
+		CHECK(ScenePool::get_pooled_node_count() == 2);
+		CHECK(ScenePool::get_pooled_orphan_node_count() == 2);
+
+		memdelete(a);
+		Node *b = pool->acquire(); // The freed instance is found and discounted.
+		REQUIRE(b);
+		CHECK(pool->get_available_count() == 0);
+		CHECK(ScenePool::get_pooled_node_count() == 0);
+		CHECK(b->get_child_count() == 1);
+		memdelete(b);
+	}
+
+	pool->clear();
+}
+
+TEST_CASE("[SceneTree][PackedScene] Pooled instances released inside the tree") {
+	Node *scene = memnew(Node);
+	scene->set_name("Root");
+	scene->set_process_priority(2);
+	Node *child = memnew(Node);
+	child->set_name("Child");
+	scene->add_child(child);
+	child->set_owner(scene);
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(scene) == OK);
+	memdelete(scene);
+
+	Node *parent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(parent);
+
+	Ref<ScenePool> pool;
+	pool.instantiate();
+	pool->set_scene(packed_scene);
+
+	Node *a = pool->acquire(parent);
+	REQUIRE(a);
+	CHECK(a->get_parent() == parent);
+	CHECK(a->is_inside_tree());
+	a->set_process_priority(7); // Stored by the scene, reset without being marked dirty.
+
+	// Parked in place instead of exiting the tree.
+	pool->release(a);
+	CHECK(a->get_parent() == parent);
+	CHECK(a->is_inside_tree());
+	CHECK(a->get_process_mode() == Node::PROCESS_MODE_DISABLED);
+	CHECK(a->get_process_priority() == 2);
+	CHECK(ScenePool::get_pooled_node_count() == 2);
+	CHECK(ScenePool::get_pooled_orphan_node_count() == 0);
+
+	SUBCASE("Acquired again in place") {
+		CHECK(pool->acquire(parent) == a);
+		CHECK(a->get_parent() == parent);
+		CHECK(a->get_process_mode() == Node::PROCESS_MODE_INHERIT);
+		CHECK(ScenePool::get_pooled_node_count() == 0);
+	}
+
+	SUBCASE("Acquired for another parent") {
+		Node *other = memnew(Node);
+		SceneTree::get_singleton()->get_root()->add_child(other);
+		CHECK(pool->acquire(other) == a);
+		CHECK(a->get_parent() == other);
+		CHECK(a->get_process_mode() == Node::PROCESS_MODE_INHERIT);
+		memdelete(other);
+	}
+
+	pool->clear();
+	memdelete(parent);
+}
+
+TEST_CASE("[SceneTree][PackedScene] Instantiating over several steps") {
+	Node *scene = memnew(Node);
+	scene->set_name("Root");
+	for (int i = 0; i < 2; i++) {
+		Node *child = memnew(Node);
+		child->set_name(vformat("Child%d", i));
+		scene->add_child(child);
+		child->set_owner(scene);
+	}
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(scene) == OK);
+	memdelete(scene);
+
+	Node *parent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(parent);
+
+	SUBCASE("Nodes are constructed one step at a time and added at the end") {
+		// With no budget, every step constructs a single node.
+		Ref<SceneTreeInstantiation> inst = SceneTree::get_singleton()->create_instantiation(packed_scene, parent, 0.0);
+		REQUIRE(inst.is_valid());
+		CHECK(inst->get_progress() == doctest::Approx(0.0));
+
+		CHECK_FALSE(inst->step());
+		CHECK(inst->get_progress() == doctest::Approx(0.25));
+		CHECK_FALSE(inst->step());
+		CHECK_FALSE(inst->step());
+		CHECK(inst->get_progress() == doctest::Approx(0.75));
+		CHECK(parent->get_child_count() == 0);
+
+		// Insertion gets a step of its own.
+		CHECK_FALSE(inst->step());
+		CHECK(parent->get_child_count() == 0);
+		CHECK(inst->step());
+
+		CHECK(inst->is_completed());
+		CHECK(inst->get_progress() == doctest::Approx(1.0));
+		REQUIRE(inst->get_node() != nullptr);
+		CHECK(inst->get_node()->get_parent() == parent);
+		CHECK(inst->get_node()->is_inside_tree());
+		CHECK(inst->get_node()->get_child_count() == 2);
+	}
+
+	SUBCASE("Canceling frees the constructed nodes") {
+		Ref<SceneTreeInstantiation> inst = SceneTree::get_singleton()->create_instantiation(packed_scene, parent, 0.0);
+		REQUIRE(inst.is_valid());
+		CHECK_FALSE(inst->step());
+		CHECK_FALSE(inst->step());
+
+		inst->cancel();
+		CHECK(inst->is_completed());
+		CHECK(inst->step());
+		CHECK(inst->get_node() == nullptr);
+		CHECK(parent->get_child_count() == 0);
+	}
+
+	memdelete(parent);
+}
+
+} // namespace TestPackedScene
+
+#endif // TEST_PACKED_SCENE_H
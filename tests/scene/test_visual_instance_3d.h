@@ -0,0 +1,309 @@
+/*************************************************************************/
+/*  test_visual_instance_3d.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_VISUAL_INSTANCE_3D_H
+#define TEST_VISUAL_INSTANCE_3D_H
+
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/main/window.h"
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestVisualInstance3D {
+
+// Instances found by the RenderingServer around a position.
+static Vector<ObjectID> cull_at(RID p_scenario, const Vector3 &p_position) {
+	return RS::get_singleton()->instances_cull_aabb(AABB(p_position - Vector3(1, 1, 1), Vector3(2, 2, 2)), p_scenario);
+}
+
+static MeshInstance3D *create_instance(RID p_mesh, const Vector3 &p_position) {
+	MeshInstance3D *instance = memnew(MeshInstance3D);
+	instance->set_base(p_mesh);
+	instance->set_custom_aabb(AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+	instance->set_position(p_position);
+	return instance;
+}
+
+// Frees other nodes when notified of a transform change, while the transform batch
+// opened by the transform flush is still pending.
+class _TestFreeingNode3D : public Node3D {
+	GDCLASS(_TestFreeingNode3D, Node3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			for (int i = 0; i < victims.size(); i++) {
+				memdelete(victims[i]);
+			}
+			victims.clear();
+		}
+	}
+
+public:
+	Vector<Node *> victims;
+
+	_TestFreeingNode3D() {
+		set_notify_transform(true);
+	}
+};
+
+// Moves its instance to another scenario when ready, like a script calling the server would.
+class _TestReadyScenarioInstance : public MeshInstance3D {
+	GDCLASS(_TestReadyScenarioInstance, MeshInstance3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_READY) {
+			RS::get_singleton()->instance_set_scenario(get_instance(), scenario);
+		}
+	}
+
+public:
+	RID scenario;
+};
+
+TEST_CASE("[SceneTree][RenderingServer] Bulk instance transforms and scenarios") {
+	RenderingServer *rs = RS::get_singleton();
+	RID scenario = rs->scenario_create();
+	RID other_scenario = rs->scenario_create();
+	RID mesh = rs->mesh_create();
+
+	Vector<RID> batched;
+	Vector<RID> single;
+	Vector<Transform3D> transforms;
+	for (int i = 0; i < 6; i++) {
+		for (int j = 0; j < 2; j++) {
+			RID instance = rs->instance_create2(mesh, RID());
+			rs->instance_set_custom_aabb(instance, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+			rs->instance_attach_object_instance_id(instance, ObjectID(uint64_t(j * 100 + i + 1)));
+			(j ? single : batched).push_back(instance);
+		}
+		transforms.push_back(Transform3D(Basis(), Vector3(i * 10, 0, 0)));
+	}
+
+	rs->instances_set_scenario(batched, scenario);
+	rs->instances_set_transforms(batched, transforms);
+	for (int i = 0; i < single.size(); i++) {
+		rs->instance_set_scenario(single[i], other_scenario);
+		rs->instance_set_transform(single[i], transforms[i]);
+	}
+
+	for (int i = 0; i < transforms.size(); i++) {
+		Vector<ObjectID> found = cull_at(scenario, transforms[i].origin);
+		CHECK(found.size() == 1);
+		CHECK(found.has(ObjectID(uint64_t(i + 1))));
+		found = cull_at(other_scenario, transforms[i].origin);
+		CHECK(found.size() == 1);
+		CHECK(found.has(ObjectID(uint64_t(100 + i + 1))));
+	}
+
+	// Moving the batched instances out of the scenario leaves it like the per-instance calls would.
+	rs->instances_set_scenario(batched, RID());
+	for (int i = 0; i < single.size(); i++) {
+		rs->instance_set_scenario(single[i], RID());
+	}
+	for (int i = 0; i < transforms.size(); i++) {
+		CHECK(cull_at(scenario, transforms[i].origin).is_empty());
+		CHECK(cull_at(other_scenario, transforms[i].origin).is_empty());
+	}
+
+	for (int i = 0; i < batched.size(); i++) {
+		rs->free(batched[i]);
+		rs->free(single[i]);
+	}
+	rs->free(mesh);
+	rs->free(scenario);
+	rs->free(other_scenario);
+}
+
+TEST_CASE("[SceneTree][VisualInstance3D] Branches entering and exiting the tree") {
+	SceneTree *tree = SceneTree::get_singleton();
+	RID scenario = tree->get_root()->get_world_3d()->get_scenario();
+	RID mesh = RS::get_singleton()->mesh_create();
+
+	// Entering as a whole branch.
+	Node3D *branch = memnew(Node3D);
+	Node3D *offset = memnew(Node3D);
+	offset->set_position(Vector3(0, 10, 0));
+	branch->add_child(offset);
+	Vector<MeshInstance3D *> batched;
+	for (int i = 0; i < 8; i++) {
+		MeshInstance3D *instance = create_instance(mesh, Vector3(i * 10, 0, 0));
+		(i % 2 ? offset : branch)->add_child(instance);
+		batched.push_back(instance);
+	}
+
+	// Entering one node at a time, for comparison.
+	Node3D *single = memnew(Node3D);
+	single->set_position(Vector3(0, 0, 100));
+	tree->get_root()->add_child(single);
+	Vector<MeshInstance3D *> unbatched;
+	for (int i = 0; i < 8; i++) {
+		MeshInstance3D *instance = create_instance(mesh, Vector3(i * 10, (i % 2) * 10, 0));
+		single->add_child(instance);
+		unbatched.push_back(instance);
+	}
+
+	tree->get_root()->add_child(branch);
+	tree->flush_transform_notifications();
+
+	for (int i = 0; i < 8; i++) {
+		const Vector3 position = batched[i]->get_global_position();
+		CHECK(position.is_equal_approx(unbatched[i]->get_global_position() - Vector3(0, 0, 100)));
+
+		Vector<ObjectID> found = cull_at(scenario, position);
+		CHECK(found.size() == 1);
+		CHECK(found.has(batched[i]->get_instance_id()));
+
+		found = cull_at(scenario, unbatched[i]->get_global_position());
+		CHECK(found.size() == 1);
+		CHECK(found.has(unbatched[i]->get_instance_id()));
+	}
+
+	SUBCASE("Exiting removes every instance from the scenario") {
+		Vector<Vector3> positions;
+		for (int i = 0; i < 8; i++) {
+			positions.push_back(batched[i]->get_global_position());
+			positions.push_back(unbatched[i]->get_global_position());
+		}
+
+		tree->get_root()->remove_child(branch);
+		for (int i = 0; i < 8; i++) {
+			single->remove_child(unbatched[i]);
+			single->add_child(unbatched[i]); // Back in the tree after an exit, but not moved.
+		}
+		tree->flush_transform_notifications();
+
+		for (int i = 0; i < 8; i++) {
+			CHECK(cull_at(scenario, positions[i * 2]).is_empty());
+			Vector<ObjectID> found = cull_at(scenario, positions[i * 2 + 1]);
+			CHECK(found.size() == 1);
+			CHECK(found.has(unbatched[i]->get_instance_id()));
+		}
+	}
+
+	SUBCASE("Moving a branch updates every instance") {
+		branch->set_position(Vector3(0, 0, -100));
+		tree->flush_transform_notifications();
+		for (int i = 0; i < 8; i++) {
+			Vector<ObjectID> found = cull_at(scenario, batched[i]->get_global_position());
+			CHECK(found.size() == 1);
+			CHECK(found.has(batched[i]->get_instance_id()));
+		}
+	}
+
+	memdelete(branch);
+	memdelete(single);
+	RS::get_singleton()->free(mesh);
+}
+
+TEST_CASE("[SceneTree][VisualInstance3D] Server calls made while entering the tree") {
+	SceneTree *tree = SceneTree::get_singleton();
+	RID scenario = tree->get_root()->get_world_3d()->get_scenario();
+	RID other_scenario = RS::get_singleton()->scenario_create();
+	RID mesh = RS::get_singleton()->mesh_create();
+
+	Node3D *branch = memnew(Node3D);
+	_TestReadyScenarioInstance *instance = memnew(_TestReadyScenarioInstance);
+	instance->set_base(mesh);
+	instance->set_custom_aabb(AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+	instance->scenario = other_scenario;
+	branch->add_child(instance);
+
+	tree->get_root()->add_child(branch);
+	tree->flush_transform_notifications();
+
+	// The scenario set when ready is not overwritten by the one set when entering the world.
+	CHECK(cull_at(scenario, Vector3()).is_empty());
+	Vector<ObjectID> found = cull_at(other_scenario, Vector3());
+	CHECK(found.size() == 1);
+	CHECK(found.has(instance->get_instance_id()));
+
+	memdelete(branch);
+	RS::get_singleton()->free(mesh);
+	RS::get_singleton()->free(other_scenario);
+}
+
+TEST_CASE("[SceneTree][VisualInstance3D] Freeing an instance while a batch is pending") {
+	SceneTree *tree = SceneTree::get_singleton();
+	RID scenario = tree->get_root()->get_world_3d()->get_scenario();
+	RID mesh = RS::get_singleton()->mesh_create();
+
+	Node3D *branch = memnew(Node3D);
+	_TestFreeingNode3D *freeing = memnew(_TestFreeingNode3D);
+	branch->add_child(freeing);
+	Vector<MeshInstance3D *> kept;
+	for (int i = 0; i < 4; i++) {
+		MeshInstance3D *instance = create_instance(mesh, Vector3(i * 10, 0, 0));
+		branch->add_child(instance);
+		kept.push_back(instance);
+	}
+	Vector<MeshInstance3D *> victims;
+	for (int i = 0; i < 3; i++) {
+		MeshInstance3D *victim = create_instance(mesh, Vector3(100 + i * 10, 0, 0));
+		branch->add_child(victim);
+		victims.push_back(victim);
+	}
+
+	tree->get_root()->add_child(branch);
+	tree->flush_transform_notifications();
+
+	// Nodes are notified in reverse order of being moved, so the victims' new transforms are
+	// already in the batch when they are freed. Kept instances are batched in between.
+	freeing->set_position(Vector3(1, 0, 0));
+	for (int i = 0; i < victims.size(); i++) {
+		freeing->victims.push_back(victims[i]);
+		kept[i]->set_position(Vector3(i * 10, 0, 50));
+		victims[i]->set_position(Vector3(100 + i * 10, 0, 50));
+	}
+	kept[3]->set_position(Vector3(30, 0, 50));
+	tree->flush_transform_notifications();
+
+	CHECK(freeing->victims.is_empty());
+	CHECK(branch->get_child_count() == 5);
+	for (int i = 0; i < 3; i++) {
+		CHECK(cull_at(scenario, Vector3(100 + i * 10, 0, 0)).is_empty());
+		CHECK(cull_at(scenario, Vector3(100 + i * 10, 0, 50)).is_empty());
+	}
+	for (int i = 0; i < kept.size(); i++) {
+		CHECK(cull_at(scenario, Vector3(i * 10, 0, 0)).is_empty());
+		Vector<ObjectID> found = cull_at(scenario, Vector3(i * 10, 0, 50));
+		CHECK(found.size() == 1);
+		CHECK(found.has(kept[i]->get_instance_id()));
+	}
+
+	memdelete(branch);
+	RS::get_singleton()->free(mesh);
+}
+
+} // namespace TestVisualInstance3D
+
+#endif // TEST_VISUAL_INSTANCE_3D_H